@@ -12,9 +12,12 @@
 #ifndef MARS_EXCLUDE_CONTAINERS
 #include "mars/std/deque.h"
 #include "mars/std/free_list.h"
+#include "mars/std/handle_pool.h"
+#include "mars/std/priority_heap.h"
 #include "mars/std/priority_queue.h"
 #include "mars/std/queue.h"
 #include "mars/std/stack.h"
+#include "mars/std/string_table.h"
 #include "mars/std/unordered_map.h"
 #include "mars/std/unordered_map_str.h"
 #include "mars/std/vector.h"
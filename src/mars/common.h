@@ -25,15 +25,21 @@
 #include "mars/std/debug.h"
 #include "mars/std/deque.h"
 #include "mars/std/free_list.h"
+#include "mars/std/handle_pool.h"
+#include "mars/std/priority_heap.h"
 #include "mars/std/priority_queue.h"
 #include "mars/std/queue.h"
 #include "mars/std/stack.h"
+#include "mars/std/string_table.h"
 #include "mars/std/unordered_map.h"
 #include "mars/std/unordered_map_str.h"
 #include "mars/std/utilities.h"
 #include "mars/std/vector.h"
 #include "mars/std/base64.h"
 #include "mars/std/buffer.h"
+#include "mars/std/thread.h"
+#include "mars/std/block_pool.h"
+#include "mars/std/cipher.h"
 
 // External includes
 #define INI_USE_STACK 0
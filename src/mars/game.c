@@ -63,6 +63,7 @@ void UpdateGame() {
 			// Update inputs
 
 			// Update game state
+			_UpdateResourceManager(MARS_RESOURCES);
 
 			// Update display
 			_UpdateDisplay(MARS_DISPLAY);
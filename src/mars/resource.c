@@ -1,7 +1,50 @@
 #include "mars/resource.h"
 #include "mars/game.h"
 #include "resource.h"
+#include "mars/resource_pack.h"
 #include "external/stb/stb_image.h"
+#include <limits.h>
+#if defined(MARS_OS_LINUX)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#if !defined(MARS_OS_WINDOWS)
+#include <sys/stat.h>
+#endif
+
+// Data block validation states
+#define _RESOURCE_BLOCK_UNCHECKED		0
+#define _RESOURCE_BLOCK_VALID			1
+#define _RESOURCE_BLOCK_CORRUPT			2
+
+// Bytes checked per background validation job, so queued requests are not starved
+#define _RESOURCE_VALIDATION_SLICE		(8 << 20)
+
+// Prefetched blocks closer together than this are read as one run, gaps included
+#define _RESOURCE_PREFETCH_GAP			(64 << 10)
+
+// Merged runs stop growing past this, so decrypted run copies stay small (a larger block gets a run of its own)
+#define _RESOURCE_PREFETCH_RUN			(16 << 20)
+
+// Loose files are addressed by their index in the upper half of an offset, & a position in their block in the lower half
+#define _RESOURCE_LOOSE_OFFSET(i)		(((uint64_t)(i) + 1) << 32)
+#define _RESOURCE_LOOSE_INDEX(o)		((size_t)((o) >> 32) - 1)
+#define _RESOURCE_LOOSE_POSITION(o)		((o) & 0xFFFFFFFFull)
+
+typedef struct {
+	const char* _source;
+	char* _dest;
+	uint64_t* _offsets;				// Offset of each compressed chunk in _source, with the end of the last one appended
+	size_t _chunkSize;
+	size_t _length;
+	bool* _failed;					// Per chunk, so workers never write the same flag
+} _ResourceChunks;
+
+typedef struct {
+	const uint8_t* _buffer;			// Decrypted copy of a range of the resource file
+	uint64_t _offset;				// File offset of the first byte
+	size_t _length;
+} _ResourceRun;
 
 ResourceManager* _CreateResourceManager() {
 	MARS_RETURN_CLEAR;
@@ -14,6 +57,9 @@ ResourceManager* _CreateResourceManager() {
 		goto create_resource_manager_fail;
 	}
 
+	mars_mutex_init(&resourceManager->_resourceRequestLock);
+	mars_cond_init(&resourceManager->_resourceRequestSignal);
+
 	// Create resource list container
 	resourceManager->_resourceLists = unordered_map_create(ResourceList*);
 	if (!resourceManager->_resourceLists) {
@@ -21,6 +67,33 @@ ResourceManager* _CreateResourceManager() {
 		goto create_resource_manager_fail;
 	}
 
+	// Create mount containers
+	resourceManager->_resourceMounts = vector_create(_ResourceMount);
+	resourceManager->_resourceMountIndex = unordered_map_str_create(_ResourceMountEntry);
+	if (!resourceManager->_resourceMounts || !resourceManager->_resourceMountIndex) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource mount containers!");
+		goto create_resource_manager_fail;
+	}
+
+	// Create asynchronous request containers
+	resourceManager->_resourceRequests = unordered_map_create(ResourceRequest*);
+	if (!resourceManager->_resourceRequests) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource request container!");
+		goto create_resource_manager_fail;
+	}
+	resourceManager->_resourceRequestsDone = queue_create(resourceRequest_id);
+	if (!resourceManager->_resourceRequestsDone) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource request queue!");
+		goto create_resource_manager_fail;
+	}
+
+	// Start workers, requests are loaded on the calling thread if this fails
+	resourceManager->_resourceWorkers = thread_pool_create(0);
+	resourceManager->_resourceScratch = block_pool_create(MARS_RESOURCE_SCRATCH_CACHE);
+	if (!resourceManager->_resourceWorkers) {
+		MARS_DEBUG_WARN("Failed to start resource workers, asynchronous requests will block!");
+	}
+
 	return resourceManager;
 create_resource_manager_fail:
 	_DestroyResourceManager(resourceManager);
@@ -29,7 +102,26 @@ create_resource_manager_fail:
 
 void _DestroyResourceManager(ResourceManager *_resourceManager) {
 	if (_resourceManager) {
-		// Free all resource lists
+		// Stop background validation, finish in-flight work, then drop undelivered requests
+		for(unordered_map_it_t* it = unordered_map_it(_resourceManager->_resourceLists); it; it = unordered_map_it_next(it)) {
+			_StopResourceValidation(*(ResourceList**)(it->data));
+		}
+		thread_pool_destroy(_resourceManager->_resourceWorkers);
+		block_pool_destroy(_resourceManager->_resourceScratch);
+		if (_resourceManager->_resourceRequests) {
+			for(unordered_map_it_t* it = unordered_map_it(_resourceManager->_resourceRequests); it; it = unordered_map_it_next(it)) {
+				ResourceRequest* request = *(ResourceRequest**)(it->data);
+				_DestroyResourceRequest(request);
+			}
+			unordered_map_destroy(_resourceManager->_resourceRequests);
+		}
+		queue_destroy(_resourceManager->_resourceRequestsDone);
+		mars_cond_destroy(&_resourceManager->_resourceRequestSignal);
+		mars_mutex_destroy(&_resourceManager->_resourceRequestLock);
+
+		// Free mount containers & all resource lists
+		unordered_map_str_destroy(_resourceManager->_resourceMountIndex);
+		vector_destroy(_resourceManager->_resourceMounts);
 		for(unordered_map_it_t* it = unordered_map_it(_resourceManager->_resourceLists); it; it = unordered_map_it_next(it)) {
 			ResourceList* resourceList = *(ResourceList**)(it->data);
 			_DestroyResourceList(resourceList);
@@ -39,7 +131,17 @@ void _DestroyResourceManager(ResourceManager *_resourceManager) {
 	}
 }
 
-ResourceList* _CreateResourceList(ResourceListDesc _desc) {
+static bool _IsResourceDirectory(const char* _path) {
+#if defined(MARS_OS_WINDOWS)
+	DWORD attributes = GetFileAttributesA(_path);
+	return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+	struct stat info;
+	return stat(_path, &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+}
+
+ResourceList* _CreateResourceList(ResourceListDesc _desc, ResourceManager* _resourceManager) {
 	MARS_RETURN_CLEAR;
 	ResourceList* resourceList = NULL;
 	FILE* fp = NULL;
@@ -57,26 +159,40 @@ ResourceList* _CreateResourceList(ResourceListDesc _desc) {
 		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource list for (%s)!", _desc.resourceFile);
 		goto create_resource_list_fail;
 	}
+	mars_mutex_init(&resourceList->_validationLock);
+	mars_cond_init(&resourceList->_validationSignal);
+	mars_mutex_init(&resourceList->_resourceLooseLock);
+	resourceList->_resourceWatch = -1;
+	resourceList->_validation = _desc.validation;
 	resourceList->_resourceFile = _mars_strdup(_desc.resourceFile);
 	resourceList->_resourcePassword = _mars_strdup(_desc.resourcePassword);
+	resourceList->_cacheStats.budget = _desc.cacheBudget;
+	resourceList->_resourceWorkers = _resourceManager->_resourceWorkers;
+	resourceList->_resourceScratch = _resourceManager->_resourceScratch;
 
 	// Initialize caches
-	resourceList->_cacheText = unordered_map_str_create(TextBuffer);
+	resourceList->_cacheText = unordered_map_str_create(ResourceCacheEntry*);
 	if (!resourceList->_cacheText) {
 		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate text buffer cache for (%s)!", _desc.resourceFile);
 		goto create_resource_list_fail;
 	}
-	resourceList->_cacheData = unordered_map_str_create(DataBuffer);
+	resourceList->_cacheData = unordered_map_str_create(ResourceCacheEntry*);
 	if (!resourceList->_cacheData) {
 		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate data buffer cache for (%s)!", _desc.resourceFile);
 		goto create_resource_list_fail;
 	}
-	resourceList->_cacheTexture2D = unordered_map_str_create(Texture2D);
+	resourceList->_cacheTexture2D = unordered_map_str_create(ResourceCacheEntry*);
 	if (!resourceList->_cacheTexture2D) {
 		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate texture cache for (%s)!", _desc.resourceFile);
 		goto create_resource_list_fail;
 	}
 
+	// Loose resource directories are indexed from the file system instead of a file table
+	if (_IsResourceDirectory(resourceList->_resourceFile)) {
+		if (!_LoadResourceDirectory(resourceList, _desc)) { goto create_resource_list_fail; }
+		return resourceList;
+	}
+
 	// Load resource file
 	fp = fopen(resourceList->_resourceFile, "rb");
 	if (!fp) {
@@ -84,7 +200,7 @@ ResourceList* _CreateResourceList(ResourceListDesc _desc) {
 		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
 		goto create_resource_list_fail;
 	}
-	resourceList->_resourceFileBuffer = buffer_file_read(fp, 0);
+	resourceList->_resourceFileBuffer = buffer_file_map(fp, 0);
 	if (!resourceList->_resourceFileBuffer) {
 		MARS_DEBUG_WARN("Failed to read resource file (%s)!", resourceList->_resourceFile);
 		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
@@ -102,16 +218,55 @@ ResourceList* _CreateResourceList(ResourceListDesc _desc) {
 		goto create_resource_list_fail;
 	}
 
-	// TODO Verify version
+	// Verify version, files written before the version field was introduced read as version 0
+	uint16_t version = buffer_get_u16(resourceList->_resourceFileBuffer, 4);
+	uint16_t flags = buffer_get_u16(resourceList->_resourceFileBuffer, 6);
+	if (version > MARS_RESOURCE_VERSION) {
+		MARS_DEBUG_WARN("Unsupported resource file version (%u) in (%s)!", (unsigned int)version, resourceList->_resourceFile);
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+		goto create_resource_list_fail;
+	}
+	resourceList->_resourceHash = (flags & MARS_RESOURCE_FLAG_HASH64) ? _umap_str_hash : _umap_str_hash_elf;
 
-	// Decrypt contents
+	// Prepare decryption, encrypted contents are decrypted a block at a time as they are read
 	char iv[33] = {'\0'};
 	buffer_get_str(resourceList->_resourceFileBuffer, 16, 32, true, &iv[0]);
+	memcpy(resourceList->_resourceIV, iv, CIPHER_BLOCK_SIZE);
 	if (resourceList->_resourcePassword) {
-		size_t decrypted_len = resourceList->_resourceFileBuffer->_length - 48;
-		struct AES_ctx ctx;
-		AES_init_ctx_iv(&ctx, resourceList->_resourcePassword, &iv[0]);
-		AES_CBC_decrypt_buffer(&ctx, &resourceList->_resourceFileBuffer->_buffer[48], decrypted_len);
+		// Passwords shorter than the key are zero padded
+		uint8_t key[CIPHER_KEY_SIZE] = { 0 };
+		memcpy(key, resourceList->_resourcePassword, umin(strlen(resourceList->_resourcePassword), CIPHER_KEY_SIZE));
+		cipher_init(&resourceList->_resourceCipher, key);
+		if (_desc.decryptOnLoad && resourceList->_resourceFileBuffer->_length > 48) {
+			// Decrypt the whole body up front across the worker pool, the mapping is private so this only touches our copy
+			MARS_DEBUG_LOG("Decrypting (%s) with %s AES", resourceList->_resourceFile, cipher_impl_name(&resourceList->_resourceCipher));
+			cipher_cbc_decrypt_parallel(&resourceList->_resourceCipher, resourceList->_resourceWorkers, resourceList->_resourceIV,
+				&resourceList->_resourceFileBuffer->_buffer[48], resourceList->_resourceFileBuffer->_length - 48);
+		}
+		else {
+			MARS_DEBUG_LOG("Decrypting (%s) on demand with %s AES", resourceList->_resourceFile, cipher_impl_name(&resourceList->_resourceCipher));
+			resourceList->_resourceEncrypted = true;
+		}
+	}
+
+	// Index every resource path once, so lookups never walk the file tables
+	resourceList->_resourceIndex = unordered_map_str_create(uint64_t);
+	if (!resourceList->_resourceIndex) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource index for (%s)!", _desc.resourceFile);
+		goto create_resource_list_fail;
+	}
+	char path[MARS_RESOURCE_MAX_DEPTH * (MARS_RESOURCE_NAME_SIZE + 1) + 1] = { '\0' };
+	uint64_t root = 0;
+	if (!_ReadResourceUInt(resourceList, 48, 8, &root) || !_IndexResourceFileTable(resourceList, root, &path[0], 0, 0)) {
+		MARS_DEBUG_WARN("Invalid file table in resource file (%s)!", resourceList->_resourceFile);
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+		goto create_resource_list_fail;
+	}
+	if (resourceList->_validation == RESOURCE_VALIDATE_ONCE || resourceList->_validation == RESOURCE_VALIDATE_BACKGROUND) {
+		if (!_IndexResourceBlocks(resourceList)) {
+			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate block index for (%s)!", _desc.resourceFile);
+			goto create_resource_list_fail;
+		}
 	}
 
 	return resourceList;
@@ -123,281 +278,2062 @@ create_resource_list_fail:
 
 void _DestroyResourceList(ResourceList* _resourceList) {
 	if (_resourceList) {
+		_StopResourceValidation(_resourceList);
 		MARS_FREE(_resourceList->_resourceFile);
 		MARS_FREE(_resourceList->_resourcePassword);
 
-		// Clear caches
-		for(unordered_map_str_it_t* it = unordered_map_str_it(_resourceList->_cacheText); it; it = unordered_map_str_it_next(it)) {
-			TextBuffer* textBuffer = (TextBuffer*)it->data;
-			_DestroyResourceText(textBuffer);
-		}
-		for(unordered_map_str_it_t* it = unordered_map_str_it(_resourceList->_cacheData); it; it = unordered_map_str_it_next(it)) {
-			DataBuffer* dataBuffer = (DataBuffer*)it->data;
-			_DestroyResourceData(dataBuffer);
-		}
-		for(unordered_map_str_it_t* it = unordered_map_str_it(_resourceList->_cacheTexture2D); it; it = unordered_map_str_it_next(it)) {
-			Texture2D* texture2D = (Texture2D*)it->data;
-			_DestroyResourceTexture2D(texture2D);
+		// Clear caches, every cached resource is on the LRU list
+		ResourceCacheEntry* entry = _resourceList->_cacheHead;
+		while (entry) {
+			ResourceCacheEntry* next = entry->_next;
+			_DestroyResourceValue(entry->_type, &entry->_value);
+			MARS_FREE(entry->_name);
+			MARS_FREE(entry);
+			entry = next;
 		}
 
 		// Clear structures
 		unordered_map_str_destroy(_resourceList->_cacheText);
 		unordered_map_str_destroy(_resourceList->_cacheData);
 		unordered_map_str_destroy(_resourceList->_cacheTexture2D);
+		unordered_map_str_destroy(_resourceList->_resourceIndex);
 		buffer_destroy(_resourceList->_resourceFileBuffer);
+		MARS_FREE(_resourceList->_blockOffsets);
+		MARS_FREE(_resourceList->_blockState);
+
+		// Clear loose files
+#if defined(MARS_OS_LINUX)
+		if (_resourceList->_resourceWatch >= 0) { close(_resourceList->_resourceWatch); }
+#endif
+		for (size_t i = 0; _resourceList->_resourceWatchDirs && i < vector_size(_resourceList->_resourceWatchDirs); ++i) {
+			_ResourceWatchDir* dir = (_ResourceWatchDir*)vector_get(_resourceList->_resourceWatchDirs, i);
+			MARS_FREE(dir->_prefix);
+			MARS_FREE(dir->_path);
+		}
+		for (size_t i = 0; _resourceList->_resourceLooseFiles && i < vector_size(_resourceList->_resourceLooseFiles); ++i) {
+			_ResourceLooseFile* file = (_ResourceLooseFile*)vector_get(_resourceList->_resourceLooseFiles, i);
+			MARS_FREE(file->_path);
+			buffer_destroy(file->_block);
+		}
+		for (size_t i = 0; _resourceList->_resourceLooseRetired && i < vector_size(_resourceList->_resourceLooseRetired); ++i) {
+			buffer_destroy(*(buffer_t**)vector_get(_resourceList->_resourceLooseRetired, i));
+		}
+		vector_destroy(_resourceList->_resourceWatchDirs);
+		vector_destroy(_resourceList->_resourceLooseFiles);
+		vector_destroy(_resourceList->_resourceLooseRetired);
+		mars_mutex_destroy(&_resourceList->_resourceLooseLock);
+		mars_cond_destroy(&_resourceList->_validationSignal);
+		mars_mutex_destroy(&_resourceList->_validationLock);
 		MARS_FREE(_resourceList);
 	}
 }
 
 void _DestroyResourceText(TextBuffer *_text) {
-	if (_text) {
+	if (_text && !_text->_view) {
 		MARS_FREE(_text->data);
 	}
 }
 
 void _DestroyResourceData(DataBuffer *_buffer) {
-	if (_buffer) {
+	if (_buffer && !_buffer->_view) {
 		MARS_FREE(_buffer->data);
 	}
 }
 
 void _DestroyResourceTexture2D(Texture2D *_texture) {
-	if (_texture) {
+	if (_texture && !_texture->_view) {
 		MARS_FREE(_texture->data);
 	}
 }
 
-uint64_t _SeekResourceInBuffer(buffer_t* _resourceBuffer, char* _rsc) {
-	// Load from resource file
-	long long max_len = (long long)strlen(_rsc);
-	size_t rsc_len = 0;
+void _DestroyResourceValue(_ResourceType _type, _ResourceValue* _value) {
+	switch (_type) {
+		case _RESOURCE_TYPE_TEXT: _DestroyResourceText(&_value->text); break;
+		case _RESOURCE_TYPE_DATA: _DestroyResourceData(&_value->data); break;
+		default: _DestroyResourceTexture2D(&_value->texture2D); break;
+	}
+}
+
+bool _GetResourceFileTable(buffer_t* _resourceBuffer, uint64_t _offset, uint32_t* _capacity) {
+	// Verify signature & that the whole table lies inside the buffer
+	if (_offset < 56 || _offset + 12 > _resourceBuffer->_length) { return false; }
+	if (memcmp(&_resourceBuffer->_buffer[_offset], "MRFT", 4) != 0) { return false; }
+	uint32_t capacity = buffer_get_u32(_resourceBuffer, _offset + 8);
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0) { return false; }
+	if ((uint64_t)capacity * (MARS_RESOURCE_ENTRY_SIZE + 1) > _resourceBuffer->_length - _offset - 12) { return false; }
+	*_capacity = capacity;
+	return true;
+}
+
+bool _ReadResourceBytes(ResourceList* _resourceList, uint64_t _offset, size_t _length, void* _dest) {
+	buffer_t* resourceBuffer = _resourceList->_resourceFileBuffer;
+	uint8_t* dest = (uint8_t*)_dest;
+	if (_resourceList->_resourceLooseFiles) {
+		buffer_t* block = _GetResourceLooseBlock(_resourceList, _offset);
+		uint64_t pos = _RESOURCE_LOOSE_POSITION(_offset);
+		if (!block || pos > block->_length || _length > block->_length - pos) { return false; }
+		memcpy(dest, &block->_buffer[pos], _length);
+		return true;
+	}
+	if (_offset > resourceBuffer->_length || _length > resourceBuffer->_length - _offset) { return false; }
+
+	// Everything before the body is stored in the clear
+	if (!_resourceList->_resourceEncrypted || _offset + _length <= 48) {
+		memcpy(dest, &resourceBuffer->_buffer[_offset], _length);
+		return true;
+	}
+	if (_offset < 48) {
+		size_t head = (size_t)(48 - _offset);
+		memcpy(dest, &resourceBuffer->_buffer[_offset], head);
+		dest += head;
+		_length -= head;
+		_offset = 48;
+	}
+
+	// Decrypt only the cipher blocks covering the range, each one needs just the ciphertext block before it
+	const uint8_t* body = &resourceBuffer->_buffer[48];
+	uint64_t pos = _offset - 48;
+	uint64_t end = pos + _length;
+	if (((end + CIPHER_BLOCK_SIZE - 1) / CIPHER_BLOCK_SIZE) * CIPHER_BLOCK_SIZE > resourceBuffer->_length - 48) { return false; }
+	while (pos < end) {
+		uint64_t block = pos / CIPHER_BLOCK_SIZE;
+		size_t skip = (size_t)(pos % CIPHER_BLOCK_SIZE);
+		const uint8_t* iv = (block == 0) ? _resourceList->_resourceIV : &body[(block - 1) * CIPHER_BLOCK_SIZE];
+		size_t n = 0;
+		if (skip == 0 && end - pos >= CIPHER_BLOCK_SIZE) {
+			// Whole blocks decrypt straight into the destination
+			n = (size_t)(((end - pos) / CIPHER_BLOCK_SIZE) * CIPHER_BLOCK_SIZE);
+			memcpy(dest, &body[pos], n);
+			cipher_cbc_decrypt(&_resourceList->_resourceCipher, iv, dest, n);
+		}
+		else {
+			uint8_t scratch[CIPHER_BLOCK_SIZE];
+			memcpy(scratch, &body[block * CIPHER_BLOCK_SIZE], CIPHER_BLOCK_SIZE);
+			cipher_cbc_decrypt(&_resourceList->_resourceCipher, iv, scratch, CIPHER_BLOCK_SIZE);
+			n = (size_t)umin(CIPHER_BLOCK_SIZE - skip, end - pos);
+			memcpy(dest, &scratch[skip], n);
+		}
+		dest += n;
+		pos += n;
+	}
+	return true;
+}
+
+static uint64_t _GetResourceUInt(const uint8_t* _bytes, size_t _size) {
+	uint64_t val = 0;
+	while (_size-- != 0) {
+		val = (val << 8) | _bytes[_size];
+	}
+	return val;
+}
+
+bool _ReadResourceUInt(ResourceList* _resourceList, uint64_t _offset, size_t _size, uint64_t* _val) {
+	uint8_t bytes[8];
+	if (_size > sizeof(bytes) || !_ReadResourceBytes(_resourceList, _offset, _size, bytes)) { return false; }
+	*_val = _GetResourceUInt(bytes, _size);
+	return true;
+}
+
+bool _IndexResourceFileTable(ResourceList* _resourceList, uint64_t _offset, char* _path, size_t _pathLen, unsigned int _depth) {
+	buffer_t* resourceBuffer = _resourceList->_resourceFileBuffer;
+	buffer_t* table = NULL;
+	bool result = false;
+
+	// Verify signature & that the whole table lies inside the buffer
+	char signature[4];
+	uint64_t capacity = 0;
+	if (_depth >= MARS_RESOURCE_MAX_DEPTH || _offset < 56) { goto index_resource_file_table_end; }
+	if (!_ReadResourceBytes(_resourceList, _offset, 4, signature) || memcmp(signature, "MRFT", 4) != 0) { goto index_resource_file_table_end; }
+	if (!_ReadResourceUInt(_resourceList, _offset + 8, 4, &capacity)) { goto index_resource_file_table_end; }
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0) { goto index_resource_file_table_end; }
+	if (capacity * (MARS_RESOURCE_ENTRY_SIZE + 1) > resourceBuffer->_length - _offset - 12) { goto index_resource_file_table_end; }
+
+	// Read the control bytes & entries in one pass
+	size_t table_len = (size_t)capacity * (MARS_RESOURCE_ENTRY_SIZE + 1);
+	table = buffer_create_size(table_len);
+	if (!table) { goto index_resource_file_table_end; }
+	table->_length = table_len;
+	if (!_ReadResourceBytes(_resourceList, _offset + 12, table_len, table->_buffer)) { goto index_resource_file_table_end; }
+
+	// Add every full slot, descending into nested file tables
+	for (uint32_t pos = 0; pos < capacity; ++pos) {
+		if (table->_buffer[pos] & 0x80) { continue; }
+		size_t entry = (size_t)capacity + ((size_t)pos * MARS_RESOURCE_ENTRY_SIZE);
+		size_t name_len = buffer_get_str(table, entry, MARS_RESOURCE_NAME_SIZE, true, &_path[_pathLen]) - 1;
+		if (name_len == 0) { goto index_resource_file_table_end; }
+		uint64_t child_off = buffer_get_u64(table, entry + MARS_RESOURCE_NAME_SIZE);
+		if (_ReadResourceBytes(_resourceList, child_off, 4, signature) && memcmp(signature, "MRFT", 4) == 0) {
+			_path[_pathLen + name_len] = '/';
+			if (!_IndexResourceFileTable(_resourceList, child_off, _path, _pathLen + name_len + 1, _depth + 1)) { goto index_resource_file_table_end; }
+		}
+		else {
+			_path[_pathLen + name_len] = '\0';
+			if (!unordered_map_str_insert(_resourceList->_resourceIndex, _path, &child_off)) { goto index_resource_file_table_end; }
+		}
+	}
+	result = true;
+index_resource_file_table_end:
+	buffer_destroy(table);
+	return result;
+}
+
+uint64_t _FindResourceOffset(ResourceList* _resourceList, char* _rsc, _umap_str_hash_t _hash) {
+	void* data = unordered_map_str_find_hashed(_resourceList->_resourceIndex, _rsc, _hash);
+	if (!data) {
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+		return 0;
+	}
+	return *(uint64_t*)(data);
+}
+
+uint64_t _SeekResourceInBuffer(buffer_t* _resourceBuffer, _umap_str_hash_fn_t _hash, char* _rsc) {
+	// Probe each file table in place, one path component at a time
+	char tok[MARS_RESOURCE_NAME_SIZE + 1] = { '\0' };
 	uint64_t file_table_off = buffer_get_u64(_resourceBuffer, 48);
-	while(max_len > 0) {
+	while (*_rsc != '\0') {
 		// Tokenize resource name
-		rsc_len = strcspn(_rsc, "/");
-		if (rsc_len == 0) {
+		size_t rsc_len = strcspn(_rsc, "/");
+		if (rsc_len == 0 || rsc_len > MARS_RESOURCE_NAME_SIZE) {
 			MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_PARAMETER);
 			goto seek_resource_in_buffer_fail;
 		}
-		char* tok = _mars_strndup(_rsc, rsc_len);
+		memcpy(tok, _rsc, rsc_len);
+		tok[rsc_len] = '\0';
 
 		// Parse file table header
-		char file_table_sig[5] = { '\0' };
-		buffer_get_str(_resourceBuffer, file_table_off, 4, true, &file_table_sig[0]);
-		if (strncmp(file_table_sig, "MRFT", 4) != 0) {
+		uint32_t file_table_capacity = 0;
+		if (!_GetResourceFileTable(_resourceBuffer, file_table_off, &file_table_capacity)) {
 			MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
 			goto seek_resource_in_buffer_fail;
 		}
-		uint32_t file_table_count = buffer_get_u32(_resourceBuffer, file_table_off + 4);
-		uint32_t file_table_capacity = buffer_get_u32(_resourceBuffer, file_table_off + 8);
-
-		// Deserialize file table
-		char* file_table_ctrl_block = MARS_CALLOC(file_table_capacity + 1, sizeof(*file_table_ctrl_block));
-		if (!file_table_ctrl_block) {
-			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate file table control block!");
-			goto seek_resource_in_buffer_fail;
-		}
-		char* file_table_data_block = MARS_CALLOC((file_table_capacity * 40) + 1, sizeof(*file_table_data_block));
-		if (!file_table_data_block) {
-			MARS_FREE(file_table_ctrl_block);
-			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate file table data block!");
-			goto seek_resource_in_buffer_fail;
-		}
-		buffer_get_str(_resourceBuffer, file_table_off + 12, file_table_capacity, false, file_table_ctrl_block);
-		buffer_get_str(_resourceBuffer, file_table_off + 12 + file_table_capacity, file_table_capacity * 40, false, file_table_data_block);
+		uint8_t* file_table_ctrl_block = &_resourceBuffer->_buffer[file_table_off + 12];
+		uint64_t file_table_data_off = file_table_off + 12 + file_table_capacity;
 
 		// Search file table for token
-		_umap_str_hash_t h = _umap_str_hash(tok);
+		_umap_str_hash_t h = _hash(tok);
+		uint8_t h2 = (uint8_t)_umap_str_h2(h);
 		size_t pos = _umap_str_h1(h) & (file_table_capacity - 1);
-		size_t first_pos = pos;
-		do {
+		bool found = false;
+		for (uint32_t probe = 0; probe < file_table_capacity; ++probe) {
 			uint8_t ctrl = file_table_ctrl_block[pos];
-			_umap_str_hash_t h2 = _umap_str_h2(h);
 			if (ctrl == h2) {
-				char* key = file_table_data_block + (pos * 40);
-				if (strncmp(key, tok, max_len) == 0) {
-					file_table_off = buffer_get_u64(_resourceBuffer, file_table_off + 12 + file_table_capacity + (pos * 40) + 32);
+				char* key = (char*)&_resourceBuffer->_buffer[file_table_data_off + (pos * MARS_RESOURCE_ENTRY_SIZE)];
+				if (strncmp(key, tok, MARS_RESOURCE_NAME_SIZE) == 0) {
+					file_table_off = buffer_get_u64(_resourceBuffer, file_table_data_off + (pos * MARS_RESOURCE_ENTRY_SIZE) + MARS_RESOURCE_NAME_SIZE);
+					found = true;
 					break;
 				}
 			}
-			else if (ctrl == _UMAP_STR_EMPTY) {
-				MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
-				MARS_FREE(tok);
-				MARS_FREE(file_table_ctrl_block);
-				MARS_FREE(file_table_data_block);
-				goto seek_resource_in_buffer_fail;
-			}
+			else if (ctrl == _UMAP_STR_EMPTY) { break; }
 			pos = (pos + 1) & (file_table_capacity - 1);
-		} while(pos != first_pos);
+		}
+		if (!found) {
+			MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+			goto seek_resource_in_buffer_fail;
+		}
 
 		// Advance pointer
-		_rsc += (rsc_len + 1);
-		max_len -= (long long)(rsc_len + 1);
-		MARS_FREE(tok);
-		MARS_FREE(file_table_ctrl_block);
-		MARS_FREE(file_table_data_block);
+		_rsc += rsc_len;
+		if (*_rsc == '/') { _rsc++; }
 	}
 
 	return file_table_off;
 seek_resource_in_buffer_fail:
 	return 0;
 }
-char* _GetResourceDataFromBuffer(buffer_t* _resourceBuffer, uint64_t _offset, char* _type, size_t* _len) {
+
+static void _DecompressResourceChunk(void* _arg, size_t _chunk) {
+	_ResourceChunks* chunks = (_ResourceChunks*)_arg;
+	size_t out_offset = _chunk * chunks->_chunkSize;
+	size_t out_size = (size_t)umin(chunks->_chunkSize, chunks->_length - out_offset);
+	size_t in_size = (size_t)(chunks->_offsets[_chunk + 1] - chunks->_offsets[_chunk]);
+	const char* in = &chunks->_source[chunks->_offsets[_chunk]];
+	if (in_size == out_size) {
+		memcpy(&chunks->_dest[out_offset], in, out_size);
+	}
+	else if (LZ4_decompress_safe(in, &chunks->_dest[out_offset], (int)in_size, (int)out_size) != (int)out_size) {
+		chunks->_failed[_chunk] = true;
+	}
+}
+
+bool _DecompressResourceChunks(const char* _source, size_t _sourceLen, char* _dest, size_t _destLen, thread_pool_t* _workers) {
+	bool result = false;
+	_ResourceChunks chunks = { 0 };
+
+	// Verify the chunk table covers the output exactly & the chunks fill the rest of the block
+	const uint8_t* table = (const uint8_t*)_source;
+	if (_sourceLen < 8) { return false; }
+	uint32_t chunk_count = (uint32_t)_GetResourceUInt(&table[0], 4);
+	uint32_t chunk_size = (uint32_t)_GetResourceUInt(&table[4], 4);
+	if (chunk_count == 0 || chunk_size == 0 || chunk_size > INT_MAX) { return false; }
+	if (((uint64_t)_destLen + chunk_size - 1) / chunk_size != chunk_count) { return false; }
+	uint64_t table_size = 8 + (uint64_t)chunk_count * 4;
+	if (table_size > _sourceLen) { return false; }
+	chunks._offsets = MARS_MALLOC((chunk_count + 1) * sizeof(*chunks._offsets));
+	chunks._failed = MARS_CALLOC(chunk_count, sizeof(*chunks._failed));
+	if (!chunks._offsets || !chunks._failed) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource chunk table!");
+		goto decompress_resource_chunks_end;
+	}
+	chunks._offsets[0] = table_size;
+	for (uint32_t i = 0; i < chunk_count; ++i) {
+		chunks._offsets[i + 1] = chunks._offsets[i] + _GetResourceUInt(&table[8 + (size_t)i * 4], 4);
+	}
+	if (chunks._offsets[chunk_count] != _sourceLen) { goto decompress_resource_chunks_end; }
+
+	// Every chunk writes its own slice of the output
+	chunks._source = _source;
+	chunks._dest = _dest;
+	chunks._chunkSize = chunk_size;
+	chunks._length = _destLen;
+	thread_pool_parallel_for(_workers, chunk_count, _DecompressResourceChunk, &chunks);
+	result = true;
+	for (uint32_t i = 0; i < chunk_count; ++i) {
+		if (chunks._failed[i]) { result = false; }
+	}
+decompress_resource_chunks_end:
+	MARS_FREE(chunks._offsets);
+	MARS_FREE(chunks._failed);
+	return result;
+}
+
+char* _GetResourceDataFromBuffer(const uint8_t* _buffer, size_t _length, uint64_t _offset, char* _type, bool _validate, bool* _view, char* _dest, size_t* _len, thread_pool_t* _workers) {
 	char* data_block = NULL;
+	size_t capacity = (_dest) ? *_len : 0;
+	bool view = (_view && *_view);
+	if (_view) { *_view = false; }
+	*_len = 0;
 
 	// Read resource header
-	char data_block_sig[5] = {'\0'};
-	buffer_get_str(_resourceBuffer, _offset, 4, true, &data_block_sig[0]);
-	if (strncmp(data_block_sig, _type, 4) != 0) {
+	if (_offset > _length || _length - _offset < 80 || memcmp(&_buffer[_offset], _type, 4) != 0) {
 		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
 		goto get_resource_data_from_buffer_fail;
 	}
-	uint32_t data_block_crc = buffer_get_u32(_resourceBuffer, _offset + 4);
-	uint64_t data_block_next = buffer_get_u64(_resourceBuffer, _offset + 8);
-	uint64_t data_block_prev = buffer_get_u64(_resourceBuffer, _offset + 16);
-	uint64_t data_block_compressed_size = buffer_get_u64(_resourceBuffer, _offset + 24);
-	uint64_t data_block_uncompressed_size = buffer_get_u64(_resourceBuffer, _offset + 32);
+	uint32_t data_block_crc = (uint32_t)_GetResourceUInt(&_buffer[_offset + 4], 4);
+	uint64_t data_block_compressed_size = _GetResourceUInt(&_buffer[_offset + 24], 8);
+	uint64_t data_block_uncompressed_size = _GetResourceUInt(&_buffer[_offset + 32], 8);
+	uint32_t data_block_flags = (uint32_t)_GetResourceUInt(&_buffer[_offset + 40], 4);
 	_offset += 80; // Advance past data block header
-	data_block = MARS_CALLOC(data_block_compressed_size + 1, sizeof(*data_block));
-	if (!data_block) {
-		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource data buffer!");
+	if (data_block_compressed_size > _length - _offset || data_block_uncompressed_size >= SIZE_MAX) {
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
 		goto get_resource_data_from_buffer_fail;
 	}
-	buffer_get_str(_resourceBuffer, _offset, data_block_compressed_size, false, data_block);
+	const char* source = (const char*)&_buffer[_offset];
+	bool chunked = (data_block_flags & MARS_RESOURCE_BLOCK_FLAG_CHUNKED) != 0;
+	bool stored = !chunked && data_block_compressed_size == data_block_uncompressed_size;
+
+	// Reference stored blocks in place
+	if (view && stored) {
+		if (_validate && CRC32Calculate(source, data_block_uncompressed_size, 0) != data_block_crc) {
+			MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+			goto get_resource_data_from_buffer_fail;
+		}
+		*_view = true;
+		*_len = (size_t)data_block_uncompressed_size;
+		return (char*)source;
+	}
 
-	// Decompress data
-	if (data_block_compressed_size != data_block_uncompressed_size) {
-		char* decompressed_data_block = MARS_CALLOC(data_block_uncompressed_size, sizeof(*decompressed_data_block));
-		if (!decompressed_data_block) {
-			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate decompressed resource data buffer!");
+	// Decompress straight out of the file buffer, into the caller's memory if there is any
+	if (_dest) {
+		if (data_block_uncompressed_size > capacity) {
+			MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_PARAMETER);
+			*_len = (size_t)data_block_uncompressed_size;
+			return NULL;
+		}
+		data_block = _dest;
+	}
+	else {
+		data_block = MARS_MALLOC((size_t)data_block_uncompressed_size + 1);
+		if (!data_block) {
+			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource data buffer!");
 			goto get_resource_data_from_buffer_fail;
 		}
-		if (LZ4_decompress_safe(data_block, decompressed_data_block, (int)data_block_compressed_size, (int)data_block_uncompressed_size) != data_block_uncompressed_size) {
+		data_block[data_block_uncompressed_size] = '\0';
+	}
+	if (chunked) {
+		if (!_DecompressResourceChunks(source, (size_t)data_block_compressed_size, data_block, (size_t)data_block_uncompressed_size, _workers)) {
 			MARS_RETURN_SET(MARS_RETURN_CODE_RESOURCE_FAILURE);
-			MARS_FREE(decompressed_data_block);
 			goto get_resource_data_from_buffer_fail;
 		}
-		MARS_FREE(data_block);
-		data_block = decompressed_data_block;
+	}
+	else if (stored) {
+		memcpy(data_block, source, (size_t)data_block_uncompressed_size);
+	}
+	else if (data_block_uncompressed_size > INT_MAX || data_block_compressed_size > INT_MAX ||
+		LZ4_decompress_safe(source, data_block, (int)data_block_compressed_size, (int)data_block_uncompressed_size) != (int)data_block_uncompressed_size) {
+		MARS_RETURN_SET(MARS_RETURN_CODE_RESOURCE_FAILURE);
+		goto get_resource_data_from_buffer_fail;
 	}
 
 	// Validate data
-	if (CRC32Calculate(data_block, data_block_uncompressed_size, 0) != data_block_crc) {
+	if (_validate && CRC32Calculate(data_block, data_block_uncompressed_size, 0) != data_block_crc) {
 		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
 		goto get_resource_data_from_buffer_fail;
 	}
 
-	*_len = data_block_uncompressed_size;
+	*_len = (size_t)data_block_uncompressed_size;
 	return data_block;
 get_resource_data_from_buffer_fail:
-	MARS_FREE(data_block);
-	*_len = 0;
+	if (data_block != _dest) { MARS_FREE(data_block); }
 	return NULL;
 }
 
-resourceList_id LoadResourceFile(ResourceListDesc _desc) {
-	MARS_RETURN_CLEAR;
+// Recency stamp shared by every list, so the global budget can compare entries across lists
+static uint64_t _resourceCacheTick = 0;
 
-	// Load resource file
-	MARS_DEBUG_LOG("Loading resource file (%s)", _desc.resourceFile);
-	ResourceList* resourceList = _CreateResourceList(_desc);
-	if (!resourceList) {
-		MARS_DEBUG_WARN("Failed to load resource file!");
-		return ID_NULL;
+static unordered_map_str_t** _GetResourceCache(ResourceList* _resourceList, _ResourceType _type) {
+	switch (_type) {
+		case _RESOURCE_TYPE_TEXT: return &_resourceList->_cacheText;
+		case _RESOURCE_TYPE_DATA: return &_resourceList->_cacheData;
+		default: return &_resourceList->_cacheTexture2D;
 	}
+}
 
-	// Add to global list
-	MARS_DEBUG_LOG("Adding to global resource list", _desc.resourceFile);
-	resourceList_id id = _mars_id_generate();
-	void* insertedResourceList = unordered_map_insert(MARS_RESOURCES->_resourceLists, id, &resourceList);
-	MARS_ASSERT(*(ResourceList**)insertedResourceList == resourceList);
-	return id;
+static size_t _GetResourceValueBytes(_ResourceType _type, _ResourceValue* _value) {
+	// Views live in the resource file, so only owned copies count against a budget
+	switch (_type) {
+		case _RESOURCE_TYPE_TEXT: return _value->text._view ? 0 : _value->text.size;
+		case _RESOURCE_TYPE_DATA: return _value->data._view ? 0 : _value->data.size;
+		default: return _value->texture2D._view ? 0 : _value->texture2D.size;
+	}
 }
 
-void UnloadResourceFile(resourceList_id _id) {
-	if (_id != ID_NULL) {
-		void* data = unordered_map_find(MARS_RESOURCES->_resourceLists, _id);
-		if (data) {
-			ResourceList* resourceList = *(ResourceList**)(data);
-			_DestroyResourceList(resourceList);
-			unordered_map_delete(MARS_RESOURCES->_resourceLists, _id);
-		}
+static void _LinkResourceCacheEntry(ResourceList* _resourceList, ResourceCacheEntry* _entry) {
+	_entry->_prev = NULL;
+	_entry->_next = _resourceList->_cacheHead;
+	if (_resourceList->_cacheHead) { _resourceList->_cacheHead->_prev = _entry; }
+	else { _resourceList->_cacheTail = _entry; }
+	_resourceList->_cacheHead = _entry;
+	_entry->_tick = ++_resourceCacheTick;
+}
+
+static void _UnlinkResourceCacheEntry(ResourceList* _resourceList, ResourceCacheEntry* _entry) {
+	if (_entry->_prev) { _entry->_prev->_next = _entry->_next; }
+	else { _resourceList->_cacheHead = _entry->_next; }
+	if (_entry->_next) { _entry->_next->_prev = _entry->_prev; }
+	else { _resourceList->_cacheTail = _entry->_prev; }
+	_entry->_prev = NULL;
+	_entry->_next = NULL;
+}
+
+static ResourceCacheEntry* _FindResourceCache(ResourceList* _resourceList, _ResourceType _type, char* _name, _umap_str_hash_t _hash, bool _record) {
+	void* data = unordered_map_str_find_hashed(*_GetResourceCache(_resourceList, _type), _name, _hash);
+	ResourceCacheEntry* entry = data ? *(ResourceCacheEntry**)(data) : NULL;
+	if (entry) {
+		// Move to the front of the LRU list
+		_UnlinkResourceCacheEntry(_resourceList, entry);
+		_LinkResourceCacheEntry(_resourceList, entry);
 	}
+	if (_record) {
+		if (entry) { _resourceList->_cacheStats.hits++; }
+		else { _resourceList->_cacheStats.misses++; }
+	}
+	return entry;
 }
 
-TextBuffer* GetResourceText(resourceList_id _resourceList, char* _textName) {
+static void _EvictResourceCacheEntry(ResourceManager* _resourceManager, ResourceCacheEntry* _entry) {
+	ResourceList* resourceList = _entry->_resourceList;
+	if (!_entry->_stale) { unordered_map_str_delete_hashed(*_GetResourceCache(resourceList, _entry->_type), _entry->_name, _entry->_hash); }
+	_UnlinkResourceCacheEntry(resourceList, _entry);
+	resourceList->_cacheStats.residentBytes -= _entry->_bytes;
+	resourceList->_cacheStats.evictions++;
+	_resourceManager->_cacheBytes -= _entry->_bytes;
+	_DestroyResourceValue(_entry->_type, &_entry->_value);
+	MARS_FREE(_entry->_name);
+	MARS_FREE(_entry);
+}
+
+static ResourceCacheEntry* _InsertResourceCache(ResourceList* _resourceList, _ResourceType _type, char* _name, _umap_str_hash_t _hash, _ResourceValue* _value) {
+	// Takes ownership of the value only if the insertion succeeds
+	ResourceCacheEntry* entry = MARS_CALLOC(1, sizeof(*entry));
+	if (!entry) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource cache entry!");
+		goto insert_resource_cache_fail;
+	}
+	entry->_name = _mars_strdup(_name);
+	if (!entry->_name) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource cache entry name!");
+		goto insert_resource_cache_fail;
+	}
+	if (!unordered_map_str_insert_hashed(*_GetResourceCache(_resourceList, _type), _name, _hash, &entry)) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to cache resource (%s)!", _name);
+		goto insert_resource_cache_fail;
+	}
+	entry->_value = *_value;
+	entry->_resourceList = _resourceList;
+	entry->_hash = _hash;
+	entry->_type = _type;
+	entry->_bytes = _GetResourceValueBytes(_type, _value);
+	_LinkResourceCacheEntry(_resourceList, entry);
+	_resourceList->_cacheStats.residentBytes += entry->_bytes;
+	MARS_RESOURCES->_cacheBytes += entry->_bytes;
+
+	// Make room, never evicting the resource being returned
+	_TrimResourceCaches(MARS_RESOURCES, _resourceList, entry);
+	return entry;
+insert_resource_cache_fail:
+	if (entry) {
+		MARS_FREE(entry->_name);
+		MARS_FREE(entry);
+	}
 	return NULL;
 }
 
-DataBuffer* GetResourceData(resourceList_id _resourceList, char* _dataName) {
+static void _PinResourceCacheEntry(ResourceCacheEntry* _entry) {
+	if (_entry->_refs++ == 0) {
+		_entry->_resourceList->_cacheStats.pinnedBytes += _entry->_bytes;
+	}
+}
+
+static void _UnpinResourceCacheEntry(ResourceCacheEntry* _entry) {
+	if (--_entry->_refs == 0) {
+		_entry->_resourceList->_cacheStats.pinnedBytes -= _entry->_bytes;
+	}
+}
+
+static ResourceCacheEntry* _GetResourceCacheVictim(ResourceList* _resourceList, ResourceCacheEntry* _keep) {
+	// Oldest entry that is unpinned & actually frees memory
+	for (ResourceCacheEntry* entry = _resourceList->_cacheTail; entry; entry = entry->_prev) {
+		if (entry->_refs == 0 && entry->_bytes > 0 && entry != _keep) { return entry; }
+	}
 	return NULL;
 }
 
-Texture2D* GetResourceTexture2D(resourceList_id _resourceList, char* _textureName) {
-	MARS_RETURN_CLEAR;
-	char* data_block = NULL;
+void _TrimResourceCaches(ResourceManager* _resourceManager, ResourceList* _resourceList, ResourceCacheEntry* _keep) {
+	// Fit the list in its own budget first
+	if (_resourceList) {
+		ResourceCacheStats* stats = &_resourceList->_cacheStats;
+		while (stats->budget > 0 && stats->residentBytes > stats->budget) {
+			ResourceCacheEntry* victim = _GetResourceCacheVictim(_resourceList, _keep);
+			if (!victim) { break; }
+			_EvictResourceCacheEntry(_resourceManager, victim);
+		}
+	}
 
-	// Error check
-	if (_resourceList == ID_NULL) { 
-		MARS_DEBUG_WARN("NULL resource list ID!");
-		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
-		goto get_resource_texture_2d_fail;
+	// Then the combined budget, evicting the least recently used entry across all lists
+	while (_resourceManager->_cacheBudget > 0 && _resourceManager->_cacheBytes > _resourceManager->_cacheBudget) {
+		ResourceCacheEntry* victim = NULL;
+		for(unordered_map_it_t* it = unordered_map_it(_resourceManager->_resourceLists); it; it = unordered_map_it_next(it)) {
+			ResourceCacheEntry* candidate = _GetResourceCacheVictim(*(ResourceList**)(it->data), _keep);
+			if (candidate && (!victim || candidate->_tick < victim->_tick)) { victim = candidate; }
+		}
+		if (!victim) { break; }
+		_EvictResourceCacheEntry(_resourceManager, victim);
 	}
-	if (_textureName == NULL) {
-		MARS_DEBUG_WARN("NULL texture name!");
-		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_REFERENCE);
-		goto get_resource_texture_2d_fail;
+}
+
+static int _CompareResourceBlockOffset(const void* _a, const void* _b) {
+	uint64_t a = *(const uint64_t*)_a;
+	uint64_t b = *(const uint64_t*)_b;
+	return (a > b) - (a < b);
+}
+
+bool _IndexResourceBlocks(ResourceList* _resourceList) {
+	// Collect the distinct data block offsets in file order, all unchecked
+	size_t count = unordered_map_str_size(_resourceList->_resourceIndex);
+	if (count == 0) { return true; }
+	_resourceList->_blockOffsets = MARS_MALLOC(count * sizeof(*_resourceList->_blockOffsets));
+	_resourceList->_blockState = MARS_CALLOC(count, sizeof(*_resourceList->_blockState));
+	if (!_resourceList->_blockOffsets || !_resourceList->_blockState) { return false; }
+	size_t i = 0;
+	for(unordered_map_str_it_t* it = unordered_map_str_it(_resourceList->_resourceIndex); it; it = unordered_map_str_it_next(it)) {
+		_resourceList->_blockOffsets[i++] = *(uint64_t*)(it->data);
 	}
+	qsort(_resourceList->_blockOffsets, count, sizeof(*_resourceList->_blockOffsets), _CompareResourceBlockOffset);
+	size_t unique = 1;
+	for (i = 1; i < count; ++i) {
+		if (_resourceList->_blockOffsets[i] != _resourceList->_blockOffsets[unique - 1]) {
+			_resourceList->_blockOffsets[unique++] = _resourceList->_blockOffsets[i];
+		}
+	}
+	_resourceList->_blockCount = unique;
+	return true;
+}
 
-	// Get resource list
-	void* data = unordered_map_find(MARS_RESOURCES->_resourceLists, _resourceList);
-	if (!data) {
-		MARS_DEBUG_WARN("Invalid resource list ID (%d)!", (int)_resourceList);
-		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_PARAMETER);
-		goto get_resource_texture_2d_fail;
+char* _ReadResourceBlock(ResourceList* _resourceList, uint64_t _offset, char* _type, bool _validate, bool* _view, char* _dest, size_t* _len) {
+	buffer_t* resourceBuffer = _resourceList->_resourceFileBuffer;
+	if (_resourceList->_resourceLooseFiles) {
+		// Loose blocks live until the list is unloaded, even once replaced, so they can be referenced in place too
+		buffer_t* block = _GetResourceLooseBlock(_resourceList, _offset);
+		if (!block) {
+			MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+			if (_view) { *_view = false; }
+			*_len = 0;
+			return NULL;
+		}
+		return _GetResourceDataFromBuffer(block->_buffer, block->_length, _RESOURCE_LOOSE_POSITION(_offset), _type, _validate, _view, _dest, _len, _resourceList->_resourceWorkers);
+	}
+	if (!_resourceList->_resourceEncrypted) {
+		return _GetResourceDataFromBuffer(resourceBuffer->_buffer, resourceBuffer->_length, _offset, _type, _validate, _view, _dest, _len, _resourceList->_resourceWorkers);
 	}
-	ResourceList* resourceList = *(ResourceList**)(data);
 
-	// Check cache
-	data = unordered_map_str_find(resourceList->_cacheTexture2D, _textureName);
-	if (data) { return *(Texture2D**)(data); }
+	// Decrypt just this block into pooled scratch memory, the result is always a copy
+	char* data = NULL;
+	uint8_t* block = NULL;
+	uint64_t compressed_size = 0;
+	if (_view) { *_view = false; }
+	if (!_ReadResourceUInt(_resourceList, _offset + 24, 8, &compressed_size) || compressed_size > resourceBuffer->_length) {
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+		goto read_resource_block_fail;
+	}
+	size_t block_len = (size_t)compressed_size + 80;
+	block = block_pool_alloc(_resourceList->_resourceScratch, block_len);
+	if (!block) { goto read_resource_block_fail; }
+	if (!_ReadResourceBytes(_resourceList, _offset, block_len, block)) {
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+		goto read_resource_block_fail;
+	}
+	data = _GetResourceDataFromBuffer(block, block_len, 0, _type, _validate, NULL, _dest, _len, _resourceList->_resourceWorkers);
+	block_pool_free(_resourceList->_resourceScratch, block);
+	return data;
+read_resource_block_fail:
+	block_pool_free(_resourceList->_resourceScratch, block);
+	*_len = 0;
+	return NULL;
+}
 
-	// Get offset of data in buffer
-	uint64_t resourceOff = _SeekResourceInBuffer(resourceList->_resourceFileBuffer, _textureName);
-	if (resourceOff == 0) {
-		if (MARS_RETURN_CODE == MARS_RETURN_CODE_INVALID_ID) {
-			MARS_DEBUG_WARN("Failed to find texture (%s)!", _textureName);
+char* _AcquireResourceScratch(ResourceList* _resourceList, uint64_t _offset, size_t* _len) {
+	uint64_t size = 0;
+	*_len = 0;
+	// LZ4 expands by at most 255x, so anything larger is a corrupt header
+	if (!_ReadResourceUInt(_resourceList, _offset + 32, 8, &size)) { return NULL; }
+	if (_resourceList->_resourceFileBuffer && size > (uint64_t)_resourceList->_resourceFileBuffer->_length * 255) { return NULL; }
+	char* scratch = block_pool_alloc(_resourceList->_resourceScratch, (size_t)size);
+	if (scratch) { *_len = (size_t)size; }
+	return scratch;
+}
+
+static uint8_t* _GetResourceBlockState(ResourceList* _resourceList, uint64_t _offset) {
+	size_t lo = 0, hi = _resourceList->_blockCount;
+	while (lo < hi) {
+		size_t mid = lo + ((hi - lo) / 2);
+		if (_resourceList->_blockOffsets[mid] < _offset) { lo = mid + 1; }
+		else { hi = mid; }
+	}
+	return (lo < _resourceList->_blockCount && _resourceList->_blockOffsets[lo] == _offset) ? &_resourceList->_blockState[lo] : NULL;
+}
+
+static char* _GetResourceBlockInRun(ResourceList* _resourceList, const _ResourceRun* _run, uint64_t _offset, char* _type, bool* _view, char* _dest, size_t* _len) {
+	// Apply the list's validation policy, checking each block at most once when it is tracked
+	uint8_t* state = NULL;
+	bool validate = (_resourceList->_validation != RESOURCE_VALIDATE_NEVER);
+	if (_resourceList->_blockState) {
+		state = _GetResourceBlockState(_resourceList, _offset);
+		mars_mutex_lock(&_resourceList->_validationLock);
+		uint8_t blockState = state ? *state : _RESOURCE_BLOCK_UNCHECKED;
+		mars_mutex_unlock(&_resourceList->_validationLock);
+		if (blockState == _RESOURCE_BLOCK_CORRUPT) {
+			MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+			if (_view) { *_view = false; }
+			*_len = 0;
+			return NULL;
 		}
-		else if (MARS_RETURN_CODE == MARS_RETURN_CODE_INVALID_PARAMETER) {
-			MARS_DEBUG_WARN("Invalid texture name (%s)!", _textureName);
+		validate = (blockState != _RESOURCE_BLOCK_VALID);
+	}
+	char* block = NULL;
+	if (_run) {
+		// Runs are temporary, so the result is always a copy
+		if (_view) { *_view = false; }
+		block = _GetResourceDataFromBuffer(_run->_buffer, _run->_length, _offset - _run->_offset, _type, validate, NULL, _dest, _len, _resourceList->_resourceWorkers);
+	}
+	else {
+		block = _ReadResourceBlock(_resourceList, _offset, _type, validate, _view, _dest, _len);
+	}
+	if (block && validate && state) {
+		mars_mutex_lock(&_resourceList->_validationLock);
+		*state = _RESOURCE_BLOCK_VALID;
+		mars_mutex_unlock(&_resourceList->_validationLock);
+	}
+	return block;
+}
+
+char* _GetResourceBlock(ResourceList* _resourceList, uint64_t _offset, char* _type, bool* _view, char* _dest, size_t* _len) {
+	return _GetResourceBlockInRun(_resourceList, NULL, _offset, _type, _view, _dest, _len);
+}
+
+static bool _ReadResourceRunBytes(ResourceList* _resourceList, const _ResourceRun* _run, uint64_t _offset, size_t _length, void* _dest) {
+	// Bytes inside the run were already read & decrypted
+	if (_run && _offset >= _run->_offset && _offset - _run->_offset <= _run->_length && _length <= _run->_length - (_offset - _run->_offset)) {
+		memcpy(_dest, &_run->_buffer[_offset - _run->_offset], _length);
+		return true;
+	}
+	return _ReadResourceBytes(_resourceList, _offset, _length, _dest);
+}
+
+static void _ValidateResourceBlocks(void* _arg) {
+	// Runs on a worker thread, checking one slice of blocks before requeueing itself behind other work
+	ResourceList* resourceList = (ResourceList*)_arg;
+	size_t checked = 0;
+	mars_mutex_lock(&resourceList->_validationLock);
+	while (!resourceList->_validationCancel && resourceList->_validationNext < resourceList->_blockCount && checked < _RESOURCE_VALIDATION_SLICE) {
+		size_t i = resourceList->_validationNext++;
+		if (resourceList->_blockState[i] != _RESOURCE_BLOCK_UNCHECKED) { continue; }
+		mars_mutex_unlock(&resourceList->_validationLock);
+
+		// Check the block against its own signature
+		uint64_t offset = resourceList->_blockOffsets[i];
+		char signature[5] = { '\0' };
+		_ReadResourceBytes(resourceList, offset, 4, signature);
+		bool view = true;
+		size_t len = 0;
+		char* scratch = _AcquireResourceScratch(resourceList, offset, &len);
+		char* block = _ReadResourceBlock(resourceList, offset, signature, true, &view, scratch, &len);
+		if (block && !view && block != scratch) { MARS_FREE(block); }
+		block_pool_free(resourceList->_resourceScratch, scratch);
+		checked += 80 + len;
+
+		mars_mutex_lock(&resourceList->_validationLock);
+		if (resourceList->_blockState[i] == _RESOURCE_BLOCK_UNCHECKED) {
+			resourceList->_blockState[i] = block ? _RESOURCE_BLOCK_VALID : _RESOURCE_BLOCK_CORRUPT;
 		}
-		else if (MARS_RETURN_CODE == MARS_RETURN_CODE_FILESYSTEM_FAILURE) {
-			MARS_DEBUG_WARN("Invalid resource file (%s)!", resourceList->_resourceFile);
+		if (!block) {
+			MARS_DEBUG_WARN("Corrupt data block at offset (%llu) in (%s)!", (unsigned long long)offset, resourceList->_resourceFile);
 		}
-		goto get_resource_texture_2d_fail;
 	}
+	bool done = resourceList->_validationCancel || resourceList->_validationNext >= resourceList->_blockCount;
+	mars_mutex_unlock(&resourceList->_validationLock);
+	if (!done && thread_pool_submit(resourceList->_validationWorkers, _ValidateResourceBlocks, resourceList)) { return; }
 
-	// Get data from buffer
-	size_t data_block_len = 0;
-	data_block = _GetResourceDataFromBuffer(resourceList->_resourceFileBuffer, resourceOff, "MIMG", &data_block_len);
-	if (!data_block) {
-		if (MARS_RETURN_CODE == MARS_RETURN_CODE_RESOURCE_FAILURE) {
-			MARS_DEBUG_WARN("Failed to decompress texture data (%s)!", _textureName);
+	// Finished, cancelled, or the pool is shutting down (remaining blocks are checked on first read)
+	mars_mutex_lock(&resourceList->_validationLock);
+	resourceList->_validationRunning = false;
+	mars_cond_broadcast(&resourceList->_validationSignal);
+	mars_mutex_unlock(&resourceList->_validationLock);
+}
+
+static unsigned int _GetTextureFormatChannels(TextureFormat _format) {
+	switch (_format) {
+		case TEXTURE_FORMAT_R8:
+		case TEXTURE_FORMAT_BC4: return 1;
+		case TEXTURE_FORMAT_RG8:
+		case TEXTURE_FORMAT_BC5: return 2;
+		case TEXTURE_FORMAT_RGB8:
+		case TEXTURE_FORMAT_BC6H: return 3;
+		case TEXTURE_FORMAT_UNKNOWN: return 0;
+		default: return 4;
+	}
+}
+
+static bool _LoadResourceTexture2DInRun(ResourceList* _resourceList, const _ResourceRun* _run, uint64_t _offset, Texture2D* _texture) {
+	char signature[4];
+	*_texture = (Texture2D){ 0 };
+	if (!_ReadResourceRunBytes(_resourceList, _run, _offset, 4, signature)) {
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+		return false;
+	}
+
+	// Texture blocks are used as stored, referencing them in place when they are not compressed
+	if (memcmp(signature, "MTEX", 4) == 0) {
+		uint8_t header[16];
+		if (!_ReadResourceRunBytes(_resourceList, _run, _offset + 48, sizeof(header), header)) {
+			MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+			return false;
 		}
-		else if (MARS_RETURN_CODE == MARS_RETURN_CODE_FILESYSTEM_FAILURE) {
-			MARS_DEBUG_WARN("Failed to validate texture data (%s)!", _textureName);
+		uint64_t format = _GetResourceUInt(&header[0], 4);
+		uint64_t width = _GetResourceUInt(&header[4], 4);
+		uint64_t height = _GetResourceUInt(&header[8], 4);
+		uint64_t levels = _GetResourceUInt(&header[12], 4);
+		size_t size = 0;
+		bool valid = (width > 0 && height > 0 && levels > 0 && levels <= 32 && (umax(width, height) >> (levels - 1)) > 0);
+		for (unsigned int level = 0; valid && level < levels; ++level) {
+			size_t level_size = GetTextureLevelSize((TextureFormat)format, (unsigned int)umax(width >> level, 1), (unsigned int)umax(height >> level, 1));
+			valid = (level_size > 0);
+			size += level_size;
 		}
-		goto get_resource_texture_2d_fail;
+		if (!valid) {
+			MARS_RETURN_SET(MARS_RETURN_CODE_RESOURCE_FAILURE);
+			return false;
+		}
+		bool view = !_resourceList->_resourceEncrypted;
+		size_t len = 0;
+		char* block = _GetResourceBlockInRun(_resourceList, _run, _offset, "MTEX", &view, NULL, &len);
+		if (!block) { return false; }
+		*_texture = (Texture2D){ .data = (uint8_t*)block, .width = (unsigned int)width, .height = (unsigned int)height,
+			.channels = _GetTextureFormatChannels((TextureFormat)format), .format = (TextureFormat)format, .mipLevels = (unsigned int)levels,
+			.size = len, ._view = view };
+		if (len != size) {
+			MARS_RETURN_SET(MARS_RETURN_CODE_RESOURCE_FAILURE);
+			_DestroyResourceTexture2D(_texture);
+			*_texture = (Texture2D){ 0 };
+			return false;
+		}
+		return true;
 	}
 
-	// Parse & cache data
-	Texture2D texture = { 0 };
-	texture.data = stbi_load_from_memory(data_block, (int)data_block_len, &texture.width, &texture.height, &texture.channels, 0);
-	void* insertedData = unordered_map_str_insert(resourceList->_cacheTexture2D, _textureName, &texture);
-	MARS_ASSERT(insertedData != NULL);
+	// Image files only live until they are decoded, so they go through pooled scratch memory
+	bool view = !_resourceList->_resourceEncrypted;
+	size_t len = 0;
+	char* scratch = _AcquireResourceScratch(_resourceList, _offset, &len);
+	char* block = _GetResourceBlockInRun(_resourceList, _run, _offset, "MIMG", &view, scratch, &len);
+	if (block) {
+		int width = 0, height = 0, channels = 0;
+		_texture->data = stbi_load_from_memory((const stbi_uc*)block, (int)len, &width, &height, &channels, 0);
+		if (!_texture->data) { MARS_RETURN_SET(MARS_RETURN_CODE_RESOURCE_FAILURE); }
+		else {
+			static const TextureFormat formats[] = { TEXTURE_FORMAT_UNKNOWN, TEXTURE_FORMAT_R8, TEXTURE_FORMAT_RG8, TEXTURE_FORMAT_RGB8, TEXTURE_FORMAT_RGBA8 };
+			_texture->width = (unsigned int)width;
+			_texture->height = (unsigned int)height;
+			_texture->channels = (unsigned int)channels;
+			_texture->format = formats[channels];
+			_texture->mipLevels = 1;
+			_texture->size = (size_t)width * height * channels;
+		}
+		if (!view && block != scratch) { MARS_FREE(block); }
+	}
+	block_pool_free(_resourceList->_resourceScratch, scratch);
+	return _texture->data != NULL;
+}
 
-	return insertedData;
-get_resource_texture_2d_fail:
-	MARS_FREE(data_block);
-	return NULL;
-}
\ No newline at end of file
+bool _LoadResourceTexture2D(ResourceList* _resourceList, uint64_t _offset, Texture2D* _texture) {
+	return _LoadResourceTexture2DInRun(_resourceList, NULL, _offset, _texture);
+}
+
+bool _StartResourceValidation(ResourceList* _resourceList, thread_pool_t* _workers) {
+	if (!_resourceList->_blockState || _resourceList->_blockCount == 0) { return true; }
+	mars_mutex_lock(&_resourceList->_validationLock);
+	_resourceList->_validationWorkers = _workers;
+	_resourceList->_validationRunning = thread_pool_submit(_workers, _ValidateResourceBlocks, _resourceList);
+	bool running = _resourceList->_validationRunning;
+	mars_mutex_unlock(&_resourceList->_validationLock);
+	return running;
+}
+
+void _StopResourceValidation(ResourceList* _resourceList) {
+	mars_mutex_lock(&_resourceList->_validationLock);
+	_resourceList->_validationCancel = true;
+	while (_resourceList->_validationRunning) {
+		mars_cond_wait(&_resourceList->_validationSignal, &_resourceList->_validationLock);
+	}
+	mars_mutex_unlock(&_resourceList->_validationLock);
+}
+
+bool _LoadResourceDirectory(ResourceList* _resourceList, ResourceListDesc _desc) {
+	// Blocks are built from the files as they are read, so there is nothing to decrypt or validate
+	if (_desc.resourcePassword) {
+		MARS_DEBUG_WARN("Resource directory (%s) is not encrypted, ignoring its password!", _resourceList->_resourceFile);
+	}
+	_resourceList->_validation = RESOURCE_VALIDATE_NEVER;
+	_resourceList->_resourceHash = _umap_str_hash;
+	_resourceList->_resourceIndex = unordered_map_str_create(uint64_t);
+	_resourceList->_resourceLooseFiles = vector_create(_ResourceLooseFile);
+	_resourceList->_resourceLooseRetired = vector_create(buffer_t*);
+	_resourceList->_resourceWatchDirs = vector_create(_ResourceWatchDir);
+	if (!_resourceList->_resourceIndex || !_resourceList->_resourceLooseFiles || !_resourceList->_resourceLooseRetired || !_resourceList->_resourceWatchDirs) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate loose file index for (%s)!", _resourceList->_resourceFile);
+		return false;
+	}
+	if (_desc.hotReload) {
+#if defined(MARS_OS_LINUX)
+		_resourceList->_resourceWatch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (_resourceList->_resourceWatch < 0) {
+			MARS_DEBUG_WARN("Failed to watch resource directory (%s)!", _resourceList->_resourceFile);
+		}
+#else
+		MARS_DEBUG_WARN("Hot reloading is not supported on this platform, (%s) will not be watched!", _resourceList->_resourceFile);
+#endif
+	}
+	if (!_IndexResourceDirectory(_resourceList, _resourceList->_resourceFile, "")) {
+		MARS_DEBUG_WARN("Failed to index resource directory (%s)!", _resourceList->_resourceFile);
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+		return false;
+	}
+	MARS_DEBUG_LOG("Indexed %zu loose files in (%s)", unordered_map_str_size(_resourceList->_resourceIndex), _resourceList->_resourceFile);
+	return true;
+}
+
+static bool _WatchResourceDirectory(ResourceList* _resourceList, const char* _prefix, const char* _path) {
+#if defined(MARS_OS_LINUX)
+	if (_resourceList->_resourceWatch < 0) { return true; }
+	int watch = inotify_add_watch(_resourceList->_resourceWatch, _path, IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+	if (watch < 0) {
+		// Its files still load, they just are not reloaded
+		MARS_DEBUG_WARN("Failed to watch directory (%s)!", _path);
+		return true;
+	}
+	char* prefix = _mars_strdup(_prefix);
+	char* path = _mars_strdup(_path);
+	if (!prefix || !path) { goto watch_resource_directory_fail; }
+
+	// Watching a directory again (after it moves, or when rescanning) gives back its existing watch
+	for (size_t i = 0; i < vector_size(_resourceList->_resourceWatchDirs); ++i) {
+		_ResourceWatchDir* dir = (_ResourceWatchDir*)vector_get(_resourceList->_resourceWatchDirs, i);
+		if (dir->_watch == watch) {
+			MARS_FREE(dir->_prefix);
+			MARS_FREE(dir->_path);
+			dir->_prefix = prefix;
+			dir->_path = path;
+			return true;
+		}
+	}
+	_ResourceWatchDir dir = { watch, prefix, path };
+	if (vector_push_back(_resourceList->_resourceWatchDirs, &dir)) { return true; }
+watch_resource_directory_fail:
+	MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate watched directory (%s)!", _path);
+	MARS_FREE(prefix);
+	MARS_FREE(path);
+	return false;
+#else
+	return true;
+#endif
+}
+
+static bool _SetResourceLooseFile(ResourceList* _resourceList, char* _name, const char* _path) {
+	char* path = _mars_strdup(_path);
+	if (!path) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate loose file path (%s)!", _path);
+		return false;
+	}
+
+	// A file that is already indexed is rebuilt from its new contents on the next read
+	void* data = unordered_map_str_find(_resourceList->_resourceIndex, _name);
+	if (data) {
+		mars_mutex_lock(&_resourceList->_resourceLooseLock);
+		_ResourceLooseFile* file = (_ResourceLooseFile*)vector_get(_resourceList->_resourceLooseFiles, _RESOURCE_LOOSE_INDEX(*(uint64_t*)data));
+		bool retired = !file->_block || vector_push_back(_resourceList->_resourceLooseRetired, &file->_block);
+		if (retired) {
+			MARS_FREE(file->_path);
+			file->_path = path;
+			file->_block = NULL;
+			file->_generation++;
+		}
+		mars_mutex_unlock(&_resourceList->_resourceLooseLock);
+		if (!retired) {
+			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to retire loose file (%s)!", _name);
+			MARS_FREE(path);
+			return false;
+		}
+		_InvalidateResource(MARS_RESOURCES, _resourceList, _name);
+		return true;
+	}
+
+	// New files go at the end, since their index is part of their offset
+	mars_mutex_lock(&_resourceList->_resourceLooseLock);
+	uint64_t offset = _RESOURCE_LOOSE_OFFSET(vector_size(_resourceList->_resourceLooseFiles));
+	_ResourceLooseFile file = { path, NULL, 0 };
+	bool added = vector_push_back(_resourceList->_resourceLooseFiles, &file) != NULL;
+	mars_mutex_unlock(&_resourceList->_resourceLooseLock);
+	if (!added || !unordered_map_str_insert(_resourceList->_resourceIndex, _name, &offset)) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to add loose file (%s)!", _name);
+		if (!added) { MARS_FREE(path); }
+		return false;
+	}
+	return true;
+}
+
+static bool _RemoveResourceLooseFile(ResourceList* _resourceList, char* _name, const char* _path) {
+	void* data = unordered_map_str_find(_resourceList->_resourceIndex, _name);
+	if (!data) { return false; }
+
+	// Leave the name alone if another file provides it by now, such as the original after an editor removes its backup
+	mars_mutex_lock(&_resourceList->_resourceLooseLock);
+	_ResourceLooseFile* file = (_ResourceLooseFile*)vector_get(_resourceList->_resourceLooseFiles, _RESOURCE_LOOSE_INDEX(*(uint64_t*)data));
+	bool removed = file->_path && (!_path || strcmp(file->_path, _path) == 0) &&
+		(!file->_block || vector_push_back(_resourceList->_resourceLooseRetired, &file->_block));
+	if (removed) {
+		MARS_FREE(file->_path);
+		file->_path = NULL;
+		file->_block = NULL;
+		file->_generation++;
+	}
+	mars_mutex_unlock(&_resourceList->_resourceLooseLock);
+	if (!removed) { return false; }
+	_InvalidateResource(MARS_RESOURCES, _resourceList, _name);
+	unordered_map_str_delete(_resourceList->_resourceIndex, _name);
+	return true;
+}
+
+static void _RemoveResourceDirectory(ResourceList* _resourceList, const char* _prefix) {
+	size_t prefix_len = strlen(_prefix);
+	for(unordered_map_str_it_t* it = unordered_map_str_it(_resourceList->_resourceIndex); it; it = unordered_map_str_it_next(it)) {
+		if (strncmp(it->key, _prefix, prefix_len) == 0) { _RemoveResourceLooseFile(_resourceList, it->key, NULL); }
+	}
+#if defined(MARS_OS_LINUX)
+	for (size_t i = 0; i < vector_size(_resourceList->_resourceWatchDirs);) {
+		_ResourceWatchDir* dir = (_ResourceWatchDir*)vector_get(_resourceList->_resourceWatchDirs, i);
+		if (strncmp(dir->_prefix, _prefix, prefix_len) == 0) {
+			inotify_rm_watch(_resourceList->_resourceWatch, dir->_watch);
+			MARS_FREE(dir->_prefix);
+			MARS_FREE(dir->_path);
+			vector_remove(_resourceList->_resourceWatchDirs, i);
+		}
+		else { ++i; }
+	}
+#endif
+}
+
+static bool _ScanResourceDirectory(void* _arg, const char* _resourcePath, const char* _filePath, bool _directory) {
+	ResourceList* resourceList = (ResourceList*)_arg;
+	if (!_directory) { return _SetResourceLooseFile(resourceList, (char*)_resourcePath, _filePath); }
+	char prefix[MARS_RESOURCE_MAX_DEPTH * (MARS_RESOURCE_NAME_SIZE + 1) + 2];
+	snprintf(prefix, sizeof(prefix), "%s/", _resourcePath);
+	return _WatchResourceDirectory(resourceList, prefix, _filePath);
+}
+
+bool _IndexResourceDirectory(ResourceList* _resourceList, const char* _dir, const char* _prefix) {
+	// Watch before scanning, so files created in between are reported instead of missed
+	return _WatchResourceDirectory(_resourceList, _prefix, _dir) && _PackScanResourceFiles(_dir, _prefix, _ScanResourceDirectory, _resourceList);
+}
+
+buffer_t* _GetResourceLooseBlock(ResourceList* _resourceList, uint64_t _offset) {
+	buffer_t* block = NULL;
+	if ((_offset >> 32) == 0) { return NULL; }
+	mars_mutex_lock(&_resourceList->_resourceLooseLock);
+	while (true) {
+		_ResourceLooseFile* file = (_ResourceLooseFile*)vector_get(_resourceList->_resourceLooseFiles, _RESOURCE_LOOSE_INDEX(_offset));
+		if (!file || !file->_path) { break; }
+		if (file->_block) {
+			block = file->_block;
+			break;
+		}
+
+		// Build outside the lock so other files keep loading, dropping the result if the file changed in the meantime
+		char* path = _mars_strdup(file->_path);
+		uint32_t generation = file->_generation;
+		mars_mutex_unlock(&_resourceList->_resourceLooseLock);
+		buffer_t* built = (path) ? _PackResourceFile(path, false, false) : NULL;
+		MARS_FREE(path);
+		mars_mutex_lock(&_resourceList->_resourceLooseLock);
+		if (!built) { break; }
+		file = (_ResourceLooseFile*)vector_get(_resourceList->_resourceLooseFiles, _RESOURCE_LOOSE_INDEX(_offset));
+		if (file->_generation == generation && !file->_block) {
+			file->_block = built;
+			block = built;
+			break;
+		}
+		buffer_destroy(built);
+	}
+	mars_mutex_unlock(&_resourceList->_resourceLooseLock);
+	return block;
+}
+
+void _InvalidateResource(ResourceManager* _resourceManager, ResourceList* _resourceList, char* _name) {
+	_umap_str_hash_t hash = _umap_str_hash(_name);
+	for (int type = _RESOURCE_TYPE_TEXT; type <= _RESOURCE_TYPE_TEXTURE_2D; ++type) {
+		unordered_map_str_t* cache = *_GetResourceCache(_resourceList, (_ResourceType)type);
+		void* data = unordered_map_str_find_hashed(cache, _name, hash);
+		if (!data) { continue; }
+		ResourceCacheEntry* entry = *(ResourceCacheEntry**)(data);
+		if (entry->_refs == 0) {
+			_EvictResourceCacheEntry(_resourceManager, entry);
+			continue;
+		}
+
+		// Acquired resources stay valid until they are released, while the next read loads the new contents
+		unordered_map_str_delete_hashed(cache, _name, hash);
+		entry->_stale = true;
+	}
+}
+
+#if defined(MARS_OS_LINUX)
+static bool _HandleResourceDirectoryEvent(ResourceList* _resourceList, const struct inotify_event* _event) {
+	if (_event->mask & IN_Q_OVERFLOW) {
+		// Changes were dropped, so reload everything that is still there
+		MARS_DEBUG_WARN("Missed changes to (%s), reloading every file!", _resourceList->_resourceFile);
+		_IndexResourceDirectory(_resourceList, _resourceList->_resourceFile, "");
+		return true;
+	}
+	_ResourceWatchDir* dir = NULL;
+	for (size_t i = 0; i < vector_size(_resourceList->_resourceWatchDirs) && !dir; ++i) {
+		_ResourceWatchDir* candidate = (_ResourceWatchDir*)vector_get(_resourceList->_resourceWatchDirs, i);
+		if (candidate->_watch == _event->wd) { dir = candidate; }
+	}
+	if (!dir || _event->len == 0 || _event->name[0] == '.') { return false; }
+
+	// Resources are named without their extension
+	char name[MARS_RESOURCE_MAX_DEPTH * (MARS_RESOURCE_NAME_SIZE + 1) + 2];
+	const char* ext = strrchr(_event->name, '.');
+	size_t name_len = (ext) ? (size_t)(ext - _event->name) : strlen(_event->name);
+	size_t prefix_len = strlen(dir->_prefix);
+	if (name_len == 0 || name_len > MARS_RESOURCE_NAME_SIZE || prefix_len + name_len + 2 > sizeof(name)) { return false; }
+	memcpy(name, dir->_prefix, prefix_len);
+	memcpy(&name[prefix_len], _event->name, name_len);
+	name[prefix_len + name_len] = '\0';
+	size_t path_len = strlen(dir->_path) + strlen(_event->name) + 2;
+	char* path = MARS_MALLOC(path_len);
+	if (!path) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate path!");
+		return false;
+	}
+	snprintf(path, path_len, "%s/%s", dir->_path, _event->name);
+
+	bool changed = false;
+	if (_event->mask & IN_ISDIR) {
+		name[prefix_len + name_len] = '/';
+		name[prefix_len + name_len + 1] = '\0';
+		if (_event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+			_RemoveResourceDirectory(_resourceList, name);
+			changed = true;
+		}
+		else if (_event->mask & (IN_CREATE | IN_MOVED_TO)) {
+			if (!_IndexResourceDirectory(_resourceList, path, name)) { MARS_DEBUG_WARN("Failed to index directory (%s)!", path); }
+			changed = true;
+		}
+	}
+	else if (_event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+		changed = !unordered_map_str_find(_resourceList->_resourceIndex, name);
+		if (_SetResourceLooseFile(_resourceList, name, path)) { MARS_DEBUG_LOG("%s (%s)", (changed) ? "Adding" : "Reloading", name); }
+		else { changed = false; }
+	}
+	else if (_event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+		changed = _RemoveResourceLooseFile(_resourceList, name, path);
+	}
+	MARS_FREE(path);
+	return changed;
+}
+#endif
+
+bool _PollResourceDirectory(ResourceList* _resourceList) {
+	// Returns true if resources were added or removed, rather than just changed
+	bool changed = false;
+#if defined(MARS_OS_LINUX)
+	_Alignas(struct inotify_event) char events[4096];
+	ssize_t length = 0;
+	while ((length = read(_resourceList->_resourceWatch, events, sizeof(events))) > 0) {
+		for (ssize_t pos = 0; pos < length;) {
+			const struct inotify_event* event = (const struct inotify_event*)&events[pos];
+			changed |= _HandleResourceDirectoryEvent(_resourceList, event);
+			pos += (ssize_t)(sizeof(struct inotify_event) + event->len);
+		}
+	}
+#endif
+	return changed;
+}
+
+resourceList_id LoadResourceFile(ResourceListDesc _desc) {
+	MARS_RETURN_CLEAR;
+
+	// Load resource file
+	MARS_DEBUG_LOG("Loading resource file (%s)", _desc.resourceFile);
+	ResourceList* resourceList = _CreateResourceList(_desc, MARS_RESOURCES);
+	if (!resourceList) {
+		MARS_DEBUG_WARN("Failed to load resource file!");
+		return ID_NULL;
+	}
+
+	// Add to global list
+	MARS_DEBUG_LOG("Adding to global resource list", _desc.resourceFile);
+	resourceList_id id = _mars_id_generate();
+	void* insertedResourceList = unordered_map_insert(MARS_RESOURCES->_resourceLists, id, &resourceList);
+	MARS_ASSERT(*(ResourceList**)insertedResourceList == resourceList);
+
+	// Check the whole archive in the background, blocks read before then are checked on first read
+	if (resourceList->_validation == RESOURCE_VALIDATE_BACKGROUND && !_StartResourceValidation(resourceList, MARS_RESOURCES->_resourceWorkers)) {
+		MARS_DEBUG_WARN("Failed to start background validation, validating (%s) on first read!", _desc.resourceFile);
+	}
+	return id;
+}
+
+static void _CompleteResourceRequest(ResourceRequest* _request, ResourceRequestStatus _status) {
+	ResourceManager* resourceManager = _request->_resourceManager;
+	mars_mutex_lock(&resourceManager->_resourceRequestLock);
+	_request->_status = _status;
+	if (!queue_push(resourceManager->_resourceRequestsDone, &_request->_id)) {
+		MARS_DEBUG_WARN("Failed to queue finished resource request (%s)!", _request->_name);
+	}
+	mars_cond_broadcast(&resourceManager->_resourceRequestSignal);
+	mars_mutex_unlock(&resourceManager->_resourceRequestLock);
+}
+
+static void _LoadResourceRequest(void* _arg) {
+	// Runs on a worker thread, only reading the resource buffer & writing the request result
+	ResourceRequest* request = (ResourceRequest*)_arg;
+	ResourceList* resourceList = request->_resourceList;
+	ResourceRequestStatus status = RESOURCE_REQUEST_FAILED;
+	if (request->_type == _RESOURCE_TYPE_TEXTURE_2D) {
+		if (_LoadResourceTexture2D(resourceList, request->_offset, &request->_result.texture2D)) { status = RESOURCE_REQUEST_COMPLETE; }
+	}
+	else {
+		static char* signatures[] = { "MTXT", "MDAT" };
+		bool view = !resourceList->_resourceEncrypted;
+		size_t len = 0;
+		char* block = _GetResourceBlock(resourceList, request->_offset, signatures[request->_type], &view, NULL, &len);
+		if (block) { status = RESOURCE_REQUEST_COMPLETE; }
+		if (request->_type == _RESOURCE_TYPE_TEXT) {
+			request->_result.text = (TextBuffer){ .data = block, .size = len, ._view = view };
+		}
+		else {
+			request->_result.data = (DataBuffer){ .data = (uint8_t*)block, .size = len, ._view = view };
+		}
+	}
+	if (status == RESOURCE_REQUEST_FAILED) {
+		MARS_DEBUG_WARN("Failed to load resource (%s)!", request->_name);
+	}
+	_CompleteResourceRequest(request, status);
+}
+
+static void* _FinalizeResourceRequest(ResourceRequest* _request) {
+	// Move a finished result into its cache on the main thread, deferring to any copy loaded in the meantime
+	if (!_request->_resourceList || _request->_status != RESOURCE_REQUEST_COMPLETE) { return NULL; }
+	if (!_request->_finalized) {
+		_request->_finalized = true;
+		ResourceCacheEntry* entry = _FindResourceCache(_request->_resourceList, _request->_type, _request->_name, _request->_hash, false);
+		if (entry) {
+			_DestroyResourceValue(_request->_type, &_request->_result);
+		}
+		else if (!(entry = _InsertResourceCache(_request->_resourceList, _request->_type, _request->_name, _request->_hash, &_request->_result))) {
+			_DestroyResourceValue(_request->_type, &_request->_result);
+			_request->_status = RESOURCE_REQUEST_FAILED;
+			return NULL;
+		}
+
+		// Keep the resource resident until the request is delivered
+		_request->_entry = entry;
+		_PinResourceCacheEntry(entry);
+	}
+	return _request->_entry ? &_request->_entry->_value : NULL;
+}
+
+static resourceRequest_id _RequestResource(resourceList_id _resourceList, char* _name, _ResourceType _type, ResourceCallback _callback, void* _userData) {
+	MARS_RETURN_CLEAR;
+	ResourceRequest* request = NULL;
+
+	// Error check
+	if (_resourceList == ID_NULL) { 
+		MARS_DEBUG_WARN("NULL resource list ID!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+		goto request_resource_fail;
+	}
+	if (_name == NULL) {
+		MARS_DEBUG_WARN("NULL resource name!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_REFERENCE);
+		goto request_resource_fail;
+	}
+
+	// Get resource list
+	_umap_str_hash_t hash = _umap_str_hash(_name);
+	uint64_t offset = 0;
+	ResourceList* resourceList = _GetResourceList(&_resourceList, _name, hash, &offset);
+	if (!resourceList) { goto request_resource_fail; }
+
+	// Allocate request
+	request = MARS_CALLOC(1, sizeof(*request));
+	if (!request) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource request!");
+		goto request_resource_fail;
+	}
+	request->_name = _mars_strdup(_name);
+	if (!request->_name) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource request name!");
+		goto request_resource_fail;
+	}
+	request->_resourceManager = MARS_RESOURCES;
+	request->_resourceList = resourceList;
+	request->_resourceListId = _resourceList;
+	request->_type = _type;
+	request->_hash = hash;
+	request->_offset = offset;
+	request->_callback = _callback;
+	request->_userData = _userData;
+	request->_status = RESOURCE_REQUEST_PENDING;
+
+	// Register the request before anything can complete it
+	request->_id = _mars_id_generate();
+	if (!unordered_map_insert(MARS_RESOURCES->_resourceRequests, request->_id, &request)) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to register resource request!");
+		goto request_resource_fail;
+	}
+
+	// Cached & missing resources finish immediately, everything else is loaded by a worker
+	if ((request->_entry = _FindResourceCache(resourceList, _type, _name, request->_hash, true)) != NULL) {
+		_PinResourceCacheEntry(request->_entry);
+		request->_finalized = true;
+		_CompleteResourceRequest(request, RESOURCE_REQUEST_COMPLETE);
+	}
+	else if (request->_offset == 0 && (request->_offset = _FindResourceOffset(resourceList, _name, request->_hash)) == 0) {
+		MARS_DEBUG_WARN("Failed to find resource (%s)!", _name);
+		_CompleteResourceRequest(request, RESOURCE_REQUEST_FAILED);
+	}
+	else if (!thread_pool_submit(MARS_RESOURCES->_resourceWorkers, _LoadResourceRequest, request)) {
+		_LoadResourceRequest(request);
+	}
+	return request->_id;
+request_resource_fail:
+	if (request) {
+		MARS_FREE(request->_name);
+		MARS_FREE(request);
+	}
+	return ID_NULL;
+}
+
+void _UpdateResourceManager(ResourceManager* _resourceManager) {
+	if (!_resourceManager) { return; }
+
+	// Deliver requests that finished before this update, callbacks may queue new ones for the next
+	mars_mutex_lock(&_resourceManager->_resourceRequestLock);
+	size_t count = queue_size(_resourceManager->_resourceRequestsDone);
+	mars_mutex_unlock(&_resourceManager->_resourceRequestLock);
+	for (size_t i = 0; i < count; ++i) {
+		mars_mutex_lock(&_resourceManager->_resourceRequestLock);
+		resourceRequest_id id = *(resourceRequest_id*)queue_head(_resourceManager->_resourceRequestsDone);
+		queue_pop(_resourceManager->_resourceRequestsDone);
+		mars_mutex_unlock(&_resourceManager->_resourceRequestLock);
+
+		void* data = unordered_map_find(_resourceManager->_resourceRequests, id);
+		if (!data) { continue; }
+		ResourceRequest* request = *(ResourceRequest**)(data);
+		void* resource = _FinalizeResourceRequest(request);
+		unordered_map_delete(_resourceManager->_resourceRequests, id);
+		if (request->_callback) {
+			request->_callback(id, resource, request->_userData);
+		}
+		_DestroyResourceRequest(request);
+	}
+
+	// Delivered resources are no longer pinned, so evictions they held off can happen now
+	if (count > 0) {
+		for(unordered_map_it_t* it = unordered_map_it(_resourceManager->_resourceLists); it; it = unordered_map_it_next(it)) {
+			_TrimResourceCaches(_resourceManager, *(ResourceList**)(it->data), NULL);
+		}
+	}
+
+	// Pick up changes to watched resource directories, mounted paths follow files that appear or disappear
+	bool remount = false;
+	for(unordered_map_it_t* it = unordered_map_it(_resourceManager->_resourceLists); it; it = unordered_map_it_next(it)) {
+		ResourceList* resourceList = *(ResourceList**)(it->data);
+		if (resourceList->_resourceWatch >= 0 && _PollResourceDirectory(resourceList)) {
+			for (size_t i = 0; i < vector_size(_resourceManager->_resourceMounts); ++i) {
+				remount |= ((_ResourceMount*)vector_get(_resourceManager->_resourceMounts, i))->_resourceList == it->key;
+			}
+		}
+	}
+	if (remount && !_BuildResourceMountIndex(_resourceManager)) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate mounted resource index!");
+	}
+}
+
+void _CancelResourceRequests(ResourceManager* _resourceManager, resourceList_id _resourceList) {
+	// Wait out any work still reading from the list, then detach its requests so they are delivered as failures
+	for(unordered_map_it_t* it = unordered_map_it(_resourceManager->_resourceRequests); it; it = unordered_map_it_next(it)) {
+		ResourceRequest* request = *(ResourceRequest**)(it->data);
+		if (request->_resourceListId != _resourceList) { continue; }
+		mars_mutex_lock(&_resourceManager->_resourceRequestLock);
+		while (request->_status == RESOURCE_REQUEST_PENDING) {
+			mars_cond_wait(&_resourceManager->_resourceRequestSignal, &_resourceManager->_resourceRequestLock);
+		}
+		if (!request->_finalized && request->_status == RESOURCE_REQUEST_COMPLETE) {
+			_DestroyResourceValue(request->_type, &request->_result);
+		}
+		request->_finalized = true;
+		request->_status = RESOURCE_REQUEST_FAILED;
+		request->_resourceList = NULL;
+		request->_entry = NULL;
+		mars_mutex_unlock(&_resourceManager->_resourceRequestLock);
+	}
+}
+
+void _DestroyResourceRequest(ResourceRequest* _request) {
+	if (_request) {
+		if (!_request->_finalized && _request->_status == RESOURCE_REQUEST_COMPLETE) {
+			_DestroyResourceValue(_request->_type, &_request->_result);
+		}
+		if (_request->_entry) { _UnpinResourceCacheEntry(_request->_entry); }
+		MARS_FREE(_request->_name);
+		MARS_FREE(_request);
+	}
+}
+
+void UnloadResourceFile(resourceList_id _id) {
+	if (_id != ID_NULL) {
+		void* data = unordered_map_find(MARS_RESOURCES->_resourceLists, _id);
+		if (data) {
+			ResourceList* resourceList = *(ResourceList**)(data);
+			UnmountResourceFile(_id);
+			_CancelResourceRequests(MARS_RESOURCES, _id);
+			MARS_RESOURCES->_cacheBytes -= resourceList->_cacheStats.residentBytes;
+			_DestroyResourceList(resourceList);
+			unordered_map_delete(MARS_RESOURCES->_resourceLists, _id);
+		}
+	}
+}
+
+ResourceList* _GetResourceList(resourceList_id* _resourceList, char* _name, _umap_str_hash_t _hash, uint64_t* _offset) {
+	// Mounted paths resolve straight to the list providing them & their data block
+	*_offset = 0;
+	if (*_resourceList == RESOURCE_LIST_MOUNTED) {
+		_ResourceMountEntry* entry = unordered_map_str_find_hashed(MARS_RESOURCES->_resourceMountIndex, _name, _hash);
+		if (!entry) {
+			MARS_DEBUG_WARN("Failed to find mounted resource (%s)!", _name);
+			MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+			return NULL;
+		}
+		*_resourceList = entry->_resourceListId;
+		*_offset = entry->_offset;
+		return entry->_resourceList;
+	}
+	void* data = unordered_map_find(MARS_RESOURCES->_resourceLists, *_resourceList);
+	if (!data) {
+		MARS_DEBUG_WARN("Invalid resource list ID (%d)!", (int)*_resourceList);
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_PARAMETER);
+		return NULL;
+	}
+	return *(ResourceList**)(data);
+}
+
+bool _AddResourceMountIndex(ResourceManager* _resourceManager, ResourceList* _resourceList, resourceList_id _id) {
+	// Overwrite whatever lower priority lists provided for the same paths
+	for(unordered_map_str_it_t* it = unordered_map_str_it(_resourceList->_resourceIndex); it; it = unordered_map_str_it_next(it)) {
+		_ResourceMountEntry entry = { _resourceList, _id, *(uint64_t*)(it->data) };
+		void* slot = unordered_map_str_insert(_resourceManager->_resourceMountIndex, it->key, &entry);
+		if (!slot) {
+			MARS_FREE(it);
+			return false;
+		}
+		memcpy(slot, &entry, sizeof(entry));
+	}
+	return true;
+}
+
+bool _BuildResourceMountIndex(ResourceManager* _resourceManager) {
+	// Size the index for every mounted path up front, then add lists from lowest to highest priority
+	size_t count = 0;
+	for (size_t i = 0; i < vector_size(_resourceManager->_resourceMounts); ++i) {
+		_ResourceMount* mount = (_ResourceMount*)vector_get(_resourceManager->_resourceMounts, i);
+		ResourceList* resourceList = *(ResourceList**)unordered_map_find(_resourceManager->_resourceLists, mount->_resourceList);
+		count += unordered_map_str_size(resourceList->_resourceIndex);
+	}
+	size_t capacity = umax((size_t)MARS_NEXT_POW2((size_t)((double)count / _UMAP_STR_DEFAULT_LOAD) + 1), UMAP_STR_DEFAULT_CAPACITY);
+	unordered_map_str_t* index = _umap_str_factory(sizeof(_ResourceMountEntry), capacity, false, _umap_str_hash);
+	if (!index) { return false; }
+	unordered_map_str_t* previous = _resourceManager->_resourceMountIndex;
+	_resourceManager->_resourceMountIndex = index;
+	for (size_t i = 0; i < vector_size(_resourceManager->_resourceMounts); ++i) {
+		_ResourceMount* mount = (_ResourceMount*)vector_get(_resourceManager->_resourceMounts, i);
+		ResourceList* resourceList = *(ResourceList**)unordered_map_find(_resourceManager->_resourceLists, mount->_resourceList);
+		if (!_AddResourceMountIndex(_resourceManager, resourceList, mount->_resourceList)) {
+			unordered_map_str_destroy(_resourceManager->_resourceMountIndex);
+			_resourceManager->_resourceMountIndex = previous;
+			return false;
+		}
+	}
+	unordered_map_str_destroy(previous);
+	return true;
+}
+
+bool MountResourceFile(resourceList_id _resourceList, int _priority) {
+	MARS_RETURN_CLEAR;
+	ResourceManager* resourceManager = MARS_RESOURCES;
+	void* data = unordered_map_find(resourceManager->_resourceLists, _resourceList);
+	if (!data) {
+		MARS_DEBUG_WARN("Invalid resource list ID (%d)!", (int)_resourceList);
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_PARAMETER);
+		return false;
+	}
+	ResourceList* resourceList = *(ResourceList**)(data);
+
+	// Mounting again only changes the priority
+	bool remount = false;
+	for (size_t i = 0; i < vector_size(resourceManager->_resourceMounts); ++i) {
+		if (((_ResourceMount*)vector_get(resourceManager->_resourceMounts, i))->_resourceList == _resourceList) {
+			vector_remove(resourceManager->_resourceMounts, i);
+			remount = true;
+			break;
+		}
+	}
+
+	// Go after every mount of the same or lower priority, so the newest mount wins ties
+	size_t pos = 0;
+	while (pos < vector_size(resourceManager->_resourceMounts) && ((_ResourceMount*)vector_get(resourceManager->_resourceMounts, pos))->_priority <= _priority) { pos++; }
+	_ResourceMount mount = { _resourceList, _priority };
+	if (!vector_insert(&resourceManager->_resourceMounts, pos, &mount)) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate resource mount!");
+		if (remount) { _BuildResourceMountIndex(resourceManager); }
+		return false;
+	}
+
+	// A new top priority mount only overlays its own paths, anything else reorders the layers & rebuilds the index.
+	// So does a list larger than the index, since rebuilding sizes the table once instead of growing it repeatedly.
+	bool top = !remount && pos + 1 == vector_size(resourceManager->_resourceMounts) &&
+		unordered_map_str_size(resourceList->_resourceIndex) < unordered_map_str_size(resourceManager->_resourceMountIndex);
+	if (!(top ? _AddResourceMountIndex(resourceManager, resourceList, _resourceList) : _BuildResourceMountIndex(resourceManager))) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate mounted resource index!");
+		vector_remove(resourceManager->_resourceMounts, pos);
+		_BuildResourceMountIndex(resourceManager);
+		return false;
+	}
+	MARS_DEBUG_LOG("Mounted (%s) at priority %d, %zu mounted resources", resourceList->_resourceFile, _priority, unordered_map_str_size(resourceManager->_resourceMountIndex));
+	return true;
+}
+
+void UnmountResourceFile(resourceList_id _resourceList) {
+	ResourceManager* resourceManager = MARS_RESOURCES;
+	for (size_t i = 0; i < vector_size(resourceManager->_resourceMounts); ++i) {
+		if (((_ResourceMount*)vector_get(resourceManager->_resourceMounts, i))->_resourceList == _resourceList) {
+			// Paths this list shadowed fall back to the layers below it
+			vector_remove(resourceManager->_resourceMounts, i);
+			if (!_BuildResourceMountIndex(resourceManager)) {
+				// The old index still points into the unmounted list, so drop every mount rather than keep it
+				MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate mounted resource index!");
+				vector_clear(resourceManager->_resourceMounts);
+				for(unordered_map_str_it_t* it = unordered_map_str_it(resourceManager->_resourceMountIndex); it; it = unordered_map_str_it_next(it)) {
+					unordered_map_str_delete(resourceManager->_resourceMountIndex, it->key);
+				}
+			}
+			return;
+		}
+	}
+}
+
+resourceList_id GetMountedResourceFile(char* _name) {
+	if (!_name) { return ID_NULL; }
+	_ResourceMountEntry* entry = unordered_map_str_find(MARS_RESOURCES->_resourceMountIndex, _name);
+	return (entry) ? entry->_resourceListId : ID_NULL;
+}
+
+TextBuffer* GetResourceText(resourceList_id _resourceList, char* _textName) {
+	MARS_RETURN_CLEAR;
+
+	// Error check
+	if (_resourceList == ID_NULL) { 
+		MARS_DEBUG_WARN("NULL resource list ID!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+		goto get_resource_text_fail;
+	}
+	if (_textName == NULL) {
+		MARS_DEBUG_WARN("NULL text name!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_REFERENCE);
+		goto get_resource_text_fail;
+	}
+
+	// Get resource list
+	_umap_str_hash_t textHash = _umap_str_hash(_textName);
+	uint64_t resourceOff = 0;
+	ResourceList* resourceList = _GetResourceList(&_resourceList, _textName, textHash, &resourceOff);
+	if (!resourceList) { goto get_resource_text_fail; }
+
+	// Check cache
+	ResourceCacheEntry* entry = _FindResourceCache(resourceList, _RESOURCE_TYPE_TEXT, _textName, textHash, true);
+	if (entry) { return &entry->_value.text; }
+
+	// Get offset of data in buffer, mounted paths already have theirs
+	if (resourceOff == 0) { resourceOff = _FindResourceOffset(resourceList, _textName, textHash); }
+	if (resourceOff == 0) {
+		MARS_DEBUG_WARN("Failed to find text (%s)!", _textName);
+		goto get_resource_text_fail;
+	}
+
+	// Get data from buffer, referencing it in place when it is stored as plain text
+	TextBuffer text = { 0 };
+	text._view = !resourceList->_resourceEncrypted;
+	text.data = _GetResourceBlock(resourceList, resourceOff, "MTXT", &text._view, NULL, &text.size);
+	if (!text.data) {
+		if (MARS_RETURN_CODE == MARS_RETURN_CODE_RESOURCE_FAILURE) {
+			MARS_DEBUG_WARN("Failed to decompress text data (%s)!", _textName);
+		}
+		else if (MARS_RETURN_CODE == MARS_RETURN_CODE_FILESYSTEM_FAILURE) {
+			MARS_DEBUG_WARN("Failed to validate text data (%s)!", _textName);
+		}
+		goto get_resource_text_fail;
+	}
+
+	// Cache data
+	entry = _InsertResourceCache(resourceList, _RESOURCE_TYPE_TEXT, _textName, textHash, &(_ResourceValue){ .text = text });
+	if (!entry) {
+		_DestroyResourceText(&text);
+		goto get_resource_text_fail;
+	}
+
+	return &entry->_value.text;
+get_resource_text_fail:
+	return NULL;
+}
+
+DataBuffer* GetResourceData(resourceList_id _resourceList, char* _dataName) {
+	MARS_RETURN_CLEAR;
+
+	// Error check
+	if (_resourceList == ID_NULL) { 
+		MARS_DEBUG_WARN("NULL resource list ID!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+		goto get_resource_data_fail;
+	}
+	if (_dataName == NULL) {
+		MARS_DEBUG_WARN("NULL data name!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_REFERENCE);
+		goto get_resource_data_fail;
+	}
+
+	// Get resource list
+	_umap_str_hash_t dataHash = _umap_str_hash(_dataName);
+	uint64_t resourceOff = 0;
+	ResourceList* resourceList = _GetResourceList(&_resourceList, _dataName, dataHash, &resourceOff);
+	if (!resourceList) { goto get_resource_data_fail; }
+
+	// Check cache
+	ResourceCacheEntry* entry = _FindResourceCache(resourceList, _RESOURCE_TYPE_DATA, _dataName, dataHash, true);
+	if (entry) { return &entry->_value.data; }
+
+	// Get offset of data in buffer, mounted paths already have theirs
+	if (resourceOff == 0) { resourceOff = _FindResourceOffset(resourceList, _dataName, dataHash); }
+	if (resourceOff == 0) {
+		MARS_DEBUG_WARN("Failed to find data (%s)!", _dataName);
+		goto get_resource_data_fail;
+	}
+
+	// Get data from buffer, referencing it in place when it is stored uncompressed
+	DataBuffer buffer = { 0 };
+	buffer._view = !resourceList->_resourceEncrypted;
+	buffer.data = (uint8_t*)_GetResourceBlock(resourceList, resourceOff, "MDAT", &buffer._view, NULL, &buffer.size);
+	if (!buffer.data) {
+		if (MARS_RETURN_CODE == MARS_RETURN_CODE_RESOURCE_FAILURE) {
+			MARS_DEBUG_WARN("Failed to decompress data (%s)!", _dataName);
+		}
+		else if (MARS_RETURN_CODE == MARS_RETURN_CODE_FILESYSTEM_FAILURE) {
+			MARS_DEBUG_WARN("Failed to validate data (%s)!", _dataName);
+		}
+		goto get_resource_data_fail;
+	}
+
+	// Cache data
+	entry = _InsertResourceCache(resourceList, _RESOURCE_TYPE_DATA, _dataName, dataHash, &(_ResourceValue){ .data = buffer });
+	if (!entry) {
+		_DestroyResourceData(&buffer);
+		goto get_resource_data_fail;
+	}
+
+	return &entry->_value.data;
+get_resource_data_fail:
+	return NULL;
+}
+
+Texture2D* GetResourceTexture2D(resourceList_id _resourceList, char* _textureName) {
+	MARS_RETURN_CLEAR;
+
+	// Error check
+	if (_resourceList == ID_NULL) { 
+		MARS_DEBUG_WARN("NULL resource list ID!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+		goto get_resource_texture_2d_fail;
+	}
+	if (_textureName == NULL) {
+		MARS_DEBUG_WARN("NULL texture name!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_REFERENCE);
+		goto get_resource_texture_2d_fail;
+	}
+
+	// Get resource list, hashing the name once for every lookup & the insertion
+	_umap_str_hash_t textureHash = _umap_str_hash(_textureName);
+	uint64_t resourceOff = 0;
+	ResourceList* resourceList = _GetResourceList(&_resourceList, _textureName, textureHash, &resourceOff);
+	if (!resourceList) { goto get_resource_texture_2d_fail; }
+
+	// Check cache
+	ResourceCacheEntry* entry = _FindResourceCache(resourceList, _RESOURCE_TYPE_TEXTURE_2D, _textureName, textureHash, true);
+	if (entry) { return &entry->_value.texture2D; }
+
+	// Get offset of data in buffer, mounted paths already have theirs
+	if (resourceOff == 0) { resourceOff = _FindResourceOffset(resourceList, _textureName, textureHash); }
+	if (resourceOff == 0) {
+		MARS_DEBUG_WARN("Failed to find texture (%s)!", _textureName);
+		goto get_resource_texture_2d_fail;
+	}
+
+	// Load & cache texture
+	Texture2D texture = { 0 };
+	if (!_LoadResourceTexture2D(resourceList, resourceOff, &texture)) {
+		if (MARS_RETURN_CODE == MARS_RETURN_CODE_RESOURCE_FAILURE) {
+			MARS_DEBUG_WARN("Failed to decode texture data (%s)!", _textureName);
+		}
+		else if (MARS_RETURN_CODE == MARS_RETURN_CODE_FILESYSTEM_FAILURE) {
+			MARS_DEBUG_WARN("Failed to validate texture data (%s)!", _textureName);
+		}
+		goto get_resource_texture_2d_fail;
+	}
+	entry = _InsertResourceCache(resourceList, _RESOURCE_TYPE_TEXTURE_2D, _textureName, textureHash, &(_ResourceValue){ .texture2D = texture });
+	if (!entry) {
+		_DestroyResourceTexture2D(&texture);
+		goto get_resource_texture_2d_fail;
+	}
+
+	return &entry->_value.texture2D;
+get_resource_texture_2d_fail:
+	return NULL;
+}
+
+resourceRequest_id GetResourceTextAsync(resourceList_id _resourceList, char* _textName, ResourceCallback _callback, void* _userData) {
+	return _RequestResource(_resourceList, _textName, _RESOURCE_TYPE_TEXT, _callback, _userData);
+}
+
+resourceRequest_id GetResourceDataAsync(resourceList_id _resourceList, char* _dataName, ResourceCallback _callback, void* _userData) {
+	return _RequestResource(_resourceList, _dataName, _RESOURCE_TYPE_DATA, _callback, _userData);
+}
+
+resourceRequest_id GetResourceTexture2DAsync(resourceList_id _resourceList, char* _textureName, ResourceCallback _callback, void* _userData) {
+	return _RequestResource(_resourceList, _textureName, _RESOURCE_TYPE_TEXTURE_2D, _callback, _userData);
+}
+
+TextBuffer* AcquireResourceText(resourceList_id _resourceList, char* _textName) {
+	TextBuffer* text = GetResourceText(_resourceList, _textName);
+	if (text) { _PinResourceCacheEntry((ResourceCacheEntry*)text); }
+	return text;
+}
+
+DataBuffer* AcquireResourceData(resourceList_id _resourceList, char* _dataName) {
+	DataBuffer* buffer = GetResourceData(_resourceList, _dataName);
+	if (buffer) { _PinResourceCacheEntry((ResourceCacheEntry*)buffer); }
+	return buffer;
+}
+
+Texture2D* AcquireResourceTexture2D(resourceList_id _resourceList, char* _textureName) {
+	Texture2D* texture = GetResourceTexture2D(_resourceList, _textureName);
+	if (texture) { _PinResourceCacheEntry((ResourceCacheEntry*)texture); }
+	return texture;
+}
+
+bool ReadResourceData(resourceList_id _resourceList, char* _dataName, void* _dest, size_t* _size) {
+	MARS_RETURN_CLEAR;
+
+	// Error check
+	if (_resourceList == ID_NULL) {
+		MARS_DEBUG_WARN("NULL resource list ID!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+		return false;
+	}
+	if (_dataName == NULL || _size == NULL) {
+		MARS_DEBUG_WARN("NULL data name or size!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_REFERENCE);
+		return false;
+	}
+
+	// Get resource list
+	_umap_str_hash_t dataHash = _umap_str_hash(_dataName);
+	uint64_t resourceOff = 0;
+	ResourceList* resourceList = _GetResourceList(&_resourceList, _dataName, dataHash, &resourceOff);
+	if (!resourceList) { return false; }
+
+	// Get offset of data in buffer
+	if (resourceOff == 0) { resourceOff = _FindResourceOffset(resourceList, _dataName, dataHash); }
+	char signature[4] = { 0 };
+	if (resourceOff == 0 || !_ReadResourceBytes(resourceList, resourceOff, 4, signature) || memcmp(signature, "MDAT", 4) != 0) {
+		MARS_DEBUG_WARN("Failed to find data (%s)!", _dataName);
+		return false;
+	}
+
+	// Size queries only need the block header
+	if (!_dest) {
+		uint64_t size = 0;
+		if (!_ReadResourceUInt(resourceList, resourceOff + 32, 8, &size)) { return false; }
+		*_size = (size_t)size;
+		return false;
+	}
+	bool view = false;
+	if (!_GetResourceBlock(resourceList, resourceOff, "MDAT", &view, (char*)_dest, _size)) {
+		if (MARS_RETURN_CODE == MARS_RETURN_CODE_RESOURCE_FAILURE) {
+			MARS_DEBUG_WARN("Failed to decompress data (%s)!", _dataName);
+		}
+		else if (MARS_RETURN_CODE == MARS_RETURN_CODE_FILESYSTEM_FAILURE) {
+			MARS_DEBUG_WARN("Failed to validate data (%s)!", _dataName);
+		}
+		return false;
+	}
+	return true;
+}
+
+size_t GetTextureLevelSize(TextureFormat _format, unsigned int _width, unsigned int _height) {
+	size_t block_width = 4, block_height = 4, block_size = 16;
+	switch (_format) {
+		case TEXTURE_FORMAT_R8:
+		case TEXTURE_FORMAT_RG8:
+		case TEXTURE_FORMAT_RGB8:
+		case TEXTURE_FORMAT_RGBA8: return (size_t)_width * _height * _GetTextureFormatChannels(_format);
+		case TEXTURE_FORMAT_BC1:
+		case TEXTURE_FORMAT_BC4: block_size = 8; break;
+		case TEXTURE_FORMAT_BC2:
+		case TEXTURE_FORMAT_BC3:
+		case TEXTURE_FORMAT_BC5:
+		case TEXTURE_FORMAT_BC6H:
+		case TEXTURE_FORMAT_BC7:
+		case TEXTURE_FORMAT_ASTC_4X4: break;
+		case TEXTURE_FORMAT_ASTC_5X5: block_width = block_height = 5; break;
+		case TEXTURE_FORMAT_ASTC_6X6: block_width = block_height = 6; break;
+		case TEXTURE_FORMAT_ASTC_8X8: block_width = block_height = 8; break;
+		default: return 0;
+	}
+	return ((_width + block_width - 1) / block_width) * ((_height + block_height - 1) / block_height) * block_size;
+}
+
+uint8_t* GetTexture2DLevel(Texture2D* _texture, unsigned int _level, unsigned int* _width, unsigned int* _height, size_t* _size) {
+	if (!_texture || !_texture->data || _level >= _texture->mipLevels) { return NULL; }
+	size_t offset = 0;
+	for (unsigned int level = 0; level < _level; ++level) {
+		offset += GetTextureLevelSize(_texture->format, (unsigned int)umax(_texture->width >> level, 1), (unsigned int)umax(_texture->height >> level, 1));
+	}
+	unsigned int width = (unsigned int)umax(_texture->width >> _level, 1);
+	unsigned int height = (unsigned int)umax(_texture->height >> _level, 1);
+	if (_width) { *_width = width; }
+	if (_height) { *_height = height; }
+	if (_size) { *_size = GetTextureLevelSize(_texture->format, width, height); }
+	return &_texture->data[offset];
+}
+
+void ReleaseResource(void* _resource) {
+	if (!_resource) { return; }
+
+	// Resources are the first member of their cache entry
+	ResourceCacheEntry* entry = (ResourceCacheEntry*)_resource;
+	if (entry->_refs == 0) {
+		MARS_DEBUG_WARN("Released resource (%s) that was not acquired!", entry->_name);
+		return;
+	}
+	_UnpinResourceCacheEntry(entry);
+
+	// Evictions deferred while the resource was pinned happen now, & resources replaced on disk go straight away
+	if (entry->_refs == 0) {
+		ResourceList* resourceList = entry->_resourceList;
+		if (entry->_stale) { _EvictResourceCacheEntry(MARS_RESOURCES, entry); }
+		_TrimResourceCaches(MARS_RESOURCES, resourceList, NULL);
+	}
+}
+
+void SetResourceCacheBudget(resourceList_id _resourceList, size_t _bytes) {
+	if (_resourceList == ID_NULL) {
+		MARS_RESOURCES->_cacheBudget = _bytes;
+		_TrimResourceCaches(MARS_RESOURCES, NULL, NULL);
+		return;
+	}
+	void* data = unordered_map_find(MARS_RESOURCES->_resourceLists, _resourceList);
+	if (!data) {
+		MARS_DEBUG_WARN("Invalid resource list ID (%d)!", (int)_resourceList);
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_PARAMETER);
+		return;
+	}
+	ResourceList* resourceList = *(ResourceList**)(data);
+	resourceList->_cacheStats.budget = _bytes;
+	_TrimResourceCaches(MARS_RESOURCES, resourceList, NULL);
+}
+
+ResourceCacheStats GetResourceCacheStats(resourceList_id _resourceList) {
+	ResourceCacheStats stats = { 0 };
+	if (_resourceList != ID_NULL) {
+		void* data = unordered_map_find(MARS_RESOURCES->_resourceLists, _resourceList);
+		if (!data) {
+			MARS_DEBUG_WARN("Invalid resource list ID (%d)!", (int)_resourceList);
+			MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_PARAMETER);
+			return stats;
+		}
+		return (*(ResourceList**)(data))->_cacheStats;
+	}
+
+	// Sum every list against the global budget
+	for(unordered_map_it_t* it = unordered_map_it(MARS_RESOURCES->_resourceLists); it; it = unordered_map_it_next(it)) {
+		ResourceCacheStats* listStats = &(*(ResourceList**)(it->data))->_cacheStats;
+		stats.hits += listStats->hits;
+		stats.misses += listStats->misses;
+		stats.evictions += listStats->evictions;
+		stats.residentBytes += listStats->residentBytes;
+		stats.pinnedBytes += listStats->pinnedBytes;
+	}
+	stats.budget = MARS_RESOURCES->_cacheBudget;
+	return stats;
+}
+
+typedef struct {
+	ResourceList* resourceList;
+	resourceList_id resourceListId;
+	uint64_t offset;
+	uint64_t size;
+	const char* name;
+	_umap_str_hash_t hash;
+	_ResourceType type;
+	_ResourceValue result;
+	bool loaded;
+	bool duplicate;						// Same name as the previous entry, which loads it
+} _ResourcePrefetchEntry;
+
+typedef struct {
+	_ResourcePrefetchEntry* entries;
+	const _ResourceRun* run;			// Decrypted bytes of the run, or NULL to read blocks from the list
+} _ResourcePrefetchRun;
+
+static int _CompareResourcePrefetchEntry(const void* _a, const void* _b) {
+	// Group mounted resources by the file providing them, then by offset within it, then by name so duplicates are adjacent
+	const _ResourcePrefetchEntry* a = (const _ResourcePrefetchEntry*)_a;
+	const _ResourcePrefetchEntry* b = (const _ResourcePrefetchEntry*)_b;
+	if (a->resourceListId != b->resourceListId) { return (a->resourceListId > b->resourceListId) - (a->resourceListId < b->resourceListId); }
+	if (a->offset != b->offset) { return (a->offset > b->offset) - (a->offset < b->offset); }
+	return strcmp(a->name, b->name);
+}
+
+static void _LoadResourcePrefetchEntry(void* _arg, size_t _index) {
+	// Runs on a worker thread, only reading the run & writing the entry's result
+	_ResourcePrefetchRun* run = (_ResourcePrefetchRun*)_arg;
+	_ResourcePrefetchEntry* entry = &run->entries[_index];
+	ResourceList* resourceList = entry->resourceList;
+	if (entry->duplicate) { return; }
+	if (entry->type == _RESOURCE_TYPE_TEXTURE_2D) {
+		entry->loaded = _LoadResourceTexture2DInRun(resourceList, run->run, entry->offset, &entry->result.texture2D);
+	}
+	else {
+		static char* signatures[] = { "MTXT", "MDAT" };
+		bool view = !resourceList->_resourceEncrypted;
+		size_t len = 0;
+		char* block = _GetResourceBlockInRun(resourceList, run->run, entry->offset, signatures[entry->type], &view, NULL, &len);
+		entry->loaded = (block != NULL);
+		if (entry->type == _RESOURCE_TYPE_TEXT) {
+			entry->result.text = (TextBuffer){ .data = block, .size = len, ._view = view };
+		}
+		else {
+			entry->result.data = (DataBuffer){ .data = (uint8_t*)block, .size = len, ._view = view };
+		}
+	}
+	if (!entry->loaded) {
+		MARS_DEBUG_WARN("Failed to load resource (%s)!", entry->name);
+	}
+}
+
+ResourcePrefetchStats PrefetchResources(resourceList_id _resourceList, const char** _names, size_t _count) {
+	MARS_RETURN_CLEAR;
+	ResourcePrefetchStats stats = { 0 };
+	_ResourcePrefetchEntry* entries = NULL;
+	double start = _mars_time_seconds();
+
+	// Error check
+	if (_resourceList == ID_NULL) { 
+		MARS_DEBUG_WARN("NULL resource list ID!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+		goto prefetch_resources_fail;
+	}
+	if (_names == NULL) {
+		MARS_DEBUG_WARN("NULL resource names!");
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_REFERENCE);
+		goto prefetch_resources_fail;
+	}
+	if (_count == 0) { return stats; }
+	if (_resourceList != RESOURCE_LIST_MOUNTED && !unordered_map_find(MARS_RESOURCES->_resourceLists, _resourceList)) {
+		MARS_DEBUG_WARN("Invalid resource list ID (%d)!", (int)_resourceList);
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_PARAMETER);
+		goto prefetch_resources_fail;
+	}
+	entries = MARS_CALLOC(_count, sizeof(*entries));
+	if (!entries) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate prefetch list!");
+		goto prefetch_resources_fail;
+	}
+
+	// Resolve names to data blocks, skipping anything already cached
+	size_t entry_count = 0;
+	for (size_t i = 0; i < _count; ++i) {
+		char* name = (char*)_names[i];
+		if (!name) { stats.failed++; continue; }
+		_umap_str_hash_t hash = _umap_str_hash(name);
+		resourceList_id resourceListId = _resourceList;
+		uint64_t offset = 0;
+		ResourceList* resourceList = _GetResourceList(&resourceListId, name, hash, &offset);
+		if (resourceList && offset == 0) { offset = _FindResourceOffset(resourceList, name, hash); }
+		char signature[4];
+		uint64_t compressed_size = 0;
+		if (offset == 0 || !_ReadResourceBytes(resourceList, offset, 4, signature) || !_ReadResourceUInt(resourceList, offset + 24, 8, &compressed_size)) {
+			MARS_DEBUG_WARN("Failed to find resource (%s)!", name);
+			stats.failed++;
+			continue;
+		}
+		_ResourcePrefetchEntry* entry = &entries[entry_count];
+		if (memcmp(signature, "MTXT", 4) == 0) { entry->type = _RESOURCE_TYPE_TEXT; }
+		else if (memcmp(signature, "MDAT", 4) == 0) { entry->type = _RESOURCE_TYPE_DATA; }
+		else if (memcmp(signature, "MIMG", 4) == 0 || memcmp(signature, "MTEX", 4) == 0) { entry->type = _RESOURCE_TYPE_TEXTURE_2D; }
+		else {
+			MARS_DEBUG_WARN("Unknown resource type for (%s)!", name);
+			stats.failed++;
+			continue;
+		}
+		if (_FindResourceCache(resourceList, entry->type, name, hash, false)) {
+			stats.cached++;
+			continue;
+		}
+		entry->resourceList = resourceList;
+		entry->resourceListId = resourceListId;
+		entry->offset = offset;
+		entry->size = 80 + compressed_size;
+		entry->name = name;
+		entry->hash = hash;
+		entry_count++;
+	}
+
+	// Read forward through the file, merging blocks that lie close together into runs
+	qsort(entries, entry_count, sizeof(*entries), _CompareResourcePrefetchEntry);
+	for (size_t i = 0; i < entry_count;) {
+		ResourceList* resourceList = entries[i].resourceList;
+		uint64_t run_start = entries[i].offset;
+		uint64_t run_end = run_start + entries[i].size;
+		size_t j = i + 1;
+		for (; j < entry_count; ++j) {
+			// Blocks shared with the previous entry always join its run
+			_ResourcePrefetchEntry* entry = &entries[j];
+			uint64_t end = umax(run_end, entry->offset + entry->size);
+			bool shared = (entry->resourceListId == entries[j - 1].resourceListId && entry->offset == entries[j - 1].offset);
+			if (!shared && (entry->resourceListId != entries[i].resourceListId || entry->offset > run_end + _RESOURCE_PREFETCH_GAP || end - run_start > _RESOURCE_PREFETCH_RUN)) { break; }
+			entry->duplicate = (shared && strcmp(entry->name, entries[j - 1].name) == 0);
+			run_end = end;
+		}
+
+		// Encrypted runs are decrypted in one pass, plain ones are read ahead in one request & used in place
+		uint8_t* scratch = NULL;
+		_ResourceRun run = { 0 };
+		size_t run_len = (size_t)(run_end - run_start);
+		if (resourceList->_resourceEncrypted) {
+			scratch = block_pool_alloc(resourceList->_resourceScratch, run_len);
+			if (scratch && _ReadResourceBytes(resourceList, run_start, run_len, scratch)) {
+				run = (_ResourceRun){ ._buffer = scratch, ._offset = run_start, ._length = run_len };
+			}
+		}
+		else if (resourceList->_resourceFileBuffer && !resourceList->_resourceLooseFiles) {
+			buffer_prefetch(resourceList->_resourceFileBuffer, (size_t)run_start, run_len);
+		}
+		stats.bytes += run_len;
+
+		// Decode the run's blocks in parallel, then move them into the caches on this thread
+		_ResourcePrefetchRun prefetch = { .entries = &entries[i], .run = run._buffer ? &run : NULL };
+		thread_pool_parallel_for(MARS_RESOURCES->_resourceWorkers, j - i, _LoadResourcePrefetchEntry, &prefetch);
+		block_pool_free(resourceList->_resourceScratch, scratch);
+		for (size_t k = i; k < j; ++k) {
+			_ResourcePrefetchEntry* entry = &entries[k];
+			if (entry->duplicate) {
+				entry->loaded = entries[k - 1].loaded;
+			}
+			else if (entry->loaded && !_InsertResourceCache(resourceList, entry->type, (char*)entry->name, entry->hash, &entry->result)) {
+				_DestroyResourceValue(entry->type, &entry->result);
+				entry->loaded = false;
+			}
+			if (entry->loaded) { stats.loaded++; }
+			else { stats.failed++; }
+		}
+		i = j;
+	}
+	MARS_FREE(entries);
+	stats.seconds = _mars_time_seconds() - start;
+	MARS_DEBUG_LOG("Prefetched %zu resources (%llu bytes) in %.3f ms", stats.loaded, (unsigned long long)stats.bytes, stats.seconds * 1000.0);
+	return stats;
+prefetch_resources_fail:
+	MARS_FREE(entries);
+	stats.failed = _count;
+	stats.seconds = _mars_time_seconds() - start;
+	return stats;
+}
+
+ResourceRequestStatus PollResourceRequest(resourceRequest_id _request) {
+	void* data = unordered_map_find(MARS_RESOURCES->_resourceRequests, _request);
+	if (!data) { return RESOURCE_REQUEST_INVALID; }
+	ResourceRequest* request = *(ResourceRequest**)(data);
+	mars_mutex_lock(&MARS_RESOURCES->_resourceRequestLock);
+	ResourceRequestStatus status = request->_status;
+	mars_mutex_unlock(&MARS_RESOURCES->_resourceRequestLock);
+	return status;
+}
+
+void* WaitResourceRequest(resourceRequest_id _request) {
+	MARS_RETURN_CLEAR;
+	void* data = unordered_map_find(MARS_RESOURCES->_resourceRequests, _request);
+	if (!data) {
+		MARS_DEBUG_WARN("Invalid resource request ID (%d)!", (int)_request);
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_ID);
+		return NULL;
+	}
+	ResourceRequest* request = *(ResourceRequest**)(data);
+	mars_mutex_lock(&MARS_RESOURCES->_resourceRequestLock);
+	while (request->_status == RESOURCE_REQUEST_PENDING) {
+		mars_cond_wait(&MARS_RESOURCES->_resourceRequestSignal, &MARS_RESOURCES->_resourceRequestLock);
+	}
+	mars_mutex_unlock(&MARS_RESOURCES->_resourceRequestLock);
+	void* resource = _FinalizeResourceRequest(request);
+	if (!resource) { MARS_RETURN_SET(MARS_RETURN_CODE_RESOURCE_FAILURE); }
+	return resource;
+}
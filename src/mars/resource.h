@@ -6,48 +6,252 @@
 */
 #include "mars/common.h"
 
+// Resource file header: "MARS" [0], u16 version [4], u16 flags [6], reserved [8], IV [16], root file table offset [48]
+// With a password, everything from the root file table offset on is AES-256-CBC encrypted & decrypted as it is read
+#define MARS_RESOURCE_VERSION			2		// Version 2 adds data block flags
+#define MARS_RESOURCE_FLAG_HASH64		0x0001	// File tables are keyed with _umap_str_hash instead of the legacy ELF hash
+
+// File table: "MRFT" [0], u32 count [4], u32 capacity [8], control bytes [12], entries (name [0], u64 offset [32])
+#define MARS_RESOURCE_NAME_SIZE			32
+#define MARS_RESOURCE_ENTRY_SIZE		40
+#define MARS_RESOURCE_MAX_DEPTH			16
+
+// Data block: signature [0], u32 crc [4], u64 next [8], u64 prev [16], u64 compressed size [24], u64 uncompressed size [32], u32 flags [40], reserved [44], data [80]
+// Chunked data: u32 chunk count [0], u32 chunk size [4], u32 compressed size of each chunk [8], then the chunks back to back
+// Each chunk is compressed on its own (or stored, if its compressed size equals its uncompressed size) so they can be decompressed in parallel
+#define MARS_RESOURCE_BLOCK_FLAG_CHUNKED	0x0001
+
+// Data block types: "MTXT" text, "MDAT" binary data, "MIMG" image file (decoded when loaded), "MTEX" pre-decoded texture
+// Texture blocks add u32 format [48], u32 width [52], u32 height [56], u32 mip levels [60] to the header, & their data holds
+// every mip level from largest to smallest, tightly packed
+
+#ifndef MARS_RESOURCE_SCRATCH_CACHE
+#define MARS_RESOURCE_SCRATCH_CACHE			(64 << 20)	// Bytes of free scratch memory kept for reuse between loads
+#endif
+
+/// @brief Pixel layout of a texture. Stored in resource files, so existing values must never change.
+typedef enum {
+	TEXTURE_FORMAT_UNKNOWN = 0,
+	TEXTURE_FORMAT_R8 = 1,
+	TEXTURE_FORMAT_RG8 = 2,
+	TEXTURE_FORMAT_RGB8 = 3,
+	TEXTURE_FORMAT_RGBA8 = 4,
+	TEXTURE_FORMAT_BC1 = 16,			// 4x4 blocks of 8 bytes
+	TEXTURE_FORMAT_BC2 = 17,			// 4x4 blocks of 16 bytes
+	TEXTURE_FORMAT_BC3 = 18,			// 4x4 blocks of 16 bytes
+	TEXTURE_FORMAT_BC4 = 19,			// 4x4 blocks of 8 bytes
+	TEXTURE_FORMAT_BC5 = 20,			// 4x4 blocks of 16 bytes
+	TEXTURE_FORMAT_BC6H = 21,			// 4x4 blocks of 16 bytes
+	TEXTURE_FORMAT_BC7 = 22,			// 4x4 blocks of 16 bytes
+	TEXTURE_FORMAT_ASTC_4X4 = 32,		// 16 byte blocks
+	TEXTURE_FORMAT_ASTC_5X5 = 33,
+	TEXTURE_FORMAT_ASTC_6X6 = 34,
+	TEXTURE_FORMAT_ASTC_8X8 = 35
+} TextureFormat;
+
+// Textures loaded from texture blocks may be views into the resource file, in which case data is only valid while the file is loaded
 typedef struct {
-	uint8_t* data;
+	uint8_t* data;						// Every mip level from largest to smallest
 	unsigned int width;
 	unsigned int height;
 	unsigned int channels;
+	TextureFormat format;
+	unsigned int mipLevels;
+	size_t size;						// Bytes in data
+	bool _view;
 } Texture2D;
 
+// Text & data buffers may be views into the resource file, in which case data is not NULL-terminated & only valid while the file is loaded
 typedef struct {
 	char* data;
 	size_t size;
+	bool _view;
 } TextBuffer;
 
 typedef struct {
 	uint8_t* data;
 	size_t size;
+	bool _view;
 } DataBuffer;
 
+typedef enum {
+	_RESOURCE_TYPE_TEXT = 0,
+	_RESOURCE_TYPE_DATA,
+	_RESOURCE_TYPE_TEXTURE_2D
+} _ResourceType;
+
+typedef union {
+	TextBuffer text;
+	DataBuffer data;
+	Texture2D texture2D;
+} _ResourceValue;
+
+/// @brief Cached resource. The value must stay first, since resources are handed out as pointers to it.
+typedef struct _ResourceCacheEntry {
+	_ResourceValue _value;
+	struct _ResourceCacheEntry* _prev;
+	struct _ResourceCacheEntry* _next;
+	struct _ResourceList* _resourceList;
+	char* _name;
+	_umap_str_hash_t _hash;
+	_ResourceType _type;
+	size_t _bytes;
+	unsigned int _refs;
+	uint64_t _tick;
+	bool _stale;						// Changed on disk while acquired, so it has left its cache & goes once released
+} ResourceCacheEntry;
+
+/// @brief Resource cache counters
+typedef struct {
+	uint64_t hits;						// Lookups served from the cache
+	uint64_t misses;					// Lookups that had to load from the resource file
+	uint64_t evictions;					// Resources dropped to stay within budget
+	size_t residentBytes;				// Bytes owned by cached resources (views into the resource file are free)
+	size_t pinnedBytes;					// Resident bytes held by acquired resources
+	size_t budget;						// Byte budget (0 if unlimited)
+} ResourceCacheStats;
+
+typedef _MARS_ID_TYPE resourceList_id;
+
+/// @brief Mounted resource list
+typedef struct {
+	resourceList_id _resourceList;
+	int _priority;
+} _ResourceMount;
+
+/// @brief Merged index entry, pointing at the list that provides a mounted path
+typedef struct {
+	struct _ResourceList* _resourceList;
+	resourceList_id _resourceListId;
+	uint64_t _offset;
+} _ResourceMountEntry;
+
 typedef struct {
 	unordered_map_t* _resourceLists;
+	vector_t* _resourceMounts;					// Mounted lists, lowest priority first
+	unordered_map_str_t* _resourceMountIndex;	// Every mounted path & the list providing it
+	unordered_map_t* _resourceRequests;
+	queue_t* _resourceRequestsDone;
+	thread_pool_t* _resourceWorkers;
+	block_pool_t* _resourceScratch;		// Short lived buffers (encrypted blocks, image files) reused between loads
+	size_t _cacheBudget;
+	size_t _cacheBytes;
+	mars_mutex_t _resourceRequestLock;
+	mars_cond_t _resourceRequestSignal;
 } ResourceManager;
 
+/// @brief When data blocks are checked against their CRC
+typedef enum {
+	RESOURCE_VALIDATE_ALWAYS = 0,		// Every time a block is read
+	RESOURCE_VALIDATE_ONCE,				// The first time each block is read
+	RESOURCE_VALIDATE_BACKGROUND,		// Every block on a worker thread after loading, unchecked blocks are checked on first read
+	RESOURCE_VALIDATE_NEVER				// Never, for archives verified elsewhere (e.g. at install time)
+} ResourceValidation;
+
+/// @brief File backing a resource in a loose resource directory
 typedef struct {
+	char* _path;						// File system path (NULL once deleted)
+	buffer_t* _block;					// Data block, built from the file on first read
+	uint32_t _generation;				// Bumped whenever the file changes, so blocks built from older contents are dropped
+} _ResourceLooseFile;
+
+/// @brief Watched directory of a loose resource directory
+typedef struct {
+	int _watch;
+	char* _prefix;						// Resource path of the directory, with a trailing separator
+	char* _path;						// File system path
+} _ResourceWatchDir;
+
+typedef struct _ResourceList {
 	unordered_map_str_t* _cacheText;
 	unordered_map_str_t* _cacheData;
 	unordered_map_str_t* _cacheTexture2D;
 	buffer_t* _resourceFileBuffer;
 	char* _resourceFile;
 	char* _resourcePassword;
+	cipher_t _resourceCipher;			// Only initialized if there is a password
+	uint8_t _resourceIV[CIPHER_BLOCK_SIZE];
+	bool _resourceEncrypted;			// Body is still encrypted in the file buffer & is decrypted as it is read
+	thread_pool_t* _resourceWorkers;	// Manager's worker pool, used to decompress chunked blocks
+	block_pool_t* _resourceScratch;		// Manager's scratch memory pool
+	_umap_str_hash_fn_t _resourceHash;
+	unordered_map_str_t* _resourceIndex;
+	ResourceCacheEntry* _cacheHead;		// Most recently used
+	ResourceCacheEntry* _cacheTail;		// Least recently used
+	ResourceCacheStats _cacheStats;
+	ResourceValidation _validation;
+	uint64_t* _blockOffsets;			// Sorted offsets of every data block
+	uint8_t* _blockState;				// Validation state per block
+	size_t _blockCount;
+	size_t _validationNext;				// Next block for background validation
+	thread_pool_t* _validationWorkers;
+	bool _validationRunning;
+	bool _validationCancel;
+	mars_mutex_t _validationLock;
+	mars_cond_t _validationSignal;
+	vector_t* _resourceLooseFiles;		// Files of a loose resource directory (NULL for resource files)
+	vector_t* _resourceLooseRetired;	// Blocks replaced by reloads, kept until unload since views & readers may still use them
+	mars_mutex_t _resourceLooseLock;
+	int _resourceWatch;					// Change notification handle (-1 if not watching)
+	vector_t* _resourceWatchDirs;
 } ResourceList;
 
 typedef struct {
 	const char* resourceFile;
 	const char* resourcePassword;
+	size_t cacheBudget;					// Byte budget for this list's caches (0 if unlimited)
+	ResourceValidation validation;		// Data block integrity checking policy
+	bool decryptOnLoad;					// Decrypt the whole archive in parallel when loading, instead of as it is read
+	bool hotReload;						// Watch a loose resource directory & reload files as they change (Linux only)
 } ResourceListDesc;
 
-typedef _MARS_ID_TYPE resourceList_id;
+// Resource list ID that resolves paths through every mounted resource file
+#define RESOURCE_LIST_MOUNTED ((resourceList_id)1)
+
+typedef _MARS_ID_TYPE resourceRequest_id;
+
+/// @brief State of an asynchronous resource request
+typedef enum {
+	RESOURCE_REQUEST_INVALID = 0,		// Unknown request, or one that has already been delivered
+	RESOURCE_REQUEST_PENDING,			// Queued or running on a worker thread
+	RESOURCE_REQUEST_COMPLETE,			// Resource is ready
+	RESOURCE_REQUEST_FAILED				// Resource could not be loaded
+} ResourceRequestStatus;
+
+/// @brief Completion callback, called from UpdateGame. The resource is NULL if the request failed, & may be evicted after the callback returns unless it is acquired.
+typedef void (*ResourceCallback)(resourceRequest_id _request, void* _resource, void* _userData);
+
+/// @brief Results of a batch prefetch
+typedef struct {
+	size_t loaded;						// Resources added to the caches
+	size_t cached;						// Resources that were already cached
+	size_t failed;						// Resources that could not be found or loaded
+	uint64_t bytes;						// Bytes read from the resource files, including gaps between merged blocks
+	double seconds;						// Wall time for the whole batch
+} ResourcePrefetchStats;
+
+typedef struct {
+	ResourceManager* _resourceManager;
+	ResourceList* _resourceList;
+	resourceList_id _resourceListId;
+	resourceRequest_id _id;
+	_ResourceType _type;
+	char* _name;
+	_umap_str_hash_t _hash;
+	uint64_t _offset;
+	ResourceCallback _callback;
+	void* _userData;
+	ResourceRequestStatus _status;
+	bool _finalized;
+	ResourceCacheEntry* _entry;			// Cached resource, pinned until the request is delivered
+	_ResourceValue _result;
+} ResourceRequest;
 
 ResourceManager* _CreateResourceManager();
 
 void _DestroyResourceManager(ResourceManager* _resourceManager);
 
-ResourceList* _CreateResourceList(ResourceListDesc _desc);
+ResourceList* _CreateResourceList(ResourceListDesc _desc, ResourceManager* _resourceManager);
 
 void _DestroyResourceList(ResourceList* _resourceList);
 
@@ -57,19 +261,195 @@ void _DestroyResourceData(DataBuffer* _data);
 
 void _DestroyResourceTexture2D(Texture2D* _texture);
 
-uint64_t _SeekResourceInBuffer(buffer_t* _resourceBuffer, char* _rsc);
+void _DestroyResourceValue(_ResourceType _type, _ResourceValue* _value);
+
+bool _GetResourceFileTable(buffer_t* _resourceBuffer, uint64_t _offset, uint32_t* _capacity);
+
+bool _ReadResourceBytes(ResourceList* _resourceList, uint64_t _offset, size_t _length, void* _dest);
+
+bool _ReadResourceUInt(ResourceList* _resourceList, uint64_t _offset, size_t _size, uint64_t* _val);
+
+bool _IndexResourceFileTable(ResourceList* _resourceList, uint64_t _offset, char* _path, size_t _pathLen, unsigned int _depth);
+
+uint64_t _FindResourceOffset(ResourceList* _resourceList, char* _rsc, _umap_str_hash_t _hash);
+
+uint64_t _SeekResourceInBuffer(buffer_t* _resourceBuffer, _umap_str_hash_fn_t _hash, char* _rsc);
+
+bool _DecompressResourceChunks(const char* _source, size_t _sourceLen, char* _dest, size_t _destLen, thread_pool_t* _workers);
 
-char* _GetResourceDataFromBuffer(buffer_t* _resourceBuffer, uint64_t _offset, char* _type, size_t* _len);
+char* _GetResourceDataFromBuffer(const uint8_t* _buffer, size_t _length, uint64_t _offset, char* _type, bool _validate, bool* _view, char* _dest, size_t* _len, thread_pool_t* _workers);
 
+bool _IndexResourceBlocks(ResourceList* _resourceList);
 
+char* _ReadResourceBlock(ResourceList* _resourceList, uint64_t _offset, char* _type, bool _validate, bool* _view, char* _dest, size_t* _len);
+
+char* _AcquireResourceScratch(ResourceList* _resourceList, uint64_t _offset, size_t* _len);
+
+char* _GetResourceBlock(ResourceList* _resourceList, uint64_t _offset, char* _type, bool* _view, char* _dest, size_t* _len);
+
+bool _LoadResourceTexture2D(ResourceList* _resourceList, uint64_t _offset, Texture2D* _texture);
+
+bool _StartResourceValidation(ResourceList* _resourceList, thread_pool_t* _workers);
+
+void _StopResourceValidation(ResourceList* _resourceList);
+
+void _TrimResourceCaches(ResourceManager* _resourceManager, ResourceList* _resourceList, ResourceCacheEntry* _keep);
+
+void _UpdateResourceManager(ResourceManager* _resourceManager);
+
+void _CancelResourceRequests(ResourceManager* _resourceManager, resourceList_id _resourceList);
+
+void _DestroyResourceRequest(ResourceRequest* _request);
+
+ResourceList* _GetResourceList(resourceList_id* _resourceList, char* _name, _umap_str_hash_t _hash, uint64_t* _offset);
+
+bool _AddResourceMountIndex(ResourceManager* _resourceManager, ResourceList* _resourceList, resourceList_id _id);
+
+bool _BuildResourceMountIndex(ResourceManager* _resourceManager);
+
+bool _LoadResourceDirectory(ResourceList* _resourceList, ResourceListDesc _desc);
+
+bool _IndexResourceDirectory(ResourceList* _resourceList, const char* _dir, const char* _prefix);
+
+buffer_t* _GetResourceLooseBlock(ResourceList* _resourceList, uint64_t _offset);
+
+void _InvalidateResource(ResourceManager* _resourceManager, ResourceList* _resourceList, char* _name);
+
+bool _PollResourceDirectory(ResourceList* _resourceList);
+
+
+// A resource file may also be a directory of loose files, for development. Files are named & converted as by
+// PackResourceDirectory when they are first read, & with hotReload, files changed on disk are dropped from the caches
+// & reloaded on their next read, as soon as the next update notices the change
 MARS_API resourceList_id LoadResourceFile(ResourceListDesc _desc);
 
 MARS_API void UnloadResourceFile(resourceList_id _resourceList);
 
+/// @brief Mount a loaded resource file, making its resources available through RESOURCE_LIST_MOUNTED.
+/// Where several mounted files contain the same path, the one with the highest priority provides it (the most recently
+/// mounted on ties), so a patch or DLC archive mounted over the base game only needs to contain what it adds or replaces.
+/// Mounting a file that is already mounted changes its priority.
+/// @param _resourceList Resource list ID
+/// @param _priority Mount priority
+/// @return True if the file was mounted
+MARS_API bool MountResourceFile(resourceList_id _resourceList, int _priority);
+
+/// @brief Remove a resource file from the mounted resources. Unloading a file also unmounts it.
+/// @param _resourceList Resource list ID
+MARS_API void UnmountResourceFile(resourceList_id _resourceList);
+
+/// @brief Get the mounted resource file that provides a path.
+/// @param _name Resource path
+/// @return Resource list ID, or ID_NULL if no mounted file contains the path
+MARS_API resourceList_id GetMountedResourceFile(char* _name);
+
+// Resources returned by the Get functions stay valid until a later load evicts them to stay within a cache budget,
+// use the Acquire functions to pin resources that must outlive other loads. Every function taking a resource list ID
+// also accepts RESOURCE_LIST_MOUNTED, except for the cache budget & statistics functions
 MARS_API TextBuffer* GetResourceText(resourceList_id _resourceList, char* _textName);
 
 MARS_API DataBuffer* GetResourceData(resourceList_id _resourceList, char* _dataName);
 
 MARS_API Texture2D* GetResourceTexture2D(resourceList_id _resourceList, char* _textureName);
 
+/// @brief Get a text resource & pin it in the cache until it is released.
+/// @param _resourceList Resource list ID
+/// @param _textName Resource path
+/// @return Text pointer, or NULL on failure
+MARS_API TextBuffer* AcquireResourceText(resourceList_id _resourceList, char* _textName);
+
+/// @brief Get a data resource & pin it in the cache until it is released.
+/// @param _resourceList Resource list ID
+/// @param _dataName Resource path
+/// @return Data pointer, or NULL on failure
+MARS_API DataBuffer* AcquireResourceData(resourceList_id _resourceList, char* _dataName);
+
+/// @brief Get a texture resource & pin it in the cache until it is released.
+/// @param _resourceList Resource list ID
+/// @param _textureName Resource path
+/// @return Texture pointer, or NULL on failure
+MARS_API Texture2D* AcquireResourceTexture2D(resourceList_id _resourceList, char* _textureName);
+
+/// @brief Decompress a data resource straight into caller memory, bypassing the caches.
+/// @param _resourceList Resource list ID
+/// @param _dataName Resource path
+/// @param _dest Destination (may be NULL to only query the size)
+/// @param _size Capacity of the destination, set to the size of the data (also when the destination is missing or too small)
+/// @return True if the data was written to the destination
+MARS_API bool ReadResourceData(resourceList_id _resourceList, char* _dataName, void* _dest, size_t* _size);
+
+/// @brief Get the number of bytes in one mip level of a texture.
+/// @param _format Texture format
+/// @param _width Level width
+/// @param _height Level height
+/// @return Size in bytes, or 0 if the format is unknown
+MARS_API size_t GetTextureLevelSize(TextureFormat _format, unsigned int _width, unsigned int _height);
+
+/// @brief Get one mip level of a texture.
+/// @param _texture Texture pointer
+/// @param _level Mip level (0 is the full size image)
+/// @param _width Filled with the level width (may be NULL)
+/// @param _height Filled with the level height (may be NULL)
+/// @param _size Filled with the level size in bytes (may be NULL)
+/// @return Level data, or NULL if the level does not exist
+MARS_API uint8_t* GetTexture2DLevel(Texture2D* _texture, unsigned int _level, unsigned int* _width, unsigned int* _height, size_t* _size);
+
+/// @brief Release a resource returned by one of the Acquire functions, allowing it to be evicted once it is no longer pinned.
+/// @param _resource Text, data or texture pointer
+MARS_API void ReleaseResource(void* _resource);
+
+/// @brief Set the byte budget for a resource list's caches, or for all lists combined, evicting least recently used resources to fit.
+/// @param _resourceList Resource list ID, or ID_NULL for the global budget
+/// @param _bytes Byte budget (0 if unlimited)
+MARS_API void SetResourceCacheBudget(resourceList_id _resourceList, size_t _bytes);
+
+/// @brief Get cache counters for a resource list, or summed over all lists.
+/// @param _resourceList Resource list ID, or ID_NULL for the global counters
+/// @return Cache statistics
+MARS_API ResourceCacheStats GetResourceCacheStats(resourceList_id _resourceList);
+
+/// @brief Load a text resource on a worker thread.
+/// @param _resourceList Resource list ID
+/// @param _textName Resource path
+/// @param _callback Function called from UpdateGame once the request finishes (may be NULL)
+/// @param _userData Pointer passed to the callback
+/// @return Request ID, or ID_NULL on failure
+MARS_API resourceRequest_id GetResourceTextAsync(resourceList_id _resourceList, char* _textName, ResourceCallback _callback, void* _userData);
+
+/// @brief Load a data resource on a worker thread.
+/// @param _resourceList Resource list ID
+/// @param _dataName Resource path
+/// @param _callback Function called from UpdateGame once the request finishes (may be NULL)
+/// @param _userData Pointer passed to the callback
+/// @return Request ID, or ID_NULL on failure
+MARS_API resourceRequest_id GetResourceDataAsync(resourceList_id _resourceList, char* _dataName, ResourceCallback _callback, void* _userData);
+
+/// @brief Load & decode a texture resource on a worker thread.
+/// @param _resourceList Resource list ID
+/// @param _textureName Resource path
+/// @param _callback Function called from UpdateGame once the request finishes (may be NULL)
+/// @param _userData Pointer passed to the callback
+/// @return Request ID, or ID_NULL on failure
+MARS_API resourceRequest_id GetResourceTexture2DAsync(resourceList_id _resourceList, char* _textureName, ResourceCallback _callback, void* _userData);
+
+/// @brief Load a batch of resources into the caches, reading them in file order & decoding them in parallel.
+/// Blocks that lie close together are read as one contiguous run. The resource type of each name is taken from its
+/// data block. Blocks until the whole batch is loaded. Nothing is pinned, so a small cache budget may evict part of
+/// the batch again; acquire resources that must stay resident.
+/// @param _resourceList Resource list ID
+/// @param _names Resource paths
+/// @param _count Number of paths
+/// @return Batch statistics
+MARS_API ResourcePrefetchStats PrefetchResources(resourceList_id _resourceList, const char** _names, size_t _count);
+
+/// @brief Get the state of a resource request without blocking.
+/// @param _request Request ID
+/// @return Request status
+MARS_API ResourceRequestStatus PollResourceRequest(resourceRequest_id _request);
+
+/// @brief Block until a resource request finishes. The request stays valid until its callback is delivered.
+/// @param _request Request ID
+/// @return Cached resource (TextBuffer*, DataBuffer* or Texture2D*), or NULL if the request failed
+MARS_API void* WaitResourceRequest(resourceRequest_id _request);
+
 #endif // MARS_RESOURCE_H
\ No newline at end of file
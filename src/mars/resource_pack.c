@@ -0,0 +1,712 @@
+#include "mars/resource_pack.h"
+#include "external/stb/stb_image.h"
+#include <limits.h>
+#include <ctype.h>
+#if !defined(MARS_OS_WINDOWS)
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#define _PACK_DDS_HEADER_SIZE			128
+#define _PACK_DDS_DX10_HEADER_SIZE		20
+#define _PACK_DDS_FLAG_MIPMAPCOUNT		0x20000
+#define _PACK_ASTC_HEADER_SIZE			16
+#define _PACK_ASTC_MAGIC				0x5CA1AB13
+#define _PACK_ALIGNMENT					16			// Every table & block starts on a cipher block boundary
+#define _PACK_WRITE_BUFFER				(1 << 20)
+
+static uint32_t _PackGetU32(const uint8_t* _bytes) {
+	return (uint32_t)_bytes[0] | ((uint32_t)_bytes[1] << 8) | ((uint32_t)_bytes[2] << 16) | ((uint32_t)_bytes[3] << 24);
+}
+
+static size_t _PackGetTextureSize(TextureFormat _format, unsigned int _width, unsigned int _height, unsigned int _mipLevels) {
+	size_t size = 0;
+	for (unsigned int level = 0; level < _mipLevels; ++level) {
+		size_t level_size = GetTextureLevelSize(_format, (unsigned int)umax(_width >> level, 1), (unsigned int)umax(_height >> level, 1));
+		if (level_size == 0) { return 0; }
+		size += level_size;
+	}
+	return size;
+}
+
+buffer_t* PackResourceBlock(const char* _type, const uint8_t* _data, size_t _len) {
+	buffer_t* block = buffer_create_size(80 + _len);
+	if (!block) { return NULL; }
+	block->_length = 80 + _len;
+	memset(block->_buffer, 0, 80);
+	memcpy(&block->_buffer[0], _type, 4);
+	buffer_set_u32(block, 4, CRC32Calculate(_data, _len, 0));
+	buffer_set_u64(block, 24, (uint64_t)_len);
+	buffer_set_u64(block, 32, (uint64_t)_len);
+	memcpy(&block->_buffer[80], _data, _len);
+	return block;
+}
+
+buffer_t* PackResourceTexture2DLevels(TextureFormat _format, unsigned int _width, unsigned int _height, unsigned int _mipLevels, const uint8_t* _data, size_t _len) {
+	if (_width == 0 || _height == 0 || _mipLevels == 0 || _mipLevels > 32 || (umax(_width, _height) >> (_mipLevels - 1)) == 0) {
+		MARS_DEBUG_WARN("Invalid texture dimensions (%ux%u, %u levels)!", _width, _height, _mipLevels);
+		return NULL;
+	}
+	size_t size = _PackGetTextureSize(_format, _width, _height, _mipLevels);
+	if (size == 0 || size != _len) {
+		MARS_DEBUG_WARN("Texture data does not match its format (%zu bytes, expected %zu)!", _len, size);
+		return NULL;
+	}
+	buffer_t* block = PackResourceBlock("MTEX", _data, _len);
+	if (!block) { return NULL; }
+	buffer_set_u32(block, 48, (uint32_t)_format);
+	buffer_set_u32(block, 52, _width);
+	buffer_set_u32(block, 56, _height);
+	buffer_set_u32(block, 60, _mipLevels);
+	return block;
+}
+
+static TextureFormat _PackGetDDSFormat(const uint8_t* _image, size_t _imageLen, size_t* _dataOffset) {
+	// Legacy four character codes, or a DXGI format in the DX10 extension header
+	const uint8_t* fourcc = &_image[84];
+	*_dataOffset = _PACK_DDS_HEADER_SIZE;
+	if (memcmp(fourcc, "DXT1", 4) == 0) { return TEXTURE_FORMAT_BC1; }
+	if (memcmp(fourcc, "DXT2", 4) == 0 || memcmp(fourcc, "DXT3", 4) == 0) { return TEXTURE_FORMAT_BC2; }
+	if (memcmp(fourcc, "DXT4", 4) == 0 || memcmp(fourcc, "DXT5", 4) == 0) { return TEXTURE_FORMAT_BC3; }
+	if (memcmp(fourcc, "ATI1", 4) == 0 || memcmp(fourcc, "BC4U", 4) == 0) { return TEXTURE_FORMAT_BC4; }
+	if (memcmp(fourcc, "ATI2", 4) == 0 || memcmp(fourcc, "BC5U", 4) == 0) { return TEXTURE_FORMAT_BC5; }
+	if (memcmp(fourcc, "DX10", 4) != 0 || _imageLen < _PACK_DDS_HEADER_SIZE + _PACK_DDS_DX10_HEADER_SIZE) { return TEXTURE_FORMAT_UNKNOWN; }
+	*_dataOffset = _PACK_DDS_HEADER_SIZE + _PACK_DDS_DX10_HEADER_SIZE;
+	if (_PackGetU32(&_image[140]) > 1) { return TEXTURE_FORMAT_UNKNOWN; } // Texture arrays
+	switch (_PackGetU32(&_image[128])) {
+		case 70: case 71: case 72: return TEXTURE_FORMAT_BC1;
+		case 73: case 74: case 75: return TEXTURE_FORMAT_BC2;
+		case 76: case 77: case 78: return TEXTURE_FORMAT_BC3;
+		case 79: case 80: case 81: return TEXTURE_FORMAT_BC4;
+		case 82: case 83: case 84: return TEXTURE_FORMAT_BC5;
+		case 94: case 95: case 96: return TEXTURE_FORMAT_BC6H;
+		case 97: case 98: case 99: return TEXTURE_FORMAT_BC7;
+		default: return TEXTURE_FORMAT_UNKNOWN;
+	}
+}
+
+static buffer_t* _PackTexture2DFromDDS(const uint8_t* _image, size_t _imageLen) {
+	size_t offset = 0;
+	TextureFormat format = _PackGetDDSFormat(_image, _imageLen, &offset);
+	if (format == TEXTURE_FORMAT_UNKNOWN) {
+		MARS_DEBUG_WARN("Unsupported DDS pixel format!");
+		return NULL;
+	}
+	unsigned int height = _PackGetU32(&_image[12]);
+	unsigned int width = _PackGetU32(&_image[16]);
+	unsigned int levels = (_PackGetU32(&_image[8]) & _PACK_DDS_FLAG_MIPMAPCOUNT) ? _PackGetU32(&_image[28]) : 1;
+	if (levels == 0) { levels = 1; }
+
+	// Cube maps & volumes store their first face first, so only that is kept
+	size_t size = _PackGetTextureSize(format, width, height, levels);
+	if (size == 0 || size > _imageLen - offset) {
+		MARS_DEBUG_WARN("Truncated DDS file!");
+		return NULL;
+	}
+	return PackResourceTexture2DLevels(format, width, height, levels, &_image[offset], size);
+}
+
+static buffer_t* _PackTexture2DFromASTC(const uint8_t* _image, size_t _imageLen) {
+	TextureFormat format = TEXTURE_FORMAT_UNKNOWN;
+	if (_image[6] == 1 && _image[4] == _image[5]) {
+		switch (_image[4]) {
+			case 4: format = TEXTURE_FORMAT_ASTC_4X4; break;
+			case 5: format = TEXTURE_FORMAT_ASTC_5X5; break;
+			case 6: format = TEXTURE_FORMAT_ASTC_6X6; break;
+			case 8: format = TEXTURE_FORMAT_ASTC_8X8; break;
+		}
+	}
+	if (format == TEXTURE_FORMAT_UNKNOWN) {
+		MARS_DEBUG_WARN("Unsupported ASTC block size (%ux%ux%u)!", (unsigned int)_image[4], (unsigned int)_image[5], (unsigned int)_image[6]);
+		return NULL;
+	}
+	unsigned int width = (unsigned int)_image[7] | ((unsigned int)_image[8] << 8) | ((unsigned int)_image[9] << 16);
+	unsigned int height = (unsigned int)_image[10] | ((unsigned int)_image[11] << 8) | ((unsigned int)_image[12] << 16);
+	size_t size = GetTextureLevelSize(format, width, height);
+	if (size == 0 || size > _imageLen - _PACK_ASTC_HEADER_SIZE) {
+		MARS_DEBUG_WARN("Truncated ASTC file!");
+		return NULL;
+	}
+	return PackResourceTexture2DLevels(format, width, height, 1, &_image[_PACK_ASTC_HEADER_SIZE], size);
+}
+
+static void _PackDownsample(const uint8_t* _src, unsigned int _width, unsigned int _height, unsigned int _channels, uint8_t* _dest) {
+	// 2x2 box filter, repeating the last row or column of odd sized levels
+	unsigned int dest_width = (unsigned int)umax(_width >> 1, 1);
+	unsigned int dest_height = (unsigned int)umax(_height >> 1, 1);
+	for (unsigned int y = 0; y < dest_height; ++y) {
+		unsigned int y0 = (unsigned int)umin(y * 2, _height - 1);
+		unsigned int y1 = (unsigned int)umin(y * 2 + 1, _height - 1);
+		for (unsigned int x = 0; x < dest_width; ++x) {
+			unsigned int x0 = (unsigned int)umin(x * 2, _width - 1);
+			unsigned int x1 = (unsigned int)umin(x * 2 + 1, _width - 1);
+			for (unsigned int c = 0; c < _channels; ++c) {
+				unsigned int sum = _src[((size_t)y0 * _width + x0) * _channels + c] + _src[((size_t)y0 * _width + x1) * _channels + c] +
+					_src[((size_t)y1 * _width + x0) * _channels + c] + _src[((size_t)y1 * _width + x1) * _channels + c];
+				_dest[((size_t)y * dest_width + x) * _channels + c] = (uint8_t)((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+buffer_t* PackResourceTexture2D(const uint8_t* _image, size_t _imageLen, bool _mipmaps) {
+	if (!_image) { return NULL; }
+	if (_imageLen >= _PACK_DDS_HEADER_SIZE && memcmp(_image, "DDS ", 4) == 0) {
+		return _PackTexture2DFromDDS(_image, _imageLen);
+	}
+	if (_imageLen >= _PACK_ASTC_HEADER_SIZE && _PackGetU32(_image) == _PACK_ASTC_MAGIC) {
+		return _PackTexture2DFromASTC(_image, _imageLen);
+	}
+
+	// Everything else is decoded now, instead of every time it is loaded
+	buffer_t* block = NULL;
+	uint8_t* levels = NULL;
+	stbi_uc* pixels = NULL;
+	int width = 0, height = 0, channels = 0;
+	if (_imageLen > INT_MAX) { goto pack_resource_texture_2d_end; }
+	pixels = stbi_load_from_memory(_image, (int)_imageLen, &width, &height, &channels, 0);
+	if (!pixels) {
+		MARS_DEBUG_WARN("Failed to decode image (%s)!", stbi_failure_reason());
+		goto pack_resource_texture_2d_end;
+	}
+	static const TextureFormat formats[] = { TEXTURE_FORMAT_UNKNOWN, TEXTURE_FORMAT_R8, TEXTURE_FORMAT_RG8, TEXTURE_FORMAT_RGB8, TEXTURE_FORMAT_RGBA8 };
+	TextureFormat format = formats[channels];
+	unsigned int level_count = 1;
+	if (_mipmaps) { level_count = 64 - clz64((uint64_t)umax((size_t)width, (size_t)height)); }
+	size_t size = _PackGetTextureSize(format, (unsigned int)width, (unsigned int)height, level_count);
+	levels = MARS_MALLOC(size);
+	if (!levels) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate texture levels!");
+		goto pack_resource_texture_2d_end;
+	}
+
+	// Each level is filtered from the one before it
+	memcpy(levels, pixels, (size_t)width * height * channels);
+	uint8_t* level = levels;
+	for (unsigned int i = 1; i < level_count; ++i) {
+		unsigned int level_width = (unsigned int)umax((size_t)width >> (i - 1), 1);
+		unsigned int level_height = (unsigned int)umax((size_t)height >> (i - 1), 1);
+		uint8_t* next = level + GetTextureLevelSize(format, level_width, level_height);
+		_PackDownsample(level, level_width, level_height, (unsigned int)channels, next);
+		level = next;
+	}
+	block = PackResourceTexture2DLevels(format, (unsigned int)width, (unsigned int)height, level_count, levels, size);
+pack_resource_texture_2d_end:
+	stbi_image_free(pixels);
+	MARS_FREE(levels);
+	return block;
+}
+
+
+//----------------------------------------------------------------------------------
+// Directory packing
+//----------------------------------------------------------------------------------
+
+typedef struct _PackNode {
+	char _name[MARS_RESOURCE_NAME_SIZE + 1];
+	char* _path;						// File system path
+	struct _PackNode* _children;		// Directory contents, sorted by name
+	size_t _childCount;
+	bool _directory;
+	buffer_t* _block;					// Packed data block
+	uint64_t _offset;					// File table or data block offset in the resource file
+} _PackNode;
+
+typedef struct {
+	_PackNode** _files;
+	ResourcePackDesc _desc;
+	thread_pool_t* _workers;
+} _PackFiles;
+
+typedef struct {
+	const char* _source;
+	char* _dest;
+	uint32_t* _sizes;
+	size_t _length;
+	size_t _chunkSize;
+	int _bound;
+} _PackChunks;
+
+typedef struct {
+	FILE* _fp;
+	cipher_t _cipher;
+	uint8_t _iv[CIPHER_BLOCK_SIZE];		// Last ciphertext block written
+	bool _encrypt;
+	bool _failed;
+	size_t _used;
+	uint8_t _buffer[_PACK_WRITE_BUFFER];
+} _PackWriter;
+
+static uint64_t _PackAlign(uint64_t _offset) {
+	return (_offset + _PACK_ALIGNMENT - 1) & ~(uint64_t)(_PACK_ALIGNMENT - 1);
+}
+
+static char* _PackJoinPath(const char* _dir, const char* _name) {
+	size_t dir_len = strlen(_dir);
+	size_t name_len = strlen(_name);
+	char* path = MARS_MALLOC(dir_len + name_len + 2);
+	if (!path) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate path!");
+		return NULL;
+	}
+	memcpy(path, _dir, dir_len);
+	path[dir_len] = '/';
+	memcpy(&path[dir_len + 1], _name, name_len + 1);
+	return path;
+}
+
+static _PackNode* _PackAddNode(_PackNode* _dir, const char* _fileName) {
+	// Resources are looked up without their extension
+	size_t name_len = strlen(_fileName);
+	const char* ext = strrchr(_fileName, '.');
+	if (ext) { name_len = (size_t)(ext - _fileName); }
+	if (name_len == 0 || name_len > MARS_RESOURCE_NAME_SIZE) {
+		MARS_DEBUG_WARN("Resource name (%s) must be 1 to %d characters!", _fileName, MARS_RESOURCE_NAME_SIZE);
+		return NULL;
+	}
+	_PackNode* children = MARS_REALLOC(_dir->_children, (_dir->_childCount + 1) * sizeof(_PackNode));
+	if (!children) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate directory entry!");
+		return NULL;
+	}
+	_dir->_children = children;
+	_PackNode* node = &children[_dir->_childCount];
+	memset(node, 0, sizeof(*node));
+	node->_path = _PackJoinPath(_dir->_path, _fileName);
+	if (!node->_path) { return NULL; }
+	memcpy(node->_name, _fileName, name_len);
+	_dir->_childCount++;
+	return node;
+}
+
+static int _PackCompareNodes(const void* _a, const void* _b) {
+	return strcmp(((const _PackNode*)_a)->_name, ((const _PackNode*)_b)->_name);
+}
+
+static bool _PackScanDirectory(_PackNode* _dir, unsigned int _depth) {
+	if (_depth >= MARS_RESOURCE_MAX_DEPTH) {
+		MARS_DEBUG_WARN("Directory (%s) is nested too deeply!", _dir->_path);
+		return false;
+	}
+
+	// Hidden files (including . & ..) are skipped
+	bool result = true;
+#if defined(MARS_OS_WINDOWS)
+	char* pattern = _PackJoinPath(_dir->_path, "*");
+	if (!pattern) { return false; }
+	WIN32_FIND_DATAA find;
+	HANDLE handle = FindFirstFileA(pattern, &find);
+	MARS_FREE(pattern);
+	if (handle == INVALID_HANDLE_VALUE) {
+		MARS_DEBUG_WARN("Failed to open directory (%s)!", _dir->_path);
+		return false;
+	}
+	do {
+		if (find.cFileName[0] == '.') { continue; }
+		_PackNode* node = _PackAddNode(_dir, find.cFileName);
+		if (!node) { result = false; break; }
+		node->_directory = (find.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+	} while (FindNextFileA(handle, &find));
+	FindClose(handle);
+#else
+	DIR* dir = opendir(_dir->_path);
+	if (!dir) {
+		MARS_DEBUG_WARN("Failed to open directory (%s)!", _dir->_path);
+		return false;
+	}
+	struct dirent* entry = NULL;
+	while ((entry = readdir(dir)) != NULL) {
+		if (entry->d_name[0] == '.') { continue; }
+		_PackNode* node = _PackAddNode(_dir, entry->d_name);
+		struct stat info;
+		if (!node || stat(node->_path, &info) != 0) { result = false; break; }
+		node->_directory = S_ISDIR(info.st_mode);
+	}
+	closedir(dir);
+#endif
+	if (!result) { return false; }
+
+	// Sort entries so the output does not depend on the order the file system lists them in
+	if (_dir->_childCount > 0) {
+		qsort(_dir->_children, _dir->_childCount, sizeof(_PackNode), _PackCompareNodes);
+	}
+	for (size_t i = 0; i < _dir->_childCount; ++i) {
+		if (i > 0 && strcmp(_dir->_children[i - 1]._name, _dir->_children[i]._name) == 0) {
+			MARS_DEBUG_WARN("Duplicate resource name (%s) in (%s)!", _dir->_children[i]._name, _dir->_path);
+			return false;
+		}
+		if (_dir->_children[i]._directory && !_PackScanDirectory(&_dir->_children[i], _depth + 1)) { return false; }
+	}
+	return true;
+}
+
+static void _PackDestroyNode(_PackNode* _node) {
+	for (size_t i = 0; i < _node->_childCount; ++i) {
+		_PackDestroyNode(&_node->_children[i]);
+	}
+	MARS_FREE(_node->_children);
+	MARS_FREE(_node->_path);
+	buffer_destroy(_node->_block);
+}
+
+static size_t _PackCollectNodes(_PackNode* _node, bool _directory, _PackNode** _nodes, size_t _count) {
+	// Depth first in name order, which is also the order everything is written in
+	if (_node->_directory == _directory) {
+		if (_nodes) { _nodes[_count] = _node; }
+		_count++;
+	}
+	for (size_t i = 0; i < _node->_childCount; ++i) {
+		_count = _PackCollectNodes(&_node->_children[i], _directory, _nodes, _count);
+	}
+	return _count;
+}
+
+static bool _PackHasExtension(const char* _path, const char* const* _extensions, size_t _count) {
+	const char* ext = strrchr(_path, '.');
+	if (!ext || strchr(ext, '/')) { return false; }
+	ext++;
+	for (size_t i = 0; i < _count; ++i) {
+		size_t c = 0;
+		while (ext[c] != '\0' && tolower((unsigned char)ext[c]) == _extensions[i][c]) { c++; }
+		if (ext[c] == '\0' && _extensions[i][c] == '\0') { return true; }
+	}
+	return false;
+}
+
+static const char* _PackGetResourceType(const char* _path, bool _rawImages) {
+	static const char* const text[] = { "txt", "ini", "cfg", "json", "xml", "csv", "md", "lua", "glsl", "hlsl", "vert", "frag", "geom", "comp" };
+	static const char* const images[] = { "png", "jpg", "jpeg", "bmp", "tga", "psd", "gif", "hdr", "pic", "pnm", "ppm", "pgm" };
+	static const char* const textures[] = { "dds", "astc" };
+	if (_PackHasExtension(_path, text, sizeof(text) / sizeof(text[0]))) { return "MTXT"; }
+	if (_PackHasExtension(_path, textures, sizeof(textures) / sizeof(textures[0]))) { return "MTEX"; }
+	if (_PackHasExtension(_path, images, sizeof(images) / sizeof(images[0]))) { return (_rawImages) ? "MIMG" : "MTEX"; }
+	return "MDAT";
+}
+
+static bool _PackWorthCompressing(size_t _compressed, size_t _length) {
+	// Stored blocks can be used in place, so compression has to save a meaningful amount
+	return _compressed <= _length - (_length / 8);
+}
+
+static void _PackCompressChunk(void* _arg, size_t _chunk) {
+	_PackChunks* chunks = (_PackChunks*)_arg;
+	size_t offset = _chunk * chunks->_chunkSize;
+	int length = (int)umin(chunks->_chunkSize, chunks->_length - offset);
+	char* dest = &chunks->_dest[_chunk * (size_t)chunks->_bound];
+	int compressed = LZ4_compress_default(&chunks->_source[offset], dest, length, chunks->_bound);
+	if (compressed <= 0 || compressed >= length) {
+		// Chunks that do not shrink are stored, which the reader detects by their matching sizes
+		memcpy(dest, &chunks->_source[offset], (size_t)length);
+		compressed = length;
+	}
+	chunks->_sizes[_chunk] = (uint32_t)compressed;
+}
+
+static buffer_t* _PackCompressBlock(buffer_t* _block, size_t _chunkSize, thread_pool_t* _workers) {
+	// Compress the payload of a stored block, keeping its header, or return the block as is if that does not pay off
+	const char* source = (const char*)&_block->_buffer[80];
+	size_t length = _block->_length - 80;
+	if (length == 0) { return _block; }
+	size_t chunk_count = (length + _chunkSize - 1) / _chunkSize;
+	if (chunk_count > UINT32_MAX / sizeof(uint32_t)) { return _block; }
+	int bound = LZ4_compressBound((int)umin(length, _chunkSize));
+	size_t table_len = (chunk_count > 1) ? 8 + (chunk_count * sizeof(uint32_t)) : 0;
+	buffer_t* block = buffer_create_size(80 + table_len + (chunk_count * (size_t)bound));
+	if (!block) { return _block; }
+	memcpy(block->_buffer, _block->_buffer, 80);
+	char* dest = (char*)&block->_buffer[80];
+
+	// Small blocks are one LZ4 block, larger ones are split into chunks compressed across the pool
+	size_t compressed = 0;
+	if (chunk_count == 1) {
+		int result = LZ4_compress_default(source, dest, (int)length, bound);
+		compressed = (result > 0) ? (size_t)result : length;
+	}
+	else {
+		uint32_t* sizes = (uint32_t*)MARS_MALLOC(chunk_count * sizeof(uint32_t));
+		if (!sizes) {
+			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate chunk sizes!");
+			buffer_destroy(block);
+			return _block;
+		}
+		_PackChunks chunks = { source, &dest[table_len], sizes, length, _chunkSize, bound };
+		thread_pool_parallel_for(_workers, chunk_count, _PackCompressChunk, &chunks);
+
+		// Close the gaps between chunks
+		buffer_set_u32(block, 80, (uint32_t)chunk_count);
+		buffer_set_u32(block, 84, (uint32_t)_chunkSize);
+		compressed = table_len;
+		for (size_t i = 0; i < chunk_count; ++i) {
+			buffer_set_u32(block, 88 + (i * sizeof(uint32_t)), sizes[i]);
+			memmove(&dest[compressed], &dest[table_len + (i * (size_t)bound)], sizes[i]);
+			compressed += sizes[i];
+		}
+		MARS_FREE(sizes);
+		buffer_set_u32(block, 40, buffer_get_u32(block, 40) | MARS_RESOURCE_BLOCK_FLAG_CHUNKED);
+	}
+	if (!_PackWorthCompressing(compressed, length)) {
+		buffer_destroy(block);
+		return _block;
+	}
+	buffer_set_u64(block, 24, (uint64_t)compressed);
+	block->_length = 80 + compressed;
+	buffer_destroy(_block);
+	return block;
+}
+
+buffer_t* _PackResourceFile(const char* _path, bool _rawImages, bool _mipmaps) {
+	FILE* fp = fopen(_path, "rb");
+	if (!fp) {
+		MARS_DEBUG_WARN("Failed to open file (%s)!", _path);
+		return NULL;
+	}
+	buffer_t* contents = buffer_file_read(fp, 0);
+	fclose(fp);
+	if (!contents) {
+		MARS_DEBUG_WARN("Failed to read file (%s)!", _path);
+		return NULL;
+	}
+	const char* type = _PackGetResourceType(_path, _rawImages);
+	buffer_t* block = (memcmp(type, "MTEX", 4) == 0) ?
+		PackResourceTexture2D(contents->_buffer, contents->_length, _mipmaps) :
+		PackResourceBlock(type, contents->_buffer, contents->_length);
+	buffer_destroy(contents);
+	if (!block) { MARS_DEBUG_WARN("Failed to pack file (%s)!", _path); }
+	return block;
+}
+
+static void _PackFile(void* _arg, size_t _index) {
+	_PackFiles* files = (_PackFiles*)_arg;
+	_PackNode* node = files->_files[_index];
+	buffer_t* block = _PackResourceFile(node->_path, files->_desc.rawImages, files->_desc.mipmaps);
+	if (!block) { return; }
+	node->_block = _PackCompressBlock(block, files->_desc.chunkSize, files->_workers);
+}
+
+static uint32_t _PackGetTableCapacity(size_t _count) {
+	// Same load limit as unordered_map_str, so lookups probe about as far
+	uint32_t capacity = 8;
+	while ((float)_count / (float)capacity >= _UMAP_STR_DEFAULT_LOAD) { capacity <<= 1; }
+	return capacity;
+}
+
+static size_t _PackGetTableSize(const _PackNode* _dir) {
+	return 12 + ((size_t)_PackGetTableCapacity(_dir->_childCount) * (MARS_RESOURCE_ENTRY_SIZE + 1));
+}
+
+static buffer_t* _PackBuildTable(const _PackNode* _dir) {
+	uint32_t capacity = _PackGetTableCapacity(_dir->_childCount);
+	size_t size = (size_t)_PackAlign(_PackGetTableSize(_dir));
+	buffer_t* table = buffer_create_size(size);
+	if (!table) { return NULL; }
+	table->_length = size;
+	memset(table->_buffer, 0, size);
+	memcpy(table->_buffer, "MRFT", 4);
+	buffer_set_u32(table, 4, (uint32_t)_dir->_childCount);
+	buffer_set_u32(table, 8, capacity);
+	memset(&table->_buffer[12], _UMAP_STR_EMPTY, capacity);
+	for (size_t i = 0; i < _dir->_childCount; ++i) {
+		const _PackNode* child = &_dir->_children[i];
+		_umap_str_hash_t h = _umap_str_hash((char*)child->_name);
+		size_t pos = _umap_str_h1(h) & (capacity - 1);
+		while (table->_buffer[12 + pos] != _UMAP_STR_EMPTY) { pos = (pos + 1) & (capacity - 1); }
+		table->_buffer[12 + pos] = (uint8_t)_umap_str_h2(h);
+		size_t entry = 12 + capacity + (pos * MARS_RESOURCE_ENTRY_SIZE);
+		memcpy(&table->_buffer[entry], child->_name, strlen(child->_name));
+		buffer_set_u64(table, entry + MARS_RESOURCE_NAME_SIZE, child->_offset);
+	}
+	return table;
+}
+
+static void _PackFlush(_PackWriter* _writer) {
+	if (_writer->_used == 0) { return; }
+	if (_writer->_encrypt) { cipher_cbc_encrypt(&_writer->_cipher, _writer->_iv, _writer->_buffer, _writer->_used); }
+	if (fwrite(_writer->_buffer, 1, _writer->_used, _writer->_fp) != _writer->_used) { _writer->_failed = true; }
+	_writer->_used = 0;
+}
+
+static void _PackWrite(_PackWriter* _writer, const uint8_t* _data, size_t _length) {
+	// Stage everything so encryption always sees whole cipher blocks
+	while (_length > 0) {
+		size_t n = umin(_length, _PACK_WRITE_BUFFER - _writer->_used);
+		if (_data) { memcpy(&_writer->_buffer[_writer->_used], _data, n); _data += n; }
+		else { memset(&_writer->_buffer[_writer->_used], 0, n); }
+		_writer->_used += n;
+		_length -= n;
+		if (_writer->_used == _PACK_WRITE_BUFFER) { _PackFlush(_writer); }
+	}
+}
+
+static void _PackDeriveIV(uint64_t _seed, uint8_t* _iv) {
+	// The IV comes from the contents so output stays reproducible, & has no zero bytes since the loader reads it as a string
+	size_t i = 0;
+	while (i < CIPHER_BLOCK_SIZE) {
+		_seed += 0x9E3779B97F4A7C15ull;
+		uint64_t z = _seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		z ^= z >> 31;
+		for (size_t b = 0; b < 8 && i < CIPHER_BLOCK_SIZE; ++b) {
+			uint8_t byte = (uint8_t)(z >> (b * 8));
+			if (byte != 0) { _iv[i++] = byte; }
+		}
+	}
+}
+
+bool PackResourceDirectory(ResourcePackDesc _desc) {
+	bool result = false;
+	_PackNode root = { 0 };
+	_PackNode** files = NULL;
+	_PackNode** dirs = NULL;
+	_PackWriter* writer = NULL;
+	buffer_t* table = NULL;
+	thread_pool_t* workers = NULL;
+	if (!_desc.inputDir || !_desc.outputFile) {
+		MARS_RETURN_SET(MARS_RETURN_CODE_INVALID_PARAMETER);
+		return false;
+	}
+	if (_desc.chunkSize == 0) { _desc.chunkSize = MARS_PACK_CHUNK_SIZE; }
+	_desc.chunkSize = umin(_desc.chunkSize, (size_t)LZ4_MAX_INPUT_SIZE);
+
+	// Gather the tree
+	root._directory = true;
+	root._path = _PackJoinPath(_desc.inputDir, "");
+	if (!root._path) { goto pack_resource_directory_end; }
+	root._path[strlen(root._path) - 1] = '\0';
+	if (!_PackScanDirectory(&root, 0)) {
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+		goto pack_resource_directory_end;
+	}
+	size_t file_count = _PackCollectNodes(&root, false, NULL, 0);
+	size_t dir_count = _PackCollectNodes(&root, true, NULL, 0);
+	files = MARS_MALLOC((file_count + 1) * sizeof(_PackNode*));	// Never zero sized, empty trees are valid
+	dirs = MARS_MALLOC(dir_count * sizeof(_PackNode*));
+	if (!files || !dirs) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate file list!");
+		goto pack_resource_directory_end;
+	}
+	_PackCollectNodes(&root, false, files, 0);
+	_PackCollectNodes(&root, true, dirs, 0);
+
+	// Convert & compress every file, large files also split their chunks across the pool
+	workers = thread_pool_create(_desc.threadCount);
+	_PackFiles pack = { files, _desc, workers };
+	thread_pool_parallel_for(workers, file_count, _PackFile, &pack);
+	for (size_t i = 0; i < file_count; ++i) {
+		if (!files[i]->_block) {
+			MARS_RETURN_SET(MARS_RETURN_CODE_RESOURCE_FAILURE);
+			goto pack_resource_directory_end;
+		}
+	}
+
+	// File tables come right after the header, then data blocks in path order
+	uint64_t offset = 64;
+	for (size_t i = 0; i < dir_count; ++i) {
+		dirs[i]->_offset = offset;
+		offset += _PackAlign(_PackGetTableSize(dirs[i]));
+	}
+	uint32_t crc = 0;
+	for (size_t i = 0; i < file_count; ++i) {
+		files[i]->_offset = offset;
+		offset += _PackAlign(files[i]->_block->_length);
+		crc = CRC32Calculate(files[i]->_block->_buffer, files[i]->_block->_length, crc);
+	}
+
+	// Write the header in the clear, & everything after it through the writer
+	writer = MARS_CALLOC(1, sizeof(_PackWriter));
+	if (!writer) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate pack writer!");
+		goto pack_resource_directory_end;
+	}
+	uint8_t header[48] = { 'M', 'A', 'R', 'S' };
+	header[4] = (uint8_t)(MARS_RESOURCE_VERSION & 0xFF);
+	header[5] = (uint8_t)(MARS_RESOURCE_VERSION >> 8);
+	header[6] = (uint8_t)(MARS_RESOURCE_FLAG_HASH64 & 0xFF);
+	header[7] = (uint8_t)(MARS_RESOURCE_FLAG_HASH64 >> 8);
+	if (_desc.password) {
+		uint8_t key[CIPHER_KEY_SIZE] = { 0 };
+		memcpy(key, _desc.password, umin(strlen(_desc.password), CIPHER_KEY_SIZE));
+		_PackDeriveIV(((uint64_t)crc << 32) ^ offset, &header[16]);
+		cipher_init(&writer->_cipher, key);
+		memcpy(writer->_iv, &header[16], CIPHER_BLOCK_SIZE);
+		writer->_encrypt = true;
+	}
+	writer->_fp = fopen(_desc.outputFile, "wb");
+	if (!writer->_fp) {
+		MARS_DEBUG_WARN("Failed to open output file (%s)!", _desc.outputFile);
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+		goto pack_resource_directory_end;
+	}
+	if (fwrite(header, 1, sizeof(header), writer->_fp) != sizeof(header)) { writer->_failed = true; }
+	uint8_t root_offset[16] = { 0 };
+	for (size_t i = 0; i < 8; ++i) { root_offset[i] = (uint8_t)(root._offset >> (i * 8)); }
+	_PackWrite(writer, root_offset, sizeof(root_offset));
+	for (size_t i = 0; i < dir_count; ++i) {
+		table = _PackBuildTable(dirs[i]);
+		if (!table) {
+			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate file table!");
+			goto pack_resource_directory_end;
+		}
+		_PackWrite(writer, table->_buffer, table->_length);
+		buffer_destroy(table);
+		table = NULL;
+	}
+	for (size_t i = 0; i < file_count; ++i) {
+		buffer_t* block = files[i]->_block;
+		_PackWrite(writer, block->_buffer, block->_length);
+		_PackWrite(writer, NULL, (size_t)(_PackAlign(block->_length) - block->_length));
+	}
+	_PackFlush(writer);
+	if (writer->_failed) {
+		MARS_DEBUG_WARN("Failed to write output file (%s)!", _desc.outputFile);
+		MARS_RETURN_SET(MARS_RETURN_CODE_FILESYSTEM_FAILURE);
+		goto pack_resource_directory_end;
+	}
+	MARS_DEBUG_LOG("Packed %zu files (%llu bytes) into (%s)", file_count, (unsigned long long)offset, _desc.outputFile);
+	result = true;
+pack_resource_directory_end:
+	if (writer && writer->_fp) {
+		fclose(writer->_fp);
+		if (!result) { remove(_desc.outputFile); }
+	}
+	thread_pool_destroy(workers);
+	buffer_destroy(table);
+	MARS_FREE(writer);
+	MARS_FREE(files);
+	MARS_FREE(dirs);
+	_PackDestroyNode(&root);
+	return result;
+}
+
+static bool _PackVisitNode(const _PackNode* _dir, char* _path, size_t _pathLen, _PackScanFn _fn, void* _arg) {
+	for (size_t i = 0; i < _dir->_childCount; ++i) {
+		const _PackNode* child = &_dir->_children[i];
+		size_t name_len = strlen(child->_name);
+		memcpy(&_path[_pathLen], child->_name, name_len + 1);
+		if (!_fn(_arg, _path, child->_path, child->_directory)) { return false; }
+		if (child->_directory) {
+			_path[_pathLen + name_len] = '/';
+			if (!_PackVisitNode(child, _path, _pathLen + name_len + 1, _fn, _arg)) { return false; }
+		}
+	}
+	return true;
+}
+
+bool _PackScanResourceFiles(const char* _dir, const char* _prefix, _PackScanFn _fn, void* _arg) {
+	// Nested tables count towards the depth limit, so a subdirectory scan starts as deep as its prefix
+	char path[MARS_RESOURCE_MAX_DEPTH * (MARS_RESOURCE_NAME_SIZE + 1) + 1] = { '\0' };
+	size_t prefix_len = strlen(_prefix);
+	unsigned int depth = 0;
+	for (size_t i = 0; i < prefix_len; ++i) { depth += (_prefix[i] == '/'); }
+	if (prefix_len >= sizeof(path) || depth >= MARS_RESOURCE_MAX_DEPTH) {
+		MARS_DEBUG_WARN("Directory (%s) is nested too deeply!", _dir);
+		return false;
+	}
+	memcpy(path, _prefix, prefix_len + 1);
+	_PackNode root = { 0 };
+	root._directory = true;
+	root._path = _mars_strdup(_dir);
+	bool result = root._path && _PackScanDirectory(&root, depth) && _PackVisitNode(&root, path, prefix_len, _fn, _arg);
+	_PackDestroyNode(&root);
+	return result;
+}
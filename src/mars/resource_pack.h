@@ -0,0 +1,65 @@
+#ifndef MARS_RESOURCE_PACK_H
+#define MARS_RESOURCE_PACK_H
+/**
+ * resource_pack.h
+ * Offline conversion of assets into resource file blocks.
+*/
+#include "mars/common.h"
+#include "mars/resource.h"
+
+#ifndef MARS_PACK_CHUNK_SIZE
+#define MARS_PACK_CHUNK_SIZE			(1 << 20)	// Data larger than this is split into chunks that compress & decompress in parallel
+#endif
+
+typedef struct {
+	const char* inputDir;				// Directory to pack, subdirectories become nested file tables
+	const char* outputFile;				// Resource file to write
+	const char* password;				// Encrypt the resource file with this password (NULL for none)
+	size_t chunkSize;					// Chunk size for large data (0 for MARS_PACK_CHUNK_SIZE)
+	size_t threadCount;					// Worker threads (0 for one less than the hardware thread count)
+	bool rawImages;						// Store images as MIMG files instead of converting them to MTEX textures
+	bool mipmaps;						// Generate mip levels for converted images
+} ResourcePackDesc;
+
+typedef bool (*_PackScanFn)(void* _arg, const char* _resourcePath, const char* _filePath, bool _directory);
+
+buffer_t* _PackResourceFile(const char* _path, bool _rawImages, bool _mipmaps);
+
+bool _PackScanResourceFiles(const char* _dir, const char* _prefix, _PackScanFn _fn, void* _arg);
+
+/// @brief Build a stored (uncompressed) data block. The next & previous block offsets are left zeroed.
+/// @param _type Block signature (e.g. "MDAT")
+/// @param _data Block contents
+/// @param _len Length in bytes
+/// @return Block buffer, or NULL on failure
+MARS_API buffer_t* PackResourceBlock(const char* _type, const uint8_t* _data, size_t _len);
+
+/// @brief Build a texture block from pixels that are already in their final format, such as BCn or ASTC blocks from an external encoder.
+/// @param _format Texture format
+/// @param _width Width of the largest level
+/// @param _height Height of the largest level
+/// @param _mipLevels Number of mip levels in the data
+/// @param _data Every mip level from largest to smallest, tightly packed
+/// @param _len Length in bytes
+/// @return Block buffer, or NULL if the data does not match the format & dimensions
+MARS_API buffer_t* PackResourceTexture2DLevels(TextureFormat _format, unsigned int _width, unsigned int _height, unsigned int _mipLevels, const uint8_t* _data, size_t _len);
+
+/// @brief Convert an image file into a texture block, so it loads without a decode step.
+/// DDS (BC1-BC7) & .astc files keep their compressed blocks & mip levels, anything else stb_image reads is stored as raw pixels.
+/// @param _image Image file contents
+/// @param _imageLen Length in bytes
+/// @param _mipmaps Generate every mip level down to 1x1 for raw pixels
+/// @return Block buffer, or NULL on failure
+MARS_API buffer_t* PackResourceTexture2D(const uint8_t* _image, size_t _imageLen, bool _mipmaps);
+
+/// @brief Pack a directory tree into a resource file.
+/// Files are named without their extension & typed by it: text files become MTXT blocks, images become MTEX textures
+/// (or MIMG files with rawImages) & everything else becomes MDAT blocks. Blocks are LZ4 compressed in parallel, & only
+/// kept compressed when that saves at least an eighth of their size. File tables come first & data blocks follow in
+/// path order, so loading reads the file front to back. The output only depends on the input files & the description,
+/// so packing the same tree twice gives identical files.
+/// @param _desc Pack description
+/// @return True if the resource file was written
+MARS_API bool PackResourceDirectory(ResourcePackDesc _desc);
+
+#endif // MARS_RESOURCE_PACK_H
@@ -0,0 +1,93 @@
+#include "mars/std/block_pool.h"
+#include "mars/std/debug.h"
+
+#define _BLOCK_POOL_UNCACHED SIZE_MAX
+
+static size_t _block_pool_class(size_t _size) {
+	// Round up to the next power of two, classes below the minimum all share the first one
+	unsigned int bits = (_size <= 1) ? 0 : 64 - clz64((uint64_t)_size - 1);
+	if (bits <= BLOCK_POOL_MIN_CLASS) { return 0; }
+	if (bits - BLOCK_POOL_MIN_CLASS >= BLOCK_POOL_CLASS_COUNT) { return _BLOCK_POOL_UNCACHED; }
+	return bits - BLOCK_POOL_MIN_CLASS;
+}
+
+#define _block_pool_class_size(c) ((size_t)1 << ((c) + BLOCK_POOL_MIN_CLASS))
+
+block_pool_t* block_pool_create(size_t _max_cached) {
+	block_pool_t* pool = MARS_CALLOC(1, sizeof(*pool));
+	if (!pool) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate block pool!");
+		return NULL;
+	}
+	mars_mutex_init(&pool->_lock);
+	pool->_max_cached = _max_cached;
+	return pool;
+}
+
+void block_pool_destroy(block_pool_t* _pool) {
+	if (!_pool) { return; }
+	block_pool_trim(_pool);
+	mars_mutex_destroy(&_pool->_lock);
+	MARS_FREE(_pool);
+}
+
+void* block_pool_alloc(block_pool_t* _pool, size_t _size) {
+	size_t cls = _block_pool_class(_size);
+	_block_pool_header_t* header = NULL;
+	if (_pool && cls != _BLOCK_POOL_UNCACHED) {
+		mars_mutex_lock(&_pool->_lock);
+		header = _pool->_free[cls];
+		if (header) {
+			_pool->_free[cls] = header->_next;
+			_pool->_cached_bytes -= _block_pool_class_size(cls);
+		}
+		mars_mutex_unlock(&_pool->_lock);
+	}
+	if (!header) {
+		// Blocks allocated without a pool are sized exactly, since they will never be reused
+		size_t size = (_pool && cls != _BLOCK_POOL_UNCACHED) ? _block_pool_class_size(cls) : _size;
+		if (size > SIZE_MAX - sizeof(*header)) { return NULL; }
+		header = MARS_MALLOC(sizeof(*header) + size);
+		if (!header) {
+			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate pooled block!");
+			return NULL;
+		}
+		header->_class = (_pool) ? cls : _BLOCK_POOL_UNCACHED;
+	}
+	header->_next = NULL;
+	return header + 1;
+}
+
+void block_pool_free(block_pool_t* _pool, void* _block) {
+	if (!_block) { return; }
+	_block_pool_header_t* header = (_block_pool_header_t*)_block - 1;
+	size_t cls = header->_class;
+	if (_pool && cls != _BLOCK_POOL_UNCACHED) {
+		mars_mutex_lock(&_pool->_lock);
+		bool keep = (_pool->_cached_bytes + _block_pool_class_size(cls) <= _pool->_max_cached);
+		if (keep) {
+			header->_next = _pool->_free[cls];
+			_pool->_free[cls] = header;
+			_pool->_cached_bytes += _block_pool_class_size(cls);
+		}
+		mars_mutex_unlock(&_pool->_lock);
+		if (keep) { return; }
+	}
+	MARS_FREE(header);
+}
+
+void block_pool_trim(block_pool_t* _pool) {
+	if (!_pool) { return; }
+	mars_mutex_lock(&_pool->_lock);
+	for (size_t i = 0; i < BLOCK_POOL_CLASS_COUNT; ++i) {
+		_block_pool_header_t* header = _pool->_free[i];
+		while (header) {
+			_block_pool_header_t* next = header->_next;
+			MARS_FREE(header);
+			header = next;
+		}
+		_pool->_free[i] = NULL;
+	}
+	_pool->_cached_bytes = 0;
+	mars_mutex_unlock(&_pool->_lock);
+}
@@ -0,0 +1,57 @@
+#ifndef MARS_STD_BLOCK_POOL_H
+#define MARS_STD_BLOCK_POOL_H
+/**
+ * block_pool.h
+ * Thread safe pool of reusable memory blocks, grouped into power of two size classes.
+*/
+#include "mars/std/utilities.h"
+#include "mars/std/thread.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef BLOCK_POOL_MIN_CLASS
+#define BLOCK_POOL_MIN_CLASS 12		// Smallest class holds 4 KiB
+#endif
+#ifndef BLOCK_POOL_CLASS_COUNT
+#define BLOCK_POOL_CLASS_COUNT 16	// Largest class holds 128 MiB, anything bigger is never cached
+#endif
+
+typedef struct _block_pool_header_t {
+	struct _block_pool_header_t* _next;
+	size_t _class;
+} _block_pool_header_t;
+
+typedef struct {
+	mars_mutex_t _lock;
+	_block_pool_header_t* _free[BLOCK_POOL_CLASS_COUNT];
+	size_t _cached_bytes;
+	size_t _max_cached;
+} block_pool_t;
+
+/// @brief Create a new block pool.
+/// @param _max_cached Most bytes kept in free blocks, blocks released beyond this are deallocated
+/// @return Pool pointer
+block_pool_t* block_pool_create(size_t _max_cached);
+
+/// @brief Deallocate a pool & every free block in it. Blocks still in use must be released with a NULL pool.
+/// @param _pool Pool pointer
+void block_pool_destroy(block_pool_t* _pool);
+
+/// @brief Get a block of at least the given size, reusing a free one from its size class if possible.
+/// @param _pool Pool pointer (if NULL, the block is allocated directly)
+/// @param _size Size in bytes
+/// @return Block pointer, or NULL on failure
+void* block_pool_alloc(block_pool_t* _pool, size_t _size);
+
+/// @brief Return a block to the pool.
+/// @param _pool Pool pointer (if NULL, the block is deallocated)
+/// @param _block Block pointer (may be NULL)
+void block_pool_free(block_pool_t* _pool, void* _block);
+
+/// @brief Deallocate every free block in the pool.
+/// @param _pool Pool pointer
+void block_pool_trim(block_pool_t* _pool);
+
+#endif // MARS_STD_BLOCK_POOL_H
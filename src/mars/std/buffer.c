@@ -1,18 +1,69 @@
+// Expose mmap & fileno when compiling with a strict C standard
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
 #include "mars/std/buffer.h"
 #include "mars/std/debug.h"
+#if defined(MARS_OS_WINDOWS)
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#if !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
 
 buffer_t* _buffer_resize(buffer_t* _buf, size_t _new_capacity) {
 	if (_new_capacity == 0) {
 		size_t c = MARS_NEXT_POW2(_buf->_capacity + 1);
 		_new_capacity = umin(c, BUFFER_MAX_CAPACITY);
 	}
-	buffer_t* new_buffer = buffer_create_size(_new_capacity);
-	memcpy_s(new_buffer->_buffer, _new_capacity, _buf->_buffer, _buf->_length);
-	new_buffer->_length = _buf->_length;
-	MARS_FREE(_buf);
+	if (_new_capacity > BUFFER_MAX_CAPACITY || _new_capacity < _buf->_length) { return NULL; }
+
+	// Mapped buffers are not heap blocks, so their contents get copied into a new buffer
+	if (_buf->_flags & _BUFFER_FLAG_MAPPED) {
+		buffer_t* new_buffer = buffer_create_size(_new_capacity);
+		if (!new_buffer) { return NULL; }
+		memcpy_s(new_buffer->_buffer, _new_capacity, _buf->_buffer, _buf->_length);
+		new_buffer->_length = _buf->_length;
+		buffer_destroy(_buf);
+		return new_buffer;
+	}
+
+	// Reallocate, which can extend the block in place instead of copying it
+	buffer_t* new_buffer = MARS_REALLOC(_buf, offsetof(buffer_t, _buffer) + _new_capacity);
+	if (!new_buffer) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to reallocate buffer_t buffer!");
+		return NULL;
+	}
+	new_buffer->_capacity = _new_capacity;
 	return new_buffer;
 }
 
+bool buffer_reserve(buffer_t** _buf, size_t _capacity) {
+	if (!_buf || !(*_buf)) { return false; }
+	if (_capacity <= (*_buf)->_capacity) { return true; }
+
+	buffer_t* temp = _buffer_resize(*_buf, _capacity);
+	if (!temp) { return false; }
+	(*_buf) = temp;
+	return true;
+}
+
+bool buffer_shrink_to_fit(buffer_t** _buf) {
+	if (!_buf || !(*_buf)) { return false; }
+	if ((*_buf)->_flags & _BUFFER_FLAG_MAPPED) { return true; }
+	size_t capacity = umax((*_buf)->_length, 1);
+	if (capacity >= (*_buf)->_capacity) { return true; }
+
+	buffer_t* temp = _buffer_resize(*_buf, capacity);
+	if (!temp) { return false; }
+	(*_buf) = temp;
+	return true;
+}
+
 buffer_t* buffer_create() {
 	return buffer_create_size(BUFFER_DEFAULT_CAPACITY);
 }
@@ -47,7 +98,103 @@ buffer_t* buffer_file_read(FILE* _fp, size_t _max_size) {
 	return buf;
 }
 
+static size_t _buffer_map_granularity() {
+	// Distance between the start of a mapping & the file contents, the buffer header sits at the end of this region
+#if defined(MARS_OS_WINDOWS)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (size_t)info.dwAllocationGranularity;
+#else
+	return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+buffer_t* buffer_file_map(FILE* _fp, size_t _max_size) {
+	if (!_fp) { return NULL; }
+
+	// Calculate buffer size
+#if defined(MARS_OS_WINDOWS)
+	_fseeki64(_fp, 0LL, SEEK_END);
+	long long sz = _ftelli64(_fp);
+#else
+	fseek(_fp, 0L, SEEK_END);
+	long sz = ftell(_fp);
+#endif
+	if (sz <= 0) { return buffer_file_read(_fp, _max_size); }
+	size_t buffer_size = 0;
+	if (_max_size == 0) { buffer_size = (size_t)(sz); }
+	else { buffer_size = umin(_max_size, (size_t)(sz)); }
+	size_t gran = _buffer_map_granularity();
+	size_t header = offsetof(buffer_t, _buffer);
+	uint8_t* base = NULL;
+
+	// Map the file directly after a private header region so the buffer contents start at file offset 0
+#if defined(MARS_OS_WINDOWS)
+	HANDLE file = (HANDLE)_get_osfhandle(_fileno(_fp));
+	if (file == INVALID_HANDLE_VALUE) { return buffer_file_read(_fp, _max_size); }
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (!mapping) { return buffer_file_read(_fp, _max_size); }
+	for (int attempt = 0; attempt < 8 && !base; ++attempt) {
+		// Find a free range, then claim it (another thread may take it in between, so retry)
+		uint8_t* range = VirtualAlloc(NULL, gran + buffer_size, MEM_RESERVE, PAGE_NOACCESS);
+		if (!range) { break; }
+		VirtualFree(range, 0, MEM_RELEASE);
+		uint8_t* head = VirtualAlloc(range, gran, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		uint8_t* view = MapViewOfFileEx(mapping, FILE_MAP_COPY, 0, 0, buffer_size, range + gran);
+		if (head == range && view == range + gran) { base = range; }
+		else {
+			if (view) { UnmapViewOfFile(view); }
+			if (head) { VirtualFree(head, 0, MEM_RELEASE); }
+		}
+	}
+	CloseHandle(mapping);
+#else
+	base = mmap(NULL, gran + buffer_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED) { base = NULL; }
+	else if (mmap(base + gran, buffer_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fileno(_fp), 0) == MAP_FAILED) {
+		munmap(base, gran + buffer_size);
+		base = NULL;
+	}
+#endif
+	if (!base) {
+		MARS_DEBUG_WARN("Failed to map file, reading it instead!");
+		return buffer_file_read(_fp, _max_size);
+	}
+
+	buffer_t* buf = (buffer_t*)(base + gran - header);
+	buf->_length = buffer_size;
+	buf->_capacity = buffer_size;
+	buf->_flags = _BUFFER_FLAG_MAPPED;
+	return buf;
+}
+
+void buffer_prefetch(buffer_t* _buf, size_t _idx, size_t _size) {
+	if (!_buf || !(_buf->_flags & _BUFFER_FLAG_MAPPED) || _idx >= _buf->_length) { return; }
+	_size = umin(_size, _buf->_length - _idx);
+
+	// Round out to whole pages
+	size_t page = _buffer_map_granularity();
+	uintptr_t start = (uintptr_t)&_buf->_buffer[_idx] & ~(uintptr_t)(page - 1);
+	uintptr_t end = (uintptr_t)&_buf->_buffer[_idx] + _size;
+#if defined(MARS_OS_WINDOWS)
+	WIN32_MEMORY_RANGE_ENTRY range = { (PVOID)start, (SIZE_T)(end - start) };
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+	madvise((void*)start, (size_t)(end - start), MADV_WILLNEED);
+#endif
+}
+
 void buffer_destroy(buffer_t* _buf) {
+	if (_buf && (_buf->_flags & _BUFFER_FLAG_MAPPED)) {
+		uint8_t* base = (uint8_t*)_buf + offsetof(buffer_t, _buffer) - _buffer_map_granularity();
+#if defined(MARS_OS_WINDOWS)
+		UnmapViewOfFile(&_buf->_buffer[0]);
+		VirtualFree(base, 0, MEM_RELEASE);
+#else
+		munmap(base, _buffer_map_granularity() + _buf->_capacity);
+#endif
+		return;
+	}
 	MARS_FREE(_buf);
 }
 
@@ -151,7 +298,7 @@ void buffer_push_u8(buffer_t** _buf, uint8_t _val) {
 	buffer_t* buf = *_buf;
 
 	// Resize buffer
-	while (buf->_length > (buf->_capacity - 1)) {
+	while ((buf->_capacity - buf->_length) < 1) {
 		buffer_t* temp = _buffer_resize(buf, 0);
 		if (!temp) { return; }
 		(*_buf) = temp;
@@ -159,7 +306,6 @@ void buffer_push_u8(buffer_t** _buf, uint8_t _val) {
 	}
 
 	buf->_buffer[buf->_length++] = _val;
-	buf->_length += 1;
 }
 
 void buffer_push_u16(buffer_t** _buf, uint16_t _val) {
@@ -167,7 +313,7 @@ void buffer_push_u16(buffer_t** _buf, uint16_t _val) {
 	buffer_t* buf = *_buf;
 
 	// Resize buffer
-	while (buf->_length > (buf->_capacity - 2)) {
+	while ((buf->_capacity - buf->_length) < 2) {
 		buffer_t* temp = _buffer_resize(buf, 0);
 		if (!temp) { return; }
 		(*_buf) = temp;
@@ -176,7 +322,6 @@ void buffer_push_u16(buffer_t** _buf, uint16_t _val) {
 	
 	buf->_buffer[buf->_length++] = (uint8_t)(_val & 0xFF);
 	buf->_buffer[buf->_length++] = (uint8_t)((_val >> 8) & 0xFF);
-	buf->_length += 2;
 }
 
 void buffer_push_u32(buffer_t** _buf, uint32_t _val) {
@@ -184,7 +329,7 @@ void buffer_push_u32(buffer_t** _buf, uint32_t _val) {
 	buffer_t* buf = *_buf;
 
 	// Resize buffer
-	while (buf->_length > (buf->_capacity - 4)) {
+	while ((buf->_capacity - buf->_length) < 4) {
 		buffer_t* temp = _buffer_resize(buf, 0);
 		if (!temp) { return; }
 		(*_buf) = temp;
@@ -195,7 +340,6 @@ void buffer_push_u32(buffer_t** _buf, uint32_t _val) {
 	buf->_buffer[buf->_length++] = (uint8_t)((_val >> 8) & 0xFF);
 	buf->_buffer[buf->_length++] = (uint8_t)((_val >> 16) & 0xFF);
 	buf->_buffer[buf->_length++] = (uint8_t)((_val >> 24) & 0xFF);
-	buf->_length += 4;
 }
 
 void buffer_push_u64(buffer_t** _buf, uint64_t _val) {
@@ -203,7 +347,7 @@ void buffer_push_u64(buffer_t** _buf, uint64_t _val) {
 	buffer_t* buf = *_buf;
 
 	// Resize buffer
-	while (buf->_length > (buf->_capacity - 8)) {
+	while ((buf->_capacity - buf->_length) < 8) {
 		buffer_t* temp = _buffer_resize(buf, 0);
 		if (!temp) { return; }
 		(*_buf) = temp;
@@ -218,7 +362,6 @@ void buffer_push_u64(buffer_t** _buf, uint64_t _val) {
 	buf->_buffer[buf->_length++] = (uint8_t)((_val >> 40) & 0xFF);
 	buf->_buffer[buf->_length++] = (uint8_t)((_val >> 48) & 0xFF);
 	buf->_buffer[buf->_length++] = (uint8_t)((_val >> 56) & 0xFF);
-	buf->_length += 8;
 }
 
 void buffer_push_str(buffer_t** _buf, char* _str, size_t _max_size) {
@@ -226,7 +369,7 @@ void buffer_push_str(buffer_t** _buf, char* _str, size_t _max_size) {
 	buffer_t* buf = *_buf;
 
 	// Resize buffer
-	while (buf->_length > (buf->_capacity - _max_size)) {
+	while ((buf->_capacity - buf->_length) < _max_size) {
 		buffer_t* temp = _buffer_resize(buf, 0);
 		if (!temp) { return; }
 		(*_buf) = temp;
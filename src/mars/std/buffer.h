@@ -19,9 +19,12 @@
 #define BUFFER_MAX_CAPACITY SIZE_MAX - 1
 #endif
 
+#define _BUFFER_FLAG_MAPPED 0x1
+
 typedef struct {
 	size_t _length;
 	size_t _capacity;
+	size_t _flags;
 	uint8_t _buffer[];
 } buffer_t;
 
@@ -36,13 +39,37 @@ buffer_t* buffer_create();
 /// @return Buffer pointer
 buffer_t* buffer_create_size(size_t _capacity);
 
+/// @brief Grow the byte buffer so it holds at least the given number of bytes without reallocating.
+/// @param _buf Buffer pointer (updated if the buffer moves)
+/// @param _capacity Number of bytes
+/// @return True if the buffer has room for _capacity bytes
+bool buffer_reserve(buffer_t** _buf, size_t _capacity);
+
+/// @brief Shrink the byte buffer's capacity down to its length. Mapped buffers are left as they are.
+/// @param _buf Buffer pointer (updated if the buffer moves)
+/// @return True if the buffer was shrunk (or is already as small as it can be)
+bool buffer_shrink_to_fit(buffer_t** _buf);
+
 /// @brief Read file contents into a byte buffer. Does not handle opening / verifying / closing the file handle.
 /// @param _fp Open file pointer
 /// @param _max_size Max buffer size
 /// @return Buffer pointer
 buffer_t* buffer_file_read(FILE* _fp, size_t _max_size);
 
-/// @brief Deallocate the byte buffer.
+/// @brief Map file contents into a byte buffer without reading them. Pages are loaded on first access, and writes stay private
+/// to the process. Falls back to buffer_file_read if the file cannot be mapped. The file handle may be closed once this returns.
+/// @param _fp Open file pointer
+/// @param _max_size Max buffer size
+/// @return Buffer pointer
+buffer_t* buffer_file_map(FILE* _fp, size_t _max_size);
+
+/// @brief Hint that a range of the buffer will be read soon. Starts paging in mapped buffers, otherwise does nothing.
+/// @param _buf Buffer pointer
+/// @param _idx Index
+/// @param _size Number of bytes
+void buffer_prefetch(buffer_t* _buf, size_t _idx, size_t _size);
+
+/// @brief Deallocate the byte buffer, or unmap it if it was created with buffer_file_map.
 /// @param _buf Buffer pointer
 void buffer_destroy(buffer_t* _buf);
 
@@ -0,0 +1,331 @@
+#include "mars/std/cipher.h"
+#include "mars/std/debug.h"
+#include <string.h>
+#define CBC 1
+#define ECB 0
+#define CTR 0
+#include "external/aes/aes.h"
+
+#if AES_keyExpSize != _CIPHER_SCHEDULE_SIZE
+#error "cipher_t expects tiny-AES to be configured for AES-256"
+#endif
+
+// Hardware AES paths, chosen at runtime by CPU support
+#if defined(MARS_ARCH_X64) && defined(MARS_SIMD_SSE2)
+#define _MARS_CIPHER_AESNI
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#if defined(MARS_CMP_MSVC)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(MARS_ARCH_ARM64) && !defined(MARS_DISABLE_SIMD)
+#define _MARS_CIPHER_ARM
+#include <arm_neon.h>
+#if defined(MARS_OS_WINDOWS)
+#include <windows.h>
+#elif defined(MARS_OS_LINUX)
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+#endif
+#endif
+
+#define _CIPHER_IMPL_SOFTWARE	0
+#define _CIPHER_IMPL_AESNI		1
+#define _CIPHER_IMPL_ARM		2
+
+static bool _cipher_hardware = true;
+
+#define _CIPHER_PARALLEL_CHUNK	(1 << 20)
+
+typedef struct {
+	const cipher_t* _cipher;
+	uint8_t* _data;
+	size_t _length;
+	uint8_t _ivs[];					// IV of every chunk, captured before anything is decrypted in place
+} _cipher_parallel_t;
+
+static void _cipher_cbc_decrypt_software(const cipher_t* _cipher, const uint8_t* _iv, uint8_t* _data, size_t _length) {
+	// tiny-AES keeps the IV in its context, so work on a private copy
+	struct AES_ctx ctx;
+	memcpy(ctx.RoundKey, _cipher->_roundKeys, sizeof(ctx.RoundKey));
+	AES_ctx_set_iv(&ctx, _iv);
+	AES_CBC_decrypt_buffer(&ctx, _data, _length);
+}
+
+static void _cipher_cbc_encrypt_software(const cipher_t* _cipher, uint8_t* _iv, uint8_t* _data, size_t _length) {
+	struct AES_ctx ctx;
+	memcpy(ctx.RoundKey, _cipher->_roundKeys, sizeof(ctx.RoundKey));
+	AES_ctx_set_iv(&ctx, _iv);
+	AES_CBC_encrypt_buffer(&ctx, _data, _length);
+	memcpy(_iv, ctx.Iv, CIPHER_BLOCK_SIZE);
+}
+
+#if defined(_MARS_CIPHER_AESNI)
+
+static bool _cipher_aesni_supported() {
+	unsigned int ecx = 0;
+#if defined(MARS_CMP_MSVC)
+	int info[4];
+	__cpuid(info, 1);
+	ecx = (unsigned int)info[2];
+#else
+	unsigned int eax, ebx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) { return false; }
+#endif
+	return (ecx & (1u << 25)) != 0;
+}
+
+#if defined(MARS_CMP_GCC) || defined(MARS_CMP_CLANG)
+__attribute__((target("sse2,aes")))
+#endif
+static void _cipher_expand_aesni(cipher_t* _cipher) {
+	const __m128i* rk = (const __m128i*)_cipher->_roundKeys;
+	__m128i* dk = (__m128i*)_cipher->_decryptKeys;
+	_mm_storeu_si128(&dk[0], _mm_loadu_si128(&rk[_CIPHER_ROUNDS]));
+	for (int r = 1; r < _CIPHER_ROUNDS; ++r) {
+		_mm_storeu_si128(&dk[r], _mm_aesimc_si128(_mm_loadu_si128(&rk[_CIPHER_ROUNDS - r])));
+	}
+	_mm_storeu_si128(&dk[_CIPHER_ROUNDS], _mm_loadu_si128(&rk[0]));
+}
+
+#if defined(MARS_CMP_GCC) || defined(MARS_CMP_CLANG)
+__attribute__((target("sse2,aes")))
+#endif
+static void _cipher_cbc_decrypt_aesni(const cipher_t* _cipher, const uint8_t* _iv, uint8_t* _data, size_t _length) {
+	__m128i dk[_CIPHER_ROUNDS + 1];
+	for (int r = 0; r <= _CIPHER_ROUNDS; ++r) {
+		dk[r] = _mm_loadu_si128((const __m128i*)&_cipher->_decryptKeys[r * CIPHER_BLOCK_SIZE]);
+	}
+	__m128i prev = _mm_loadu_si128((const __m128i*)_iv);
+	__m128i* block = (__m128i*)_data;
+	size_t count = _length / CIPHER_BLOCK_SIZE;
+
+	// CBC decryption has no dependency between blocks, so keep four in flight to hide aesdec latency
+	for (; count >= 4; count -= 4, block += 4) {
+		__m128i c0 = _mm_loadu_si128(&block[0]);
+		__m128i c1 = _mm_loadu_si128(&block[1]);
+		__m128i c2 = _mm_loadu_si128(&block[2]);
+		__m128i c3 = _mm_loadu_si128(&block[3]);
+		__m128i x0 = _mm_xor_si128(c0, dk[0]);
+		__m128i x1 = _mm_xor_si128(c1, dk[0]);
+		__m128i x2 = _mm_xor_si128(c2, dk[0]);
+		__m128i x3 = _mm_xor_si128(c3, dk[0]);
+		for (int r = 1; r < _CIPHER_ROUNDS; ++r) {
+			x0 = _mm_aesdec_si128(x0, dk[r]);
+			x1 = _mm_aesdec_si128(x1, dk[r]);
+			x2 = _mm_aesdec_si128(x2, dk[r]);
+			x3 = _mm_aesdec_si128(x3, dk[r]);
+		}
+		x0 = _mm_aesdeclast_si128(x0, dk[_CIPHER_ROUNDS]);
+		x1 = _mm_aesdeclast_si128(x1, dk[_CIPHER_ROUNDS]);
+		x2 = _mm_aesdeclast_si128(x2, dk[_CIPHER_ROUNDS]);
+		x3 = _mm_aesdeclast_si128(x3, dk[_CIPHER_ROUNDS]);
+		_mm_storeu_si128(&block[0], _mm_xor_si128(x0, prev));
+		_mm_storeu_si128(&block[1], _mm_xor_si128(x1, c0));
+		_mm_storeu_si128(&block[2], _mm_xor_si128(x2, c1));
+		_mm_storeu_si128(&block[3], _mm_xor_si128(x3, c2));
+		prev = c3;
+	}
+	for (; count > 0; count--, block++) {
+		__m128i c = _mm_loadu_si128(block);
+		__m128i x = _mm_xor_si128(c, dk[0]);
+		for (int r = 1; r < _CIPHER_ROUNDS; ++r) {
+			x = _mm_aesdec_si128(x, dk[r]);
+		}
+		x = _mm_aesdeclast_si128(x, dk[_CIPHER_ROUNDS]);
+		_mm_storeu_si128(block, _mm_xor_si128(x, prev));
+		prev = c;
+	}
+}
+
+#if defined(MARS_CMP_GCC) || defined(MARS_CMP_CLANG)
+__attribute__((target("sse2,aes")))
+#endif
+static void _cipher_cbc_encrypt_aesni(const cipher_t* _cipher, uint8_t* _iv, uint8_t* _data, size_t _length) {
+	__m128i rk[_CIPHER_ROUNDS + 1];
+	for (int r = 0; r <= _CIPHER_ROUNDS; ++r) {
+		rk[r] = _mm_loadu_si128((const __m128i*)&_cipher->_roundKeys[r * CIPHER_BLOCK_SIZE]);
+	}
+	__m128i prev = _mm_loadu_si128((const __m128i*)_iv);
+	__m128i* block = (__m128i*)_data;
+	for (size_t count = _length / CIPHER_BLOCK_SIZE; count > 0; count--, block++) {
+		__m128i x = _mm_xor_si128(_mm_xor_si128(_mm_loadu_si128(block), prev), rk[0]);
+		for (int r = 1; r < _CIPHER_ROUNDS; ++r) {
+			x = _mm_aesenc_si128(x, rk[r]);
+		}
+		prev = _mm_aesenclast_si128(x, rk[_CIPHER_ROUNDS]);
+		_mm_storeu_si128(block, prev);
+	}
+	_mm_storeu_si128((__m128i*)_iv, prev);
+}
+
+#elif defined(_MARS_CIPHER_ARM)
+
+static bool _cipher_arm_supported() {
+#if defined(MARS_OS_WINDOWS)
+	return IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
+#elif defined(MARS_OS_MAC) || defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO)
+	return true;
+#elif defined(MARS_OS_LINUX)
+	return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#else
+	return false;
+#endif
+}
+
+#if defined(MARS_CMP_CLANG)
+__attribute__((target("crypto")))
+#elif defined(MARS_CMP_GCC)
+__attribute__((target("+crypto")))
+#endif
+static void _cipher_expand_arm(cipher_t* _cipher) {
+	const uint8_t* rk = _cipher->_roundKeys;
+	uint8_t* dk = _cipher->_decryptKeys;
+	vst1q_u8(&dk[0], vld1q_u8(&rk[_CIPHER_ROUNDS * CIPHER_BLOCK_SIZE]));
+	for (int r = 1; r < _CIPHER_ROUNDS; ++r) {
+		vst1q_u8(&dk[r * CIPHER_BLOCK_SIZE], vaesimcq_u8(vld1q_u8(&rk[(_CIPHER_ROUNDS - r) * CIPHER_BLOCK_SIZE])));
+	}
+	vst1q_u8(&dk[_CIPHER_ROUNDS * CIPHER_BLOCK_SIZE], vld1q_u8(&rk[0]));
+}
+
+#if defined(MARS_CMP_CLANG)
+__attribute__((target("crypto")))
+#elif defined(MARS_CMP_GCC)
+__attribute__((target("+crypto")))
+#endif
+static void _cipher_cbc_decrypt_arm(const cipher_t* _cipher, const uint8_t* _iv, uint8_t* _data, size_t _length) {
+	// AESD xors the key before the inverse rounds, so the last key is applied separately
+	uint8x16_t dk[_CIPHER_ROUNDS + 1];
+	for (int r = 0; r <= _CIPHER_ROUNDS; ++r) {
+		dk[r] = vld1q_u8(&_cipher->_decryptKeys[r * CIPHER_BLOCK_SIZE]);
+	}
+	uint8x16_t prev = vld1q_u8(_iv);
+	for (size_t count = _length / CIPHER_BLOCK_SIZE; count > 0; count--, _data += CIPHER_BLOCK_SIZE) {
+		uint8x16_t c = vld1q_u8(_data);
+		uint8x16_t x = c;
+		for (int r = 0; r < _CIPHER_ROUNDS - 1; ++r) {
+			x = vaesimcq_u8(vaesdq_u8(x, dk[r]));
+		}
+		x = veorq_u8(vaesdq_u8(x, dk[_CIPHER_ROUNDS - 1]), dk[_CIPHER_ROUNDS]);
+		vst1q_u8(_data, veorq_u8(x, prev));
+		prev = c;
+	}
+}
+
+#if defined(MARS_CMP_CLANG)
+__attribute__((target("crypto")))
+#elif defined(MARS_CMP_GCC)
+__attribute__((target("+crypto")))
+#endif
+static void _cipher_cbc_encrypt_arm(const cipher_t* _cipher, uint8_t* _iv, uint8_t* _data, size_t _length) {
+	uint8x16_t rk[_CIPHER_ROUNDS + 1];
+	for (int r = 0; r <= _CIPHER_ROUNDS; ++r) {
+		rk[r] = vld1q_u8(&_cipher->_roundKeys[r * CIPHER_BLOCK_SIZE]);
+	}
+	uint8x16_t prev = vld1q_u8(_iv);
+	for (size_t count = _length / CIPHER_BLOCK_SIZE; count > 0; count--, _data += CIPHER_BLOCK_SIZE) {
+		uint8x16_t x = veorq_u8(vld1q_u8(_data), prev);
+		for (int r = 0; r < _CIPHER_ROUNDS - 1; ++r) {
+			x = vaesmcq_u8(vaeseq_u8(x, rk[r]));
+		}
+		prev = veorq_u8(vaeseq_u8(x, rk[_CIPHER_ROUNDS - 1]), rk[_CIPHER_ROUNDS]);
+		vst1q_u8(_data, prev);
+	}
+	vst1q_u8(_iv, prev);
+}
+
+#endif
+
+void cipher_init(cipher_t* _cipher, const uint8_t* _key) {
+	struct AES_ctx ctx;
+	AES_init_ctx(&ctx, _key);
+	memcpy(_cipher->_roundKeys, ctx.RoundKey, sizeof(_cipher->_roundKeys));
+	memset(_cipher->_decryptKeys, 0, sizeof(_cipher->_decryptKeys));
+	_cipher->_impl = _CIPHER_IMPL_SOFTWARE;
+#if defined(_MARS_CIPHER_AESNI)
+	if (_cipher_hardware && _cipher_aesni_supported()) {
+		_cipher_expand_aesni(_cipher);
+		_cipher->_impl = _CIPHER_IMPL_AESNI;
+	}
+#elif defined(_MARS_CIPHER_ARM)
+	if (_cipher_hardware && _cipher_arm_supported()) {
+		_cipher_expand_arm(_cipher);
+		_cipher->_impl = _CIPHER_IMPL_ARM;
+	}
+#endif
+}
+
+void cipher_cbc_decrypt(const cipher_t* _cipher, const uint8_t* _iv, uint8_t* _data, size_t _length) {
+	_length -= _length % CIPHER_BLOCK_SIZE;
+	if (_length == 0) { return; }
+	switch (_cipher->_impl) {
+#if defined(_MARS_CIPHER_AESNI)
+		case _CIPHER_IMPL_AESNI: _cipher_cbc_decrypt_aesni(_cipher, _iv, _data, _length); break;
+#elif defined(_MARS_CIPHER_ARM)
+		case _CIPHER_IMPL_ARM: _cipher_cbc_decrypt_arm(_cipher, _iv, _data, _length); break;
+#endif
+		default: _cipher_cbc_decrypt_software(_cipher, _iv, _data, _length); break;
+	}
+}
+
+void cipher_cbc_encrypt(const cipher_t* _cipher, uint8_t* _iv, uint8_t* _data, size_t _length) {
+	_length -= _length % CIPHER_BLOCK_SIZE;
+	if (_length == 0) { return; }
+	switch (_cipher->_impl) {
+#if defined(_MARS_CIPHER_AESNI)
+		case _CIPHER_IMPL_AESNI: _cipher_cbc_encrypt_aesni(_cipher, _iv, _data, _length); break;
+#elif defined(_MARS_CIPHER_ARM)
+		case _CIPHER_IMPL_ARM: _cipher_cbc_encrypt_arm(_cipher, _iv, _data, _length); break;
+#endif
+		default: _cipher_cbc_encrypt_software(_cipher, _iv, _data, _length); break;
+	}
+}
+
+static void _cipher_parallel_chunk(void* _arg, size_t _chunk) {
+	_cipher_parallel_t* ctx = (_cipher_parallel_t*)_arg;
+	size_t offset = _chunk * _CIPHER_PARALLEL_CHUNK;
+	size_t length = (size_t)umin(_CIPHER_PARALLEL_CHUNK, ctx->_length - offset);
+	cipher_cbc_decrypt(ctx->_cipher, &ctx->_ivs[_chunk * CIPHER_BLOCK_SIZE], &ctx->_data[offset], length);
+}
+
+void cipher_cbc_decrypt_parallel(const cipher_t* _cipher, thread_pool_t* _pool, const uint8_t* _iv, uint8_t* _data, size_t _length) {
+	_length -= _length % CIPHER_BLOCK_SIZE;
+	size_t chunkCount = (_length + _CIPHER_PARALLEL_CHUNK - 1) / _CIPHER_PARALLEL_CHUNK;
+	if (!_pool || chunkCount < 2) {
+		cipher_cbc_decrypt(_cipher, _iv, _data, _length);
+		return;
+	}
+	_cipher_parallel_t* ctx = MARS_MALLOC(sizeof(*ctx) + chunkCount * CIPHER_BLOCK_SIZE);
+	if (!ctx) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate parallel decryption state!");
+		cipher_cbc_decrypt(_cipher, _iv, _data, _length);
+		return;
+	}
+	ctx->_cipher = _cipher;
+	ctx->_data = _data;
+	ctx->_length = _length;
+
+	// Each chunk chains from the last ciphertext block of the one before it, which is overwritten once that chunk is decrypted
+	memcpy(&ctx->_ivs[0], _iv, CIPHER_BLOCK_SIZE);
+	for (size_t i = 1; i < chunkCount; ++i) {
+		memcpy(&ctx->_ivs[i * CIPHER_BLOCK_SIZE], &_data[i * _CIPHER_PARALLEL_CHUNK - CIPHER_BLOCK_SIZE], CIPHER_BLOCK_SIZE);
+	}
+	thread_pool_parallel_for(_pool, chunkCount, _cipher_parallel_chunk, ctx);
+	MARS_FREE(ctx);
+}
+
+void cipher_use_hardware(bool _enable) {
+	_cipher_hardware = _enable;
+}
+
+const char* cipher_impl_name(const cipher_t* _cipher) {
+	switch (_cipher->_impl) {
+		case _CIPHER_IMPL_AESNI: return "aesni";
+		case _CIPHER_IMPL_ARM: return "armv8";
+		default: return "software";
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef MARS_STD_CIPHER_H
+#define MARS_STD_CIPHER_H
+/**
+ * cipher.h
+ * AES-256 block encryption & decryption, using AES-NI or the ARMv8 crypto extensions when the CPU supports them.
+*/
+#include "mars/std/platform.h"
+#include "mars/std/utilities.h"
+#include "mars/std/thread.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CIPHER_BLOCK_SIZE 16
+#define CIPHER_KEY_SIZE 32
+
+#define _CIPHER_ROUNDS 14
+#define _CIPHER_SCHEDULE_SIZE ((_CIPHER_ROUNDS + 1) * CIPHER_BLOCK_SIZE)
+
+/// @brief Expanded AES key. Read-only after initialization, so it may be shared between threads.
+typedef struct {
+	uint8_t _roundKeys[_CIPHER_SCHEDULE_SIZE];		// Encryption key schedule
+	uint8_t _decryptKeys[_CIPHER_SCHEDULE_SIZE];		// Equivalent inverse cipher key schedule (hardware paths only)
+	int _impl;
+} cipher_t;
+
+/// @brief Expand a key & pick the fastest implementation for this CPU.
+/// @param _cipher Cipher pointer
+/// @param _key Key bytes (CIPHER_KEY_SIZE)
+void cipher_init(cipher_t* _cipher, const uint8_t* _key);
+
+/// @brief Decrypt CBC ciphertext in place. Any trailing partial block is left untouched.
+/// Since each plaintext block only depends on two ciphertext blocks, any block aligned range of a stream can be
+/// decrypted on its own by passing the ciphertext block before it as the IV.
+/// @param _cipher Cipher pointer
+/// @param _iv Initialization vector, or the ciphertext block preceding _data (CIPHER_BLOCK_SIZE)
+/// @param _data Ciphertext
+/// @param _length Length in bytes
+void cipher_cbc_decrypt(const cipher_t* _cipher, const uint8_t* _iv, uint8_t* _data, size_t _length);
+
+/// @brief Decrypt CBC ciphertext in place, splitting it into chunks shared between the calling thread & a worker pool.
+/// Returns once every chunk is decrypted. Falls back to cipher_cbc_decrypt when there is no pool or too little data to split.
+/// @param _cipher Cipher pointer
+/// @param _pool Worker pool (may be NULL)
+/// @param _iv Initialization vector, or the ciphertext block preceding _data (CIPHER_BLOCK_SIZE)
+/// @param _data Ciphertext
+/// @param _length Length in bytes
+void cipher_cbc_decrypt_parallel(const cipher_t* _cipher, thread_pool_t* _pool, const uint8_t* _iv, uint8_t* _data, size_t _length);
+
+/// @brief Encrypt plaintext in place with CBC chaining. Any trailing partial block is left untouched.
+/// Each block depends on the one before it, so unlike decryption this cannot be split up.
+/// @param _cipher Cipher pointer
+/// @param _iv Initialization vector, replaced with the last ciphertext block so a stream can be encrypted in pieces (CIPHER_BLOCK_SIZE)
+/// @param _data Plaintext
+/// @param _length Length in bytes
+void cipher_cbc_encrypt(const cipher_t* _cipher, uint8_t* _iv, uint8_t* _data, size_t _length);
+
+/// @brief Allow or forbid the hardware implementations for ciphers initialized afterwards, e.g. to compare against the
+/// software path. Existing ciphers keep their implementation.
+/// @param _enable False to always use the software implementation
+void cipher_use_hardware(bool _enable);
+
+/// @brief Get the name of the implementation chosen for a cipher.
+/// @param _cipher Cipher pointer
+/// @return "aesni", "armv8" or "software"
+const char* cipher_impl_name(const cipher_t* _cipher);
+
+#endif // MARS_STD_CIPHER_H
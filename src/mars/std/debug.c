@@ -62,7 +62,7 @@ int _mars_dbg_assert(const char* expr, const char* file, int line, const char* f
 
 #endif // defined(MARS_DEBUG)
 
-unsigned int _mars_g_return_code = MARS_RETURN_CODE_OK;
+MARS_THREAD_LOCAL unsigned int _mars_g_return_code = MARS_RETURN_CODE_OK;
 
 unsigned char _mars_g_error_code_mask = MARS_ERROR_CODE_NONE;
 
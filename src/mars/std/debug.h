@@ -105,7 +105,7 @@ int _mars_dbg_assert(const char* expr, const char* file, int line, const char* f
 #define MARS_RETURN_CODE_FILESYSTEM_FAILURE		9		// Return code for a filesystem related error.
 
 // Global variables
-extern unsigned int _mars_g_return_code;	// Last recorded function return code.
+extern MARS_THREAD_LOCAL unsigned int _mars_g_return_code;	// Last recorded function return code (per thread).
 
 /// @brief Get the last recorded function return code.
 #define MARS_RETURN_CODE _mars_g_return_code
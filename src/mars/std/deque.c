@@ -27,30 +27,63 @@ deque_t* _deque_resize(deque_t* qu, size_t new_capacity) {
 		new_capacity = umin(c, DEQUE_MAX_CAPACITY);
 	}
 	if (new_capacity > DEQUE_MAX_CAPACITY || new_capacity < qu->_length) { return NULL; }
+	size_t buffer_size = _deque_size(qu->_element_size, new_capacity);
+	if (buffer_size == 0) { return NULL; }
+
+	// Elements run from the head to the end of the buffer, then wrap around to the start
+	size_t front = umin(qu->_length, qu->_capacity - qu->_head);
+	if (new_capacity >= qu->_capacity) {
+		// Grow in place if the allocator can, then move the run before the wrap to the end of the larger buffer
+		deque_t* new_qu = MARS_REALLOC(qu, buffer_size);
+		if (!new_qu) {
+			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to reallocate deque buffer!");
+			return NULL;
+		}
+		if (front < new_qu->_length) {
+			size_t new_head = new_capacity - front;
+			memmove(_deque_pos(new_qu, new_head), _deque_pos(new_qu, new_qu->_head), front * new_qu->_element_size);
+			new_qu->_head = new_head;
+		}
+		new_qu->_capacity = new_capacity;
+		new_qu->_tail = (new_qu->_head + new_qu->_length) % new_capacity;
+		return new_qu;
+	}
 
-	// Create new deque & copy data to it
+	// Shrinking may cut off the run at the head, so copy both runs to the start of a new buffer
 	deque_t* new_qu = _deque_factory(qu->_element_size, new_capacity);
 	if (!new_qu) { return NULL; }
-	if (qu->_tail <= qu->_head) {
-		// Queue wraps around circular buffer, copy in two parts
-		size_t _qu_end = (qu->_capacity - qu->_head);
-		size_t dest_size_start = _qu_end * qu->_element_size;
-		size_t dest_size_end = (qu->_length - _qu_end) * qu->_element_size;
-		memcpy_s(_deque_pos(new_qu, 0), dest_size_start, _deque_pos(qu, qu->_head), dest_size_start);
-		memcpy_s(_deque_pos(new_qu, _qu_end), dest_size_end, _deque_pos(qu, 0), dest_size_end);
-	}
-	else {
-		// Queue is contained in circular buffer, one copy will get everything
-		size_t dest_size = qu->_length * qu->_element_size;
-		memcpy_s(new_qu->_buffer, dest_size, _deque_pos(qu, qu->_head), dest_size);
-	}
+	memcpy(_deque_pos(new_qu, 0), _deque_pos(qu, qu->_head), front * qu->_element_size);
+	memcpy(_deque_pos(new_qu, front), _deque_pos(qu, 0), (qu->_length - front) * qu->_element_size);
 	new_qu->_head = 0;
-	new_qu->_tail = qu->_length;
+	new_qu->_tail = qu->_length % new_capacity;
 	new_qu->_length = qu->_length;
 	MARS_FREE(qu);
 	return new_qu;
 }
 
+bool _deque_reserve(deque_t** qu, size_t capacity) {
+	// Error check
+	if (!qu || !(*qu)) { return false; }
+	if (capacity <= (*qu)->_capacity) { return true; }
+
+	deque_t* temp = _deque_resize(*qu, capacity);
+	if (!temp) { return false; }
+	(*qu) = temp;
+	return true;
+}
+
+bool _deque_shrink_to_fit(deque_t** qu) {
+	// Error check
+	if (!qu || !(*qu)) { return false; }
+	size_t capacity = umax((*qu)->_length, 1);
+	if (capacity >= (*qu)->_capacity) { return true; }
+
+	deque_t* temp = _deque_resize(*qu, capacity);
+	if (!temp) { return false; }
+	(*qu) = temp;
+	return true;
+}
+
 void* _deque_insert_front(deque_t** qu, void* data) {
 	// Error check
 	if (!qu || !(*qu)) { return NULL; }
@@ -88,7 +121,7 @@ void* _deque_insert_back(deque_t** qu, void* data) {
 
 	// Append to head
 	_qu->_length++;
-	_qu->_head = (_qu->_head == 0) ? _qu->_capacity : _qu->_head - 1;
+	_qu->_head = (_qu->_head == 0) ? _qu->_capacity - 1 : _qu->_head - 1;
 	void* dest = _deque_pos(_qu, _qu->_head);
 	size_t dest_size = _qu->_element_size;
 	memcpy_s(dest, dest_size, data, dest_size);
@@ -99,9 +132,8 @@ void _deque_remove_front(deque_t* qu, size_t count) {
 	// Error check
 	if (!qu || qu->_length < count) { return; }
 
-	// Decrement tail
-	size_t new_tail = (qu->_tail < count) ? (qu->_capacity - count + qu->_tail) : qu->_tail - count;
-	qu->_tail = (qu->_head <= qu->_tail && new_tail < qu->_head) ? qu->_head : new_tail;
+	// Decrement tail (count is bounded by length, so this can never pass the head)
+	qu->_tail = (qu->_tail + qu->_capacity - count) % qu->_capacity;
 	qu->_length -= count;
 	return;
 }
@@ -110,9 +142,8 @@ void _deque_remove_back(deque_t* qu, size_t count) {
 	// Error check
 	if (!qu || qu->_length < count) { return; }
 
-	// Increment head
-	size_t new_head = (qu->_head + count) % qu->_capacity;
-	qu->_head = (qu->_head <= qu->_tail && new_head > qu->_tail) ? qu->_tail : new_head;
+	// Increment head (count is bounded by length, so this can never pass the tail)
+	qu->_head = (qu->_head + count) % qu->_capacity;
 	qu->_length -= count;
 	return;
 }
\ No newline at end of file
@@ -12,7 +12,7 @@
 #include <string.h>
 
 #ifndef DEQUE_DEFAULT_CAPACITY
-#define DEQUE_DEFAULT_CAPACITY 1ULL
+#define DEQUE_DEFAULT_CAPACITY 8ULL
 #endif
 #ifndef DEQUE_MAX_CAPACITY
 #define DEQUE_MAX_CAPACITY SIZE_MAX - 1
@@ -27,12 +27,12 @@
 
 /// @brief Deallocate a deque.
 /// @param q Dequeue pointer.
-#define deque_destroy(q) free(q)
+#define deque_destroy(q) MARS_FREE(q)
 
 /// @brief Get the front element of the deque.
 /// @param q Dequeue pointer
 /// @return Void data pointer, or NULL if empty
-#define deque_front(q) (void*)((q)->_length > 0 ? _deque_pos(q, (q)->_tail) : NULL)
+#define deque_front(q) (void*)((q)->_length > 0 ? _deque_pos(q, ((q)->_tail + (q)->_capacity - 1) % (q)->_capacity) : NULL)
 
 /// @brief Get the back element of the deque.
 /// @param q Dequeue pointer
@@ -66,7 +66,18 @@
 
 /// @brief Remove all elements from the deque.
 /// @param q Dequeue pointer
-#define deque_clear(q) _deque_remove(q, (q)->_length)
+#define deque_clear(q) _deque_remove_front(q, (q)->_length)
+
+/// @brief Grow the deque so it holds at least the given number of elements without reallocating.
+/// @param q Dequeue pointer
+/// @param n Number of elements
+/// @return True if the deque has room for n elements
+#define deque_reserve(q, n) _deque_reserve(&q, n)
+
+/// @brief Shrink the deque's capacity down to its size.
+/// @param q Dequeue pointer
+/// @return True if the deque was shrunk (or is already as small as it can be)
+#define deque_shrink_to_fit(q) _deque_shrink_to_fit(&q)
 
 /// @brief Get the sze of the deque in memory.
 /// @param q Dequeue pointer
@@ -89,6 +100,10 @@ deque_t* _deque_factory(size_t, size_t);
 
 deque_t* _deque_resize(deque_t*, size_t);
 
+bool _deque_reserve(deque_t**, size_t);
+
+bool _deque_shrink_to_fit(deque_t**);
+
 void* _deque_insert_front(deque_t**, void*);
 
 void* _deque_insert_back(deque_t**, void*);
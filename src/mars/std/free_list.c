@@ -2,9 +2,11 @@
 #include "mars/std/debug.h"
 
 size_t _free_list_buffer_size(size_t element_size, size_t capacity) {
+	if (capacity == 0) { return 0; }
 	size_t c = element_size * capacity;
 	if (c / capacity != element_size) { return 0; }
-	size_t o = ((capacity/8)+1);
+	size_t o = _free_list_word_num(capacity) * sizeof(uint64_t);
+	if (c > SIZE_MAX - o - offsetof(free_list_t, _buffer)) { return 0; }
 	return umax(sizeof(free_list_t), offsetof(free_list_t, _buffer) + c + o);
 }
 
@@ -27,20 +29,17 @@ free_list_t* _free_list_resize(free_list_t* list, size_t new_capacity) {
 		size_t c = MARS_NEXT_POW2(list->_capacity + 1);
 		new_capacity = umin(c, FREE_LIST_MAX_CAPACITY);
 	}
-	if (new_capacity > FREE_LIST_MAX_CAPACITY) { return NULL; }
+	if (new_capacity > FREE_LIST_MAX_CAPACITY || new_capacity < list->_capacity) { return NULL; }
 
 	// Create a new list & copy data over
 	free_list_t* new_list = _free_list_factory(list->_element_size, new_capacity);
 	if (!new_list) { return NULL; }
 
-	size_t bit_dest_size = (list->_capacity / 8) + 1;
-	memcpy_s(&new_list->_buffer[0], bit_dest_size, &list->_buffer[0], bit_dest_size);
+	size_t bit_dest_size = _free_list_word_num(list->_capacity) * sizeof(uint64_t);
+	memcpy_s(_free_list_bits(new_list), bit_dest_size, _free_list_bits(list), bit_dest_size);
 	size_t data_dest_size = list->_capacity * list->_element_size;
 	memcpy_s(_free_list_pos(new_list, 0), data_dest_size, _free_list_pos(list, 0), data_dest_size);
 
-	//size_t dest_size = list->_length * list->_element_size;
-	//memcpy_s(new_list->_buffer, dest_size, list->_buffer, dest_size);
-
 	new_list->_length = list->_length;
 	new_list->_next_free = list->_next_free;
 	MARS_FREE(list);
@@ -51,7 +50,6 @@ void* _free_list_insert(free_list_t** list, size_t* index, void* data) {
 	// Error check
 	if (!list || !(*list)) { goto free_list_insert_fail; }
 	free_list_t* _list = *list;
-	if (_free_list_bit_get(_list, _list->_next_free)) { goto free_list_insert_fail; }
 
 	// Resize container
 	if (_list->_length >= _list->_capacity) {
@@ -60,6 +58,10 @@ void* _free_list_insert(free_list_t** list, size_t* index, void* data) {
 		(*list) = temp;
 		_list = temp;
 	}
+	if (_list->_next_free >= _list->_capacity || _free_list_bit_get(_list, _list->_next_free)) {
+		_list->_next_free = _free_list_scan(_list, 0, false);
+		if (_list->_next_free >= _list->_capacity) { goto free_list_insert_fail; }
+	}
 
 	// Add to empty slot
 	uint8_t* dest = _free_list_pos(_list, _list->_next_free);
@@ -67,35 +69,49 @@ void* _free_list_insert(free_list_t** list, size_t* index, void* data) {
 	memcpy_s(dest, dest_size, data, dest_size);
 	_free_list_bit_set(_list, _list->_next_free);
 	_list->_length++;
-	*index = _list->_next_free;
-
-	// Find the next free slot
-	for(size_t i=_list->_next_free; i<_list->_capacity; ++i) {
-		if (_free_list_bit_get(_list, i) == 0) {
-			_list->_next_free = i;
-			break;
-		}
-	}
+	if (index) { *index = _list->_next_free; }
 
+	// Find the next free slot, or the end of the list if it is full
+	_list->_next_free = (_list->_length < _list->_capacity) ? _free_list_scan(_list, _list->_next_free + 1, false) : _list->_capacity;
 	return (void*)dest;
 free_list_insert_fail:
-	index = NULL;
+	if (index) { *index = SIZE_MAX; }
 	return NULL;
 }
 
 void _free_list_remove(free_list_t* list, size_t index, size_t count) {
 	// Error check
-	if (!list) { return; }
-	if ((index + count) > list->_length) { return; }
+	if (!list || count == 0) { return; }
+	if (index >= list->_capacity || count > list->_capacity - index) { return; }
+
+	// Clear the range a word at a time, only counting elements that were actually in the list
+	uint64_t* bits = _free_list_bits(list);
+	size_t end = index + count;
+	for (size_t w = index >> 6; w <= ((end - 1) >> 6); ++w) {
+		uint64_t mask = ~0ULL;
+		if (w == (index >> 6)) { mask &= ~0ULL << (index & 63); }
+		if (w == ((end - 1) >> 6)) { mask &= ~0ULL >> (63 - ((end - 1) & 63)); }
+		list->_length -= popcount64(bits[w] & mask);
+		bits[w] &= ~mask;
+	}
 
 	// Flag spot as free
 	list->_next_free = umin(list->_next_free, index);
-	for(size_t i=0; i<count; ++i) {
-		_free_list_bit_clr(list, index+i);
-	}
+}
 
-	// Decrement length
-	list->_length -= count;
+size_t _free_list_scan(free_list_t* list, size_t start, bool occupied) {
+	// Find the first slot at or after start that is occupied (or free), a word at a time
+	uint64_t* bits = _free_list_bits(list);
+	size_t words = _free_list_word_num(list->_capacity);
+	size_t w = start >> 6;
+	if (w >= words) { return list->_capacity; }
+	uint64_t flip = occupied ? 0 : ~0ULL;
+	uint64_t word = (bits[w] ^ flip) & (~0ULL << (start & 63));
+	while (!word) {
+		if (++w >= words) { return list->_capacity; }
+		word = bits[w] ^ flip;
+	}
+	return umin((w << 6) + ctz64(word), list->_capacity);
 }
 
 free_list_it_t* _free_list_it(free_list_t* list) {
@@ -121,24 +137,50 @@ free_list_it_t* _free_list_it_next(free_list_it_t* it) {
 	// Error check
 	if (!it) { return NULL; }
 
-	// Find the next valid position in the buffer
+	// Find the next occupied slot, skipping empty words
 	free_list_t* _list = it->_list;
-	do {
-		// Increment index
-		it->index++;
-
-		// Reached the end of the array
-		if (it->index >= _list->_capacity) {
-			break;
-		}
-
-		// Evaluate position
-		if (_free_list_bit_get(_list, it->index)) {
-			it->data = (void*)(_free_list_pos(_list, it->index));
-			return it;
-		}
-	} while(1);
+	it->index = _free_list_scan(_list, it->index + 1, true);
+	if (it->index < _list->_capacity) {
+		it->data = (void*)(_free_list_pos(_list, it->index));
+		return it;
+	}
 
 	MARS_FREE(it);
 	return NULL;
-}
\ No newline at end of file
+}
+
+free_list_range_it_t* _free_list_range_it(free_list_t* list) {
+	// Error check
+	if (!list || list->_length == 0) { return NULL; }
+
+	// Construct iterator
+	size_t buffer_size = sizeof(free_list_range_it_t);
+	free_list_range_it_t* it = MARS_CALLOC(buffer_size, 1);
+	if (!it) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate free_list range iterator!");
+		return NULL;
+	}
+	it->_list = list;
+
+	// Find first run in list
+	it = _free_list_range_it_next(it);
+	return it;
+}
+
+free_list_range_it_t* _free_list_range_it_next(free_list_range_it_t* it) {
+	// Error check
+	if (!it) { return NULL; }
+
+	// The next run starts at the first occupied slot after the current run & ends at the free slot after that
+	free_list_t* _list = it->_list;
+	size_t start = _free_list_scan(_list, it->index + it->count, true);
+	if (start < _list->_capacity) {
+		it->index = start;
+		it->count = _free_list_scan(_list, start + 1, false) - start;
+		it->data = (void*)(_free_list_pos(_list, start));
+		return it;
+	}
+
+	MARS_FREE(it);
+	return NULL;
+}
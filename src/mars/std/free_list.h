@@ -18,11 +18,12 @@
 #define FREE_LIST_MAX_CAPACITY SIZE_MAX - 1
 #endif
 
-#define _free_list_bit_num(l) ((l->_capacity / 8) + 1)
-#define _free_list_bit_set(l, n) (l->_buffer[n/8] |= (1 << (n % 8)))
-#define _free_list_bit_clr(l, n) (l->_buffer[n/8] &= ~(1 << (n % 8)))
-#define _free_list_bit_get(l, n) ((l->_buffer[n/8] >> (n % 8)) & 1)
-#define _free_list_pos(l, i) &(l)->_buffer[_free_list_bit_num(l)] + ((i) * (l)->_element_size)
+#define _free_list_word_num(c) (((c) + 63) / 64)
+#define _free_list_bits(l) ((uint64_t*)&(l)->_buffer[0])
+#define _free_list_bit_set(l, n) (_free_list_bits(l)[(n) >> 6] |= (1ULL << ((n) & 63)))
+#define _free_list_bit_clr(l, n) (_free_list_bits(l)[(n) >> 6] &= ~(1ULL << ((n) & 63)))
+#define _free_list_bit_get(l, n) ((_free_list_bits(l)[(n) >> 6] >> ((n) & 63)) & 1)
+#define _free_list_pos(l, i) &(l)->_buffer[_free_list_word_num((l)->_capacity) * sizeof(uint64_t)] + ((i) * (l)->_element_size)
 
 /// @brief Create a new free list.
 /// @param t List type
@@ -37,7 +38,7 @@
 /// @param l List pointer
 /// @param i Index
 /// @return Void data pointer, or NULL if invalid index
-#define free_list_get(l, i) (void*)((i < (l)->_length && _free_list_bit_get(l, i)) ? _free_list_pos(l, i) : NULL)
+#define free_list_get(l, i) (void*)(((i) < (l)->_capacity && _free_list_bit_get(l, i)) ? _free_list_pos(l, i) : NULL)
 
 /// @brief Get the number of elements in the list.
 /// @param l List pointer
@@ -46,7 +47,7 @@
 
 /// @brief Insert the element at the first free spot in the list.
 /// @param l List pointer
-/// @param i Index pointer (will be set to the index the element was inserted at, or NULL if insertion failed)
+/// @param i Index pointer (will be set to the index the element was inserted at, or SIZE_MAX if insertion failed)
 /// @param d Data pointer
 /// @return Void data pointer to inserted element, or NULL if insertion failed
 #define free_list_insert(l, i, d) _free_list_insert(&l, i, (void*)d)
@@ -58,7 +59,7 @@
 
 /// @brief Remove all elements from the list.
 /// @param l List pointer
-#define free_list_clear(l) _free_list_remove(l, 0, (l)->_length)
+#define free_list_clear(l) _free_list_remove(l, 0, (l)->_capacity)
 
 /// @brief Get the size of the list in memory.
 /// @param l List pointer
@@ -74,6 +75,16 @@
 /// @param i Iterator pointer
 #define free_list_it_next(i) _free_list_it_next(i)
 
+/// @brief Create an iterator over runs of consecutive elements in the list, so they can be processed as arrays.
+/// @param l List pointer
+/// @return Iterator pointer, or NULL if the list is empty
+#define free_list_range_it(l) _free_list_range_it(l)
+
+/// @brief Move the iterator to the next run of consecutive elements.
+/// @param i Iterator pointer
+/// @return Iterator pointer, or NULL once every run has been visited
+#define free_list_range_it_next(i) _free_list_range_it_next(i)
+
 /** Space-efficient list of elements. */
 typedef struct {
 	size_t _length;
@@ -89,6 +100,13 @@ typedef struct {
 	size_t index;
 } free_list_it_t;
 
+typedef struct {
+	free_list_t* _list;
+	void* data;						// First element of the run
+	size_t index;					// Index of the first element
+	size_t count;					// Number of elements in the run
+} free_list_range_it_t;
+
 size_t _free_list_buffer_size(size_t, size_t);
 
 free_list_t* _free_list_factory(size_t, size_t);
@@ -99,8 +117,14 @@ void* _free_list_insert(free_list_t**, size_t*, void*);
 
 void _free_list_remove(free_list_t*, size_t, size_t);
 
+size_t _free_list_scan(free_list_t*, size_t, bool);
+
 free_list_it_t* _free_list_it(free_list_t*);
 
 free_list_it_t* _free_list_it_next(free_list_it_t*);
 
+free_list_range_it_t* _free_list_range_it(free_list_t*);
+
+free_list_range_it_t* _free_list_range_it_next(free_list_range_it_t*);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "mars/std/handle_pool.h"
+#include "mars/std/debug.h"
+
+size_t _handle_pool_buffer_size(size_t element_size, size_t capacity) {
+	if (capacity == 0 || capacity > HANDLE_POOL_MAX_CAPACITY) { return 0; }
+	size_t c = element_size * capacity;
+	if (c / capacity != element_size) { return 0; }
+	size_t o = _handle_pool_data_offset(capacity);
+	if (c > SIZE_MAX - o - offsetof(handle_pool_t, _buffer)) { return 0; }
+	return umax(sizeof(handle_pool_t), offsetof(handle_pool_t, _buffer) + o + c);
+}
+
+handle_pool_t* _handle_pool_factory(size_t element_size, size_t capacity) {
+	size_t buffer_size = _handle_pool_buffer_size(element_size, capacity);
+	if (buffer_size == 0) { return NULL; }
+	handle_pool_t* pool = MARS_CALLOC(buffer_size, 1);
+	if (!pool) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate handle_pool buffer!");
+		return NULL;
+	}
+	pool->_capacity = capacity;
+	pool->_element_size = element_size;
+	return pool;
+}
+
+handle_pool_t* _handle_pool_resize(handle_pool_t* pool, size_t new_capacity) {
+	// Calculate new capacity
+	if (new_capacity == 0) {
+		size_t c = MARS_NEXT_POW2(pool->_capacity + 1);
+		new_capacity = umin(c, HANDLE_POOL_MAX_CAPACITY);
+	}
+	if (new_capacity > HANDLE_POOL_MAX_CAPACITY || new_capacity < pool->_slots) { return NULL; }
+
+	// Create a new pool & copy each block over, since their offsets depend on the capacity
+	handle_pool_t* new_pool = _handle_pool_factory(pool->_element_size, new_capacity);
+	if (!new_pool) { return NULL; }
+	memcpy(_handle_pool_bits(new_pool), _handle_pool_bits(pool), _handle_pool_word_num(pool->_slots) * sizeof(uint64_t));
+	memcpy(_handle_pool_generations(new_pool), _handle_pool_generations(pool), pool->_slots * sizeof(uint32_t));
+	memcpy(_handle_pool_free_stack(new_pool), _handle_pool_free_stack(pool), pool->_free * sizeof(uint32_t));
+	memcpy(_handle_pool_pos(new_pool, 0), _handle_pool_pos(pool, 0), pool->_slots * pool->_element_size);
+
+	new_pool->_length = pool->_length;
+	new_pool->_slots = pool->_slots;
+	new_pool->_free = pool->_free;
+	MARS_FREE(pool);
+	return new_pool;
+}
+
+void* _handle_pool_insert(handle_pool_t** pool, handle_t* handle, void* data) {
+	// Error check
+	if (handle) { *handle = HANDLE_NULL; }
+	if (!pool || !(*pool)) { return NULL; }
+	handle_pool_t* _pool = *pool;
+
+	// Take the most recently freed slot, or the next one that was never used
+	uint32_t slot = 0;
+	if (_pool->_free > 0) {
+		slot = _handle_pool_free_stack(_pool)[--_pool->_free];
+	}
+	else {
+		if (_pool->_slots >= _pool->_capacity) {
+			handle_pool_t* temp = _handle_pool_resize(_pool, 0);
+			if (!temp) { return NULL; }
+			(*pool) = temp;
+			_pool = temp;
+		}
+		slot = _pool->_slots++;
+		_handle_pool_generations(_pool)[slot] = 1;
+	}
+
+	// Fill the slot
+	uint8_t* dest = _handle_pool_pos(_pool, slot);
+	memcpy_s(dest, _pool->_element_size, data, _pool->_element_size);
+	_handle_pool_bits(_pool)[slot >> 6] |= (1ULL << (slot & 63));
+	_pool->_length++;
+	if (handle) { *handle = _handle_pool_make(slot, _handle_pool_generations(_pool)[slot]); }
+	return (void*)dest;
+}
+
+bool _handle_pool_remove(handle_pool_t* pool, handle_t handle) {
+	// Error check
+	if (!pool || !_handle_pool_live(pool, handle)) { return false; }
+
+	// Bump the generation so existing handles go stale. A slot whose generation wraps around is retired instead of
+	// being reused, so no handle can ever match it again
+	uint32_t slot = handle_pool_index(handle);
+	_handle_pool_bits(pool)[slot >> 6] &= ~(1ULL << (slot & 63));
+	if (++_handle_pool_generations(pool)[slot] != 0) {
+		_handle_pool_free_stack(pool)[pool->_free++] = slot;
+	}
+	pool->_length--;
+	return true;
+}
+
+void _handle_pool_clear(handle_pool_t* pool) {
+	// Error check
+	if (!pool) { return; }
+
+	// Invalidate each live slot, walking the bitmap a word at a time
+	uint64_t* bits = _handle_pool_bits(pool);
+	uint32_t* generations = _handle_pool_generations(pool);
+	size_t words = _handle_pool_word_num(pool->_slots);
+	for (size_t w = 0; w < words; ++w) {
+		uint64_t word = bits[w];
+		while (word) {
+			generations[(w << 6) + ctz64(word)]++;
+			word &= word - 1;
+		}
+		bits[w] = 0;
+	}
+
+	// Rebuild the free stack with the lowest slots on top, skipping retired slots
+	uint32_t* stack = _handle_pool_free_stack(pool);
+	pool->_free = 0;
+	for (uint32_t s = pool->_slots; s > 0; --s) {
+		if (generations[s - 1] != 0) { stack[pool->_free++] = s - 1; }
+	}
+	pool->_length = 0;
+}
+
+handle_pool_it_t* _handle_pool_it(handle_pool_t* pool) {
+	// Error check
+	if (!pool || pool->_length == 0) { return NULL; }
+
+	// Construct iterator
+	size_t buffer_size = sizeof(handle_pool_it_t);
+	handle_pool_it_t* it = MARS_CALLOC(buffer_size, 1);
+	if (!it) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate handle_pool iterator!");
+		return NULL;
+	}
+	it->_index = SIZE_MAX;
+	it->_pool = pool;
+
+	// Find first valid entry in pool
+	it = _handle_pool_it_next(it);
+	return it;
+}
+
+handle_pool_it_t* _handle_pool_it_next(handle_pool_it_t* it) {
+	// Error check
+	if (!it) { return NULL; }
+
+	// Mask off the slots already visited, then skip empty words
+	handle_pool_t* _pool = it->_pool;
+	size_t start = it->_index + 1;
+	size_t words = _handle_pool_word_num(_pool->_slots);
+	size_t w = start >> 6;
+	if (w < words) {
+		uint64_t word = _handle_pool_bits(_pool)[w] & (~0ULL << (start & 63));
+		while (!word && ++w < words) {
+			word = _handle_pool_bits(_pool)[w];
+		}
+		if (word) {
+			it->_index = (w << 6) + ctz64(word);
+			it->data = (void*)(_handle_pool_pos(_pool, it->_index));
+			it->handle = _handle_pool_make(it->_index, _handle_pool_generations(_pool)[it->_index]);
+			return it;
+		}
+	}
+
+	MARS_FREE(it);
+	return NULL;
+}
@@ -0,0 +1,139 @@
+#ifndef MARS_STD_HANDLE_POOL_H
+#define MARS_STD_HANDLE_POOL_H
+/**
+ * handle_pool.h
+ * Free list of elements addressed by generational handles, so handles to removed elements never alias reused slots.
+*/
+#include "mars/std/utilities.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/// @brief Slot index in the low 32 bits & slot generation in the high 32 bits.
+typedef uint64_t handle_t;
+
+#define HANDLE_NULL 0					// Never a valid handle, since generations start at 1
+
+#ifndef HANDLE_POOL_DEFAULT_CAPACITY
+#define HANDLE_POOL_DEFAULT_CAPACITY 64ULL
+#endif
+#ifndef HANDLE_POOL_MAX_CAPACITY
+#define HANDLE_POOL_MAX_CAPACITY 0x7FFFFFFFULL
+#endif
+
+#define _handle_pool_make(i, g) (((handle_t)(g) << 32) | (handle_t)(i))
+#define _handle_pool_word_num(c) (((c) + 63) / 64)
+#define _handle_pool_bits(p) ((uint64_t*)&(p)->_buffer[0])
+#define _handle_pool_bit_get(p, n) ((_handle_pool_bits(p)[(n) >> 6] >> ((n) & 63)) & 1)
+#define _handle_pool_generations(p) ((uint32_t*)&(p)->_buffer[_handle_pool_word_num((p)->_capacity) * sizeof(uint64_t)])
+#define _handle_pool_free_stack(p) (_handle_pool_generations(p) + (p)->_capacity)
+#define _handle_pool_data_offset(c) (((_handle_pool_word_num(c) * sizeof(uint64_t)) + ((c) * 2 * sizeof(uint32_t)) + 7) & ~(size_t)7)
+#define _handle_pool_pos(p, i) &(p)->_buffer[_handle_pool_data_offset((p)->_capacity)] + ((size_t)(i) * (p)->_element_size)
+#define _handle_pool_live(p, h) (handle_pool_index(h) < (p)->_slots && _handle_pool_bit_get(p, handle_pool_index(h)) && \
+	_handle_pool_generations(p)[handle_pool_index(h)] == handle_pool_generation(h))
+
+/// @brief Create a new handle pool.
+/// @param t Element type
+/// @return Pool pointer
+#define handle_pool_create(t) _handle_pool_factory(sizeof(t), HANDLE_POOL_DEFAULT_CAPACITY)
+
+/// @brief Deallocate a handle pool.
+/// @param p Pool pointer
+#define handle_pool_destroy(p) MARS_FREE(p)
+
+/// @brief Get the slot index of a handle, for addressing arrays kept alongside the pool.
+/// @param h Handle
+/// @return Slot index
+#define handle_pool_index(h) ((uint32_t)((handle_t)(h) & 0xFFFFFFFFULL))
+
+/// @brief Get the generation of a handle.
+/// @param h Handle
+/// @return Generation
+#define handle_pool_generation(h) ((uint32_t)((handle_t)(h) >> 32))
+
+/// @brief Check if a handle refers to an element in the pool.
+/// @param p Pool pointer
+/// @param h Handle
+/// @return True if the element has not been removed
+#define handle_pool_valid(p, h) (_handle_pool_live(p, h) != 0)
+
+/// @brief Get an element from the pool. Element pointers move when the pool grows, handles do not.
+/// @param p Pool pointer
+/// @param h Handle
+/// @return Void data pointer, or NULL if the handle is stale or invalid
+#define handle_pool_get(p, h) (void*)(_handle_pool_live(p, h) ? _handle_pool_pos(p, handle_pool_index(h)) : NULL)
+
+/// @brief Insert an element into a free slot in the pool.
+/// @param p Pool pointer
+/// @param h Handle pointer (will be set to the element's handle, or HANDLE_NULL if insertion failed)
+/// @param d Data pointer
+/// @return Void data pointer to inserted element, or NULL if insertion failed
+#define handle_pool_insert(p, h, d) _handle_pool_insert(&p, h, (void*)(d))
+
+/// @brief Remove an element from the pool. Its handle & any copies of it become invalid.
+/// @param p Pool pointer
+/// @param h Handle
+/// @return True if the handle referred to an element in the pool
+#define handle_pool_remove(p, h) _handle_pool_remove(p, h)
+
+/// @brief Remove every element from the pool. Every outstanding handle becomes invalid.
+/// @param p Pool pointer
+#define handle_pool_clear(p) _handle_pool_clear(p)
+
+/// @brief Get the number of elements in the pool.
+/// @param p Pool pointer
+/// @return Number of elements
+#define handle_pool_size(p) ((p)->_length)
+
+/// @brief Get the size of the pool in memory.
+/// @param p Pool pointer
+/// @return Number of bytes
+#define handle_pool_bytes(p) ((p) ? _handle_pool_buffer_size((p)->_element_size, (p)->_capacity) : 0)
+
+/// @brief Create an iterator for the pool, visiting elements in slot order.
+/// @param p Pool pointer
+/// @return Iterator pointer, or NULL if the pool is empty
+#define handle_pool_it(p) _handle_pool_it(p)
+
+/// @brief Move the iterator to the next element. Removing the current element while iterating is allowed.
+/// @param i Iterator pointer
+/// @return Iterator pointer, or NULL once every element has been visited
+#define handle_pool_it_next(i) _handle_pool_it_next(i)
+
+/// @brief Pool of elements in reusable slots. The buffer holds the occupancy bitmap, each slot's generation, a stack of
+/// @brief free slots & then the element data.
+typedef struct {
+	size_t _length;
+	size_t _capacity;
+	size_t _element_size;
+	uint32_t _slots;					// Slots handed out at least once
+	uint32_t _free;					// Slots on the free stack
+	uint8_t _buffer[];
+} handle_pool_t;
+
+typedef struct {
+	handle_pool_t* _pool;
+	void* data;
+	handle_t handle;
+	size_t _index;
+} handle_pool_it_t;
+
+size_t _handle_pool_buffer_size(size_t, size_t);
+
+handle_pool_t* _handle_pool_factory(size_t, size_t);
+
+handle_pool_t* _handle_pool_resize(handle_pool_t*, size_t);
+
+void* _handle_pool_insert(handle_pool_t**, handle_t*, void*);
+
+bool _handle_pool_remove(handle_pool_t*, handle_t);
+
+void _handle_pool_clear(handle_pool_t*);
+
+handle_pool_it_t* _handle_pool_it(handle_pool_t*);
+
+handle_pool_it_t* _handle_pool_it_next(handle_pool_it_t*);
+
+#endif // MARS_STD_HANDLE_POOL_H
@@ -36,6 +36,16 @@
 #define MARS_ARCH_UNKNOWN
 #endif
 
+// Detect SIMD instruction sets
+#if !defined(MARS_DISABLE_SIMD)
+	#if defined(MARS_ARCH_X64) ||\
+		(defined(MARS_ARCH_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+	#define MARS_SIMD_SSE2
+	#elif defined(MARS_ARCH_ARM64) || (defined(MARS_ARCH_ARM) && defined(__ARM_NEON))
+	#define MARS_SIMD_NEON
+	#endif
+#endif
+
 // Detect OS
 #if defined(_WIN64) || defined(_WIN32)
 #define MARS_OS_WINDOWS
@@ -122,6 +132,15 @@
 	#define MARS_API
 #endif
 
+// Thread local storage specifier
+#if defined(MARS_CMP_MSVC)
+	#define MARS_THREAD_LOCAL __declspec(thread)
+#elif defined(MARS_CMP_GCC) || defined(MARS_CMP_CLANG)
+	#define MARS_THREAD_LOCAL __thread
+#else
+	#define MARS_THREAD_LOCAL _Thread_local
+#endif
+
 // Inline specifier
 #if !defined(MARS_DISABLE_INLINE) && !defined(MARS_CMP_MSVC)
 	#define MARS_USE_INLINE
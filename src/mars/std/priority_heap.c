@@ -0,0 +1,168 @@
+#include "mars/std/priority_heap.h"
+#include "mars/std/debug.h"
+
+size_t _priority_heap_size(size_t element_size, size_t capacity) {
+	if (capacity == 0 || capacity > PRIORITY_HEAP_MAX_CAPACITY) { return 0; }
+	size_t c = element_size * capacity;
+	if (c / capacity != element_size) { return 0; }
+	size_t o = _priority_heap_data_offset(capacity);
+	if (c > SIZE_MAX - o - offsetof(priority_heap_t, _buffer)) { return 0; }
+	return umax(sizeof(priority_heap_t), offsetof(priority_heap_t, _buffer) + o + c);
+}
+
+priority_heap_t* _priority_heap_factory(size_t element_size, size_t capacity, size_t arity) {
+	// Arity must be a power of two so parent & child indices are shifts
+	if (arity < 2 || (arity & (arity - 1)) != 0) { return NULL; }
+	size_t shift = 0;
+	while ((1ULL << shift) < arity) { shift++; }
+
+	size_t buffer_size = _priority_heap_size(element_size, capacity);
+	if (buffer_size == 0) { return NULL; }
+	priority_heap_t* hp = MARS_CALLOC(1, buffer_size);
+	if (!hp) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate priority_heap buffer!");
+		return NULL;
+	}
+	hp->_capacity = capacity;
+	hp->_element_size = element_size;
+	hp->_free = PRIORITY_HEAP_INVALID_HANDLE;
+	hp->_shift = shift;
+	return hp;
+}
+
+priority_heap_t* _priority_heap_resize(priority_heap_t* hp, size_t new_capacity) {
+	// Calculate new capacity
+	if (new_capacity == 0) {
+		size_t c = MARS_NEXT_POW2(hp->_capacity + 1);
+		new_capacity = umin(c, PRIORITY_HEAP_MAX_CAPACITY);
+	}
+	if (new_capacity > PRIORITY_HEAP_MAX_CAPACITY || new_capacity < hp->_slots) { return NULL; }
+
+	// Create new priority heap & copy each block to it, since their offsets depend on the capacity
+	priority_heap_t* new_hp = _priority_heap_factory(hp->_element_size, new_capacity, 1ULL << hp->_shift);
+	if (!new_hp) { return NULL; }
+	memcpy(&_priority_heap_node(new_hp, 0), &_priority_heap_node(hp, 0), hp->_length * sizeof(_priority_heap_node_t));
+	memcpy(&_priority_heap_slot_pos(new_hp, 0), &_priority_heap_slot_pos(hp, 0), hp->_slots * sizeof(uint32_t));
+	memcpy(_priority_heap_data_pos(new_hp, 0), _priority_heap_data_pos(hp, 0), hp->_slots * hp->_element_size);
+
+	new_hp->_length = hp->_length;
+	new_hp->_slots = hp->_slots;
+	new_hp->_free = hp->_free;
+	MARS_FREE(hp);
+	return new_hp;
+}
+
+void* _priority_heap_insert(priority_heap_t** hp, priority_heap_value_t value, void* data, priority_heap_handle_t* handle) {
+	// Error check
+	if (handle) { *handle = PRIORITY_HEAP_INVALID_HANDLE; }
+	if (!hp || !(*hp)) { return NULL; }
+	priority_heap_t* _hp = *hp;
+
+	// Resize container
+	if (_hp->_length >= _hp->_capacity) {
+		priority_heap_t* temp = _priority_heap_resize(_hp, 0);
+		if (!temp) { return NULL; }
+		(*hp) = temp;
+		_hp = temp;
+	}
+
+	// Take a slot off the free stack, or the next unused one
+	uint32_t slot = _hp->_free;
+	if (slot != PRIORITY_HEAP_INVALID_HANDLE) {
+		uint32_t next = _priority_heap_slot_pos(_hp, slot);
+		_hp->_free = (next == PRIORITY_HEAP_INVALID_HANDLE) ? PRIORITY_HEAP_INVALID_HANDLE : (next & ~_PRIORITY_HEAP_FREE_SLOT);
+	}
+	else {
+		slot = _hp->_slots++;
+	}
+	void* data_dest = (void*)(_priority_heap_data_pos(_hp, slot));
+	memcpy_s(data_dest, _hp->_element_size, data, _hp->_element_size);
+
+	// Add the node to the bottom of the heap & move it up
+	_priority_heap_node(_hp, _hp->_length).value = value;
+	_priority_heap_node(_hp, _hp->_length).slot = slot;
+	_hp->_length++;
+	_priority_heap_sift_up(_hp, _hp->_length - 1);
+
+	if (handle) { *handle = slot; }
+	return data_dest;
+}
+
+void _priority_heap_remove(priority_heap_t* hp, priority_heap_handle_t handle) {
+	// Error check
+	if (!hp || !_priority_heap_live(hp, handle)) { return; }
+
+	// Fill the hole with the last node & move it whichever way restores the heap
+	size_t i = _priority_heap_slot_pos(hp, handle);
+	size_t last = --hp->_length;
+	if (i != last) {
+		_priority_heap_node(hp, i) = _priority_heap_node(hp, last);
+		_priority_heap_slot_pos(hp, _priority_heap_node(hp, i).slot) = (uint32_t)i;
+		if (i > 0 && _priority_heap_node(hp, (i - 1) >> hp->_shift).value < _priority_heap_node(hp, i).value) {
+			_priority_heap_sift_up(hp, i);
+		}
+		else {
+			_priority_heap_sift_down(hp, i);
+		}
+	}
+
+	// Push the slot onto the free stack
+	_priority_heap_slot_pos(hp, handle) = _PRIORITY_HEAP_FREE_SLOT | hp->_free;
+	hp->_free = handle;
+}
+
+bool _priority_heap_update(priority_heap_t* hp, priority_heap_handle_t handle, priority_heap_value_t value) {
+	// Error check
+	if (!hp || !_priority_heap_live(hp, handle)) { return false; }
+
+	size_t i = _priority_heap_slot_pos(hp, handle);
+	priority_heap_value_t old = _priority_heap_node(hp, i).value;
+	_priority_heap_node(hp, i).value = value;
+	if (value > old) { _priority_heap_sift_up(hp, i); }
+	else if (value < old) { _priority_heap_sift_down(hp, i); }
+	return true;
+}
+
+void _priority_heap_clear(priority_heap_t* hp) {
+	// Error check
+	if (!hp) { return; }
+
+	hp->_length = 0;
+	hp->_slots = 0;
+	hp->_free = PRIORITY_HEAP_INVALID_HANDLE;
+}
+
+void _priority_heap_sift_up(priority_heap_t* hp, size_t i) {
+	// Move parents down into the hole until the node fits
+	_priority_heap_node_t node = _priority_heap_node(hp, i);
+	while (i > 0) {
+		size_t p = (i - 1) >> hp->_shift;
+		if (_priority_heap_node(hp, p).value >= node.value) { break; }
+		_priority_heap_node(hp, i) = _priority_heap_node(hp, p);
+		_priority_heap_slot_pos(hp, _priority_heap_node(hp, i).slot) = (uint32_t)i;
+		i = p;
+	}
+	_priority_heap_node(hp, i) = node;
+	_priority_heap_slot_pos(hp, node.slot) = (uint32_t)i;
+}
+
+void _priority_heap_sift_down(priority_heap_t* hp, size_t i) {
+	// Move the largest child up into the hole until the node fits
+	_priority_heap_node_t node = _priority_heap_node(hp, i);
+	size_t arity = (size_t)1 << hp->_shift;
+	while (1) {
+		size_t c = (i << hp->_shift) + 1;
+		if (c >= hp->_length) { break; }
+		size_t end = umin(c + arity, hp->_length);
+		size_t best = c;
+		for (size_t k = c + 1; k < end; ++k) {
+			if (_priority_heap_node(hp, k).value > _priority_heap_node(hp, best).value) { best = k; }
+		}
+		if (_priority_heap_node(hp, best).value <= node.value) { break; }
+		_priority_heap_node(hp, i) = _priority_heap_node(hp, best);
+		_priority_heap_slot_pos(hp, _priority_heap_node(hp, i).slot) = (uint32_t)i;
+		i = best;
+	}
+	_priority_heap_node(hp, i) = node;
+	_priority_heap_slot_pos(hp, node.slot) = (uint32_t)i;
+}
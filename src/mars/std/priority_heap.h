@@ -0,0 +1,151 @@
+#ifndef MARS_STD_PRIORITY_HEAP_H
+#define MARS_STD_PRIORITY_HEAP_H
+/**
+ * priority_heap.h
+ * Heap ordered queue of value-data pairs, with stable handles for changing priorities.
+*/
+#include "mars/std/utilities.h"
+#include "mars/std/priority_queue.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+typedef priority_queue_value_t priority_heap_value_t;
+typedef uint32_t priority_heap_handle_t;
+
+#ifndef PRIORITY_HEAP_DEFAULT_CAPACITY
+#define PRIORITY_HEAP_DEFAULT_CAPACITY 8ULL
+#endif
+#ifndef PRIORITY_HEAP_MAX_CAPACITY
+#define PRIORITY_HEAP_MAX_CAPACITY 0x7FFFFFFFULL
+#endif
+#define PRIORITY_HEAP_INVALID_HANDLE UINT32_MAX
+
+#define _PRIORITY_HEAP_FREE_SLOT 0x80000000U
+#define _priority_heap_pos_offset(c) ((c) * sizeof(_priority_heap_node_t))
+#define _priority_heap_data_offset(c) ((_priority_heap_pos_offset(c) + ((c) * sizeof(uint32_t)) + 7) & ~(size_t)7)
+#define _priority_heap_node(h, i) ((_priority_heap_node_t*)&(h)->_buffer[0])[i]
+#define _priority_heap_slot_pos(h, s) ((uint32_t*)&(h)->_buffer[_priority_heap_pos_offset((h)->_capacity)])[s]
+#define _priority_heap_data_pos(h, s) &(h)->_buffer[_priority_heap_data_offset((h)->_capacity)] + ((size_t)(s) * (h)->_element_size)
+#define _priority_heap_live(h, s) ((s) < (h)->_slots && !(_priority_heap_slot_pos(h, s) & _PRIORITY_HEAP_FREE_SLOT))
+
+/// @brief Create a new binary priority heap.
+/// @param t Priority heap type
+/// @return Priority heap pointer
+#define priority_heap_create(t) _priority_heap_factory(sizeof(t), PRIORITY_HEAP_DEFAULT_CAPACITY, 2)
+
+/// @brief Create a new d-ary priority heap. Wider heaps are shallower, so pushes & priority increases touch fewer levels,
+/// @brief at the cost of comparing more children on each level of a pop.
+/// @param t Priority heap type
+/// @param d Children per node (power of two, e.g. 4)
+/// @return Priority heap pointer, or NULL if the arity is invalid
+#define priority_heap_create_dary(t, d) _priority_heap_factory(sizeof(t), PRIORITY_HEAP_DEFAULT_CAPACITY, d)
+
+/// @brief Deallocate a priority heap.
+/// @param h Priority heap pointer
+#define priority_heap_destroy(h) MARS_FREE(h)
+
+/// @brief Get the data of the element with the highest value.
+/// @param h Priority heap pointer
+/// @return Void data pointer, or NULL if empty
+#define priority_heap_top_data(h) (void*)((h)->_length > 0 ? _priority_heap_data_pos(h, _priority_heap_node(h, 0).slot) : NULL)
+
+/// @brief Get the highest value in the priority heap.
+/// @param h Priority heap pointer
+/// @return Value pointer, or NULL if empty
+#define priority_heap_top_value(h) (priority_heap_value_t*)((h)->_length > 0 ? &_priority_heap_node(h, 0).value : NULL)
+
+/// @brief Get the handle of the element with the highest value.
+/// @param h Priority heap pointer
+/// @return Handle, or PRIORITY_HEAP_INVALID_HANDLE if empty
+#define priority_heap_top_handle(h) ((h)->_length > 0 ? _priority_heap_node(h, 0).slot : PRIORITY_HEAP_INVALID_HANDLE)
+
+/// @brief Add an element to the priority heap. Elements with equal values are popped in no particular order.
+/// @param h Priority heap pointer
+/// @param v Priority value
+/// @param d Data pointer
+/// @param i Handle pointer (optional, set to the element's handle which stays valid until it is popped or removed)
+/// @return Void data pointer to inserted element, or NULL on failure
+#define priority_heap_push(h, v, d, i) _priority_heap_insert(&h, v, (void*)d, i)
+
+/// @brief Remove the element with the highest value from the priority heap.
+/// @param h Priority heap pointer
+#define priority_heap_pop(h) _priority_heap_remove(h, priority_heap_top_handle(h))
+
+/// @brief Remove an element from the priority heap.
+/// @param h Priority heap pointer
+/// @param i Handle
+#define priority_heap_remove(h, i) _priority_heap_remove(h, i)
+
+/// @brief Change the priority of an element, moving it up or down the heap.
+/// @param h Priority heap pointer
+/// @param i Handle
+/// @param v New priority value
+/// @return True if the handle refers to an element in the heap
+#define priority_heap_update(h, i, v) _priority_heap_update(h, i, v)
+
+/// @brief Get the data of an element. Data does not move while the element is in the heap.
+/// @param h Priority heap pointer
+/// @param i Handle
+/// @return Void data pointer, or NULL if the handle is not in the heap
+#define priority_heap_get(h, i) (void*)(_priority_heap_live(h, i) ? _priority_heap_data_pos(h, i) : NULL)
+
+/// @brief Get the priority value of an element.
+/// @param h Priority heap pointer
+/// @param i Handle
+/// @return Value pointer, or NULL if the handle is not in the heap
+#define priority_heap_value(h, i) (priority_heap_value_t*)(_priority_heap_live(h, i) ? &_priority_heap_node(h, _priority_heap_slot_pos(h, i)).value : NULL)
+
+/// @brief Get the number of elements in the priority heap.
+/// @param h Priority heap pointer
+/// @return Number of elements
+#define priority_heap_size(h) ((h)->_length)
+
+/// @brief Remove all elements in the priority heap. Every handle is invalidated.
+/// @param h Priority heap pointer
+#define priority_heap_clear(h) _priority_heap_clear(h)
+
+/// @brief Get the size of the priority heap in memory.
+/// @param h Priority heap pointer
+/// @return Number of bytes
+#define priority_heap_bytes(h) ((h) ? (_priority_heap_size((h)->_element_size, (h)->_capacity)) : 0)
+
+/// @brief Heap entry. Values are kept next to their slot so sifting never touches element data.
+typedef struct {
+	priority_heap_value_t value;
+	uint32_t slot;
+} _priority_heap_node_t;
+
+/// @brief Implicit d-ary max heap. The buffer holds the heap nodes, then each slot's position in the heap (or the next free
+/// @brief slot, flagged with _PRIORITY_HEAP_FREE_SLOT), then the element data indexed by slot.
+typedef struct {
+	size_t _length;
+	size_t _capacity;
+	size_t _element_size;
+	uint32_t _slots;
+	uint32_t _free;
+	size_t _shift;
+	uint8_t _buffer[];
+} priority_heap_t;
+
+size_t _priority_heap_size(size_t, size_t);
+
+priority_heap_t* _priority_heap_factory(size_t, size_t, size_t);
+
+priority_heap_t* _priority_heap_resize(priority_heap_t*, size_t);
+
+void* _priority_heap_insert(priority_heap_t**, priority_heap_value_t, void*, priority_heap_handle_t*);
+
+void _priority_heap_remove(priority_heap_t*, priority_heap_handle_t);
+
+bool _priority_heap_update(priority_heap_t*, priority_heap_handle_t, priority_heap_value_t);
+
+void _priority_heap_clear(priority_heap_t*);
+
+void _priority_heap_sift_up(priority_heap_t*, size_t);
+
+void _priority_heap_sift_down(priority_heap_t*, size_t);
+
+#endif	// MARS_STD_PRIORITY_HEAP_H
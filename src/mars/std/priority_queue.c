@@ -39,8 +39,8 @@ priority_queue_t* _priority_queue_resize(priority_queue_t* qu, size_t new_capaci
 	memcpy_s(_priority_queue_data_pos(new_qu, 0), data_dest_size, _priority_queue_data_pos(qu, 0), data_dest_size);
 
 	new_qu->_length = qu->_length;
+	new_qu->_unsorted = qu->_unsorted;
 	MARS_FREE(qu);
-	_priority_queue_sort(new_qu);
 	return new_qu;
 }
 
@@ -56,29 +56,68 @@ void* _priority_queue_insert(priority_queue_t** qu, priority_queue_value_t value
 		(*qu) = temp;
 		_qu = temp;
 	}
+	if (_qu->_unsorted) { _priority_queue_sort(_qu); }
 
-	// Copy value to end
-	void* value_dest = (void*)(_priority_queue_value_pos(_qu, _qu->_length));
+	// Find the insertion point after any equal values, so equal values keep their push order
+	size_t lo = 0;
+	size_t hi = _qu->_length;
+	while (lo < hi) {
+		size_t md = lo + (hi - lo) / 2;
+		if (_priority_queue_value(_qu, md) <= value) { lo = md + 1; }
+		else { hi = md; }
+	}
+
+	// Shift the higher values up a place
+	size_t move_count = _qu->_length - lo;
+	if (move_count > 0) {
+		memmove(_priority_queue_value_pos(_qu, lo + 1), _priority_queue_value_pos(_qu, lo), move_count * sizeof(priority_queue_value_t));
+		memmove(_priority_queue_data_pos(_qu, lo + 1), _priority_queue_data_pos(_qu, lo), move_count * _qu->_element_size);
+	}
+
+	// Copy value & data into the gap
+	void* value_dest = (void*)(_priority_queue_value_pos(_qu, lo));
 	size_t value_dest_size = sizeof(priority_queue_value_t);
 	memcpy_s(value_dest, value_dest_size, &value, value_dest_size);
-
-	// Copy data to end
-	void* data_dest = (void*)(_priority_queue_data_pos(_qu, _qu->_length));
+	void* data_dest = (void*)(_priority_queue_data_pos(_qu, lo));
 	size_t data_dest_size = _qu->_element_size;
 	memcpy_s(data_dest, data_dest_size, data, data_dest_size);
 	_qu->_length++;
+	return data_dest;
+}
 
-	// Sort list
-	_priority_queue_sort(_qu);
-	return _priority_queue_find(_qu, value, data);
+void* _priority_queue_append(priority_queue_t** qu, const priority_queue_value_t* values, void* data, size_t count) {
+	// Error check
+	if (!qu || !(*qu) || !values || !data) { return NULL; }
+	priority_queue_t* _qu = *qu;
+	if (count == 0) { return NULL; }
+	if (count > UINT32_MAX || _qu->_length > UINT32_MAX - count) { return NULL; }
+
+	// Resize container
+	if (_qu->_length + count > _qu->_capacity) {
+		size_t c = MARS_NEXT_POW2(_qu->_length + count);
+		priority_queue_t* temp = _priority_queue_resize(_qu, umin(c, PRIORITY_QUEUE_MAX_CAPACITY));
+		if (!temp) { return NULL; }
+		(*qu) = temp;
+		_qu = temp;
+	}
+
+	// Copy values & data to the end, the sort waits for priority_queue_finalize
+	void* data_dest = (void*)(_priority_queue_data_pos(_qu, _qu->_length));
+	memcpy(_priority_queue_value_pos(_qu, _qu->_length), values, count * sizeof(priority_queue_value_t));
+	memcpy(data_dest, data, count * _qu->_element_size);
+	_qu->_length += count;
+	_qu->_unsorted += count;
+	return data_dest;
 }
 
 void _priority_queue_remove(priority_queue_t* qu, size_t count) {
 	// Error check
 	if (!qu || qu->_length < count) { return; }
+	if (qu->_unsorted && count < qu->_length) { _priority_queue_sort(qu); }
 
 	// Decrement length
 	qu->_length -= count;
+	if (qu->_length == 0) { qu->_unsorted = 0; }
 }
 
 void _priority_queue_remove_value(priority_queue_t* qu, priority_queue_value_t value, void* data) {
@@ -90,13 +129,13 @@ void _priority_queue_remove_value(priority_queue_t* qu, priority_queue_value_t v
 		// Shift value block
 		void* dest = (void*)(_priority_queue_value_pos(qu, it));
 		void* src = (void*)(_priority_queue_value_pos(qu, it + 1));
-		size_t move_size = ((qu->_capacity - it - 1) * sizeof(priority_queue_value_t)) + (qu->_capacity * qu->_element_size);
+		size_t move_size = (qu->_length - it - 1) * sizeof(priority_queue_value_t);
 		memmove_s(dest, move_size, src, move_size);
 
 		// Shift data block
 		dest = (void*)(_priority_queue_data_pos(qu, it));
 		src = (void*)(_priority_queue_data_pos(qu, it + 1));
-		move_size = (qu->_capacity - it - 1) * qu->_element_size;
+		move_size = (qu->_length - it - 1) * qu->_element_size;
 		memmove_s(dest, move_size, src, move_size);
 
 		qu->_length--;
@@ -104,73 +143,92 @@ void _priority_queue_remove_value(priority_queue_t* qu, priority_queue_value_t v
 }
 
 void _priority_queue_sort(priority_queue_t* qu) {
-	// Insertion sort
-	size_t dest_elem_size = qu->_element_size;
-	size_t dest_value_size = sizeof(priority_queue_value_t);
-	void* tmp_data = MARS_MALLOC(qu->_element_size);
-	priority_queue_value_t tmp_value = 0;
-	for(size_t i=1; i<qu->_length; ++i) {
-		// Copy element to temp buffer
-		memcpy_s(tmp_data, dest_elem_size, _priority_queue_data_pos(qu, i), dest_elem_size);
-		tmp_value = _priority_queue_value(qu, i);
-
-		// Shift elements
-		size_t j=i;
-		for(; j > 0 && _priority_queue_value(qu, j-1) > tmp_value; --j) {
-			memcpy_s(_priority_queue_data_pos(qu, j), dest_elem_size, _priority_queue_data_pos(qu, j-1), dest_elem_size);
-			memcpy_s(_priority_queue_value_pos(qu, j), dest_value_size, _priority_queue_value_pos(qu, j-1), dest_value_size);
+	// Error check
+	if (!qu || qu->_unsorted == 0) { return; }
+	size_t unsorted = qu->_unsorted;
+	qu->_unsorted = 0;
+
+	// Skip the sort if the elements were appended in order
+	size_t n = qu->_length;
+	size_t i = 1;
+	while (i < n && _priority_queue_value(qu, i - 1) <= _priority_queue_value(qu, i)) { i++; }
+	if (i >= n) { return; }
+
+	// Radix sort (key, index) pairs so each element's data is only moved once. Flipping the sign bit makes the
+	// unsigned key order match the signed value order
+	typedef struct { uint32_t key; uint32_t index; } _priority_queue_key_t;
+	size_t key_size = n * sizeof(_priority_queue_key_t);
+	uint8_t* tmp = MARS_MALLOC((2 * key_size) + (n * qu->_element_size));
+	if (!tmp) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate priority_queue sort buffer!");
+		qu->_unsorted = unsorted;
+		return;
+	}
+	_priority_queue_key_t* src = (_priority_queue_key_t*)tmp;
+	_priority_queue_key_t* dst = (_priority_queue_key_t*)(tmp + key_size);
+	uint8_t* tmp_data = tmp + (2 * key_size);
+
+	// Histogram every digit in one pass
+	size_t counts[4][256] = { 0 };
+	for (i = 0; i < n; ++i) {
+		uint32_t key = (uint32_t)_priority_queue_value(qu, i) ^ 0x80000000U;
+		src[i].key = key;
+		src[i].index = (uint32_t)i;
+		counts[0][key & 0xFF]++;
+		counts[1][(key >> 8) & 0xFF]++;
+		counts[2][(key >> 16) & 0xFF]++;
+		counts[3][key >> 24]++;
+	}
+
+	// Stable scatter on each digit from least to most significant, skipping digits every key shares
+	for (size_t d = 0; d < 4; ++d) {
+		uint32_t shift = (uint32_t)(d * 8);
+		if (counts[d][(src[0].key >> shift) & 0xFF] == n) { continue; }
+		size_t offset = 0;
+		for (size_t b = 0; b < 256; ++b) {
+			size_t c = counts[d][b];
+			counts[d][b] = offset;
+			offset += c;
 		}
+		for (i = 0; i < n; ++i) {
+			dst[counts[d][(src[i].key >> shift) & 0xFF]++] = src[i];
+		}
+		_priority_queue_key_t* swap = src;
+		src = dst;
+		dst = swap;
+	}
 
-		// Re-insert temp
-		memcpy_s(_priority_queue_data_pos(qu, j), dest_elem_size, tmp_data, dest_elem_size);
-		memcpy_s(_priority_queue_value_pos(qu, j), dest_value_size, &tmp_value, dest_value_size);
+	// Gather data in sorted order & write back both blocks
+	size_t element_size = qu->_element_size;
+	for (i = 0; i < n; ++i) {
+		_priority_queue_value(qu, i) = (priority_queue_value_t)(src[i].key ^ 0x80000000U);
+		memcpy(tmp_data + (i * element_size), _priority_queue_data_pos(qu, src[i].index), element_size);
 	}
-	// Free temp buffer
-	MARS_FREE(tmp_data);
+	memcpy(_priority_queue_data_pos(qu, 0), tmp_data, n * element_size);
+	MARS_FREE(tmp);
 }
 
 size_t _priority_queue_find_index(priority_queue_t* qu, priority_queue_value_t value, void* data) {
-	// Binary search
-	size_t hi = qu->_length - 1;
-	size_t lo = 0;
-	size_t md = 0;
-	priority_queue_value_t hi_val = 0;
-	priority_queue_value_t lo_val = 0;
-	priority_queue_value_t md_val = 0;
-	size_t r = qu->_capacity;
-	do {
-		md = lo + (hi - lo) / 2;
-		hi_val = _priority_queue_value(qu, hi);
-		lo_val = _priority_queue_value(qu, lo);
-		md_val = _priority_queue_value(qu, md);
-		if (md_val == value) {
-			// Value found
-			r = md;
-			break;
-		}
-		else if (md_val < value) {
-			// Midpoint too low, move window up
-			lo = md + 1;
-		}
-		else {
-			// Midpoint too high, move window down
-			hi = md - 1;
-		}
-	}
-	while (hi != lo);
+	if (qu->_unsorted) { _priority_queue_sort(qu); }
 
-	// Move to the start of a sequential run
-	while(r < (qu->_capacity - 1) && _priority_queue_value(qu, r+1) == _priority_queue_value(qu, r)) {
-		r++;
+	// Binary search for the end of the run of matching values
+	size_t lo = 0;
+	size_t hi = qu->_length;
+	while (lo < hi) {
+		size_t md = lo + (hi - lo) / 2;
+		if (_priority_queue_value(qu, md) <= value) { lo = md + 1; }
+		else { hi = md; }
 	}
+	if (lo == 0 || _priority_queue_value(qu, lo - 1) != value) { return qu->_capacity; }
+	size_t r = lo - 1;
 
-	// Check the run for matching data
+	// Check the run for matching data, starting from the top
 	if (data) {
 		do {
 			if (memcmp(_priority_queue_data_pos(qu, r), data, qu->_element_size) == 0) {
 				break;
 			}
-			if (r == 0 || _priority_queue_value(qu, r) != value) {
+			if (r == 0 || _priority_queue_value(qu, r - 1) != value) {
 				return qu->_capacity;
 			}
 			r--;
@@ -191,6 +249,7 @@ void* _priority_queue_find(priority_queue_t* qu, priority_queue_value_t value, v
 priority_queue_it_t* _priority_queue_it(priority_queue_t* qu, bool begin) {
 	// Error check
 	if (!qu || qu->_length == 0) { return NULL; }
+	if (qu->_unsorted) { _priority_queue_sort(qu); }
 
 	// Construct iterator
 	size_t buffer_size = sizeof(priority_queue_it_t);
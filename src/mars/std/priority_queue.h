@@ -51,6 +51,20 @@ typedef int32_t priority_queue_value_t;
 /// @return Void data pointer to inserted element, or NULL on failure
 #define priority_queue_push(q, v, d) _priority_queue_insert(&q, v, (void*)d)
 
+/// @brief Append elements to the priority queue without sorting them. Call priority_queue_finalize once every element is
+/// @brief pushed, since the top of the queue is undefined until then. Finding, iterating, pushing & popping finalize the
+/// @brief queue first if needed.
+/// @param q Priority queue pointer
+/// @param v Priority value array
+/// @param d Data array (one element per value)
+/// @param n Number of elements
+/// @return Void data pointer to the first appended element, or NULL on failure
+#define priority_queue_push_many(q, v, d, n) _priority_queue_append(&q, v, (void*)(d), n)
+
+/// @brief Sort elements appended by priority_queue_push_many into place. Does nothing if the queue is already sorted.
+/// @param q Priority queue pointer
+#define priority_queue_finalize(q) _priority_queue_sort(q)
+
 /// @brief Remove the top element from the priority queue.
 /// @param q Priority queue pointer
 #define priority_queue_pop(q) _priority_queue_remove(q, 1)
@@ -113,6 +127,7 @@ typedef struct {
 	size_t _length;
 	size_t _capacity;
 	size_t _element_size;
+	size_t _unsorted;
 	uint8_t _buffer[];
 } priority_queue_t;
 
@@ -132,6 +147,8 @@ priority_queue_t* _priority_queue_resize(priority_queue_t*, size_t);
 
 void* _priority_queue_insert(priority_queue_t**, priority_queue_value_t, void*);
 
+void* _priority_queue_append(priority_queue_t**, const priority_queue_value_t*, void*, size_t);
+
 void _priority_queue_remove(priority_queue_t*, size_t);
 
 void _priority_queue_remove_value(priority_queue_t*, priority_queue_value_t, void*);
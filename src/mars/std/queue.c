@@ -27,30 +27,63 @@ queue_t* _queue_resize(queue_t* qu, size_t new_capacity) {
 		new_capacity = umin(c, QUEUE_MAX_CAPACITY);
 	}
 	if (new_capacity > QUEUE_MAX_CAPACITY || new_capacity < qu->_length) { return NULL; }
+	size_t buffer_size = _queue_size(qu->_element_size, new_capacity);
+	if (buffer_size == 0) { return NULL; }
+
+	// Elements run from the head to the end of the buffer, then wrap around to the start
+	size_t front = umin(qu->_length, qu->_capacity - qu->_head);
+	if (new_capacity >= qu->_capacity) {
+		// Grow in place if the allocator can, then move the run before the wrap to the end of the larger buffer
+		queue_t* new_qu = MARS_REALLOC(qu, buffer_size);
+		if (!new_qu) {
+			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to reallocate queue buffer!");
+			return NULL;
+		}
+		if (front < new_qu->_length) {
+			size_t new_head = new_capacity - front;
+			memmove(_queue_pos(new_qu, new_head), _queue_pos(new_qu, new_qu->_head), front * new_qu->_element_size);
+			new_qu->_head = new_head;
+		}
+		new_qu->_capacity = new_capacity;
+		new_qu->_tail = (new_qu->_head + new_qu->_length) % new_capacity;
+		return new_qu;
+	}
 
-	// Create new queue & copy data to it
+	// Shrinking may cut off the run at the head, so copy both runs to the start of a new buffer
 	queue_t* new_qu = _queue_factory(qu->_element_size, new_capacity);
 	if (!new_qu) { return NULL; }
-	if (qu->_tail <= qu->_head) {
-		// Queue wraps around circular buffer, copy in two parts
-		size_t _qu_end = (qu->_capacity - qu->_head);
-		size_t dest_size_start = _qu_end * qu->_element_size;
-		size_t dest_size_end = (qu->_length - _qu_end) * qu->_element_size;
-		memcpy_s(_queue_pos(new_qu, 0), dest_size_start, _queue_pos(qu, qu->_head), dest_size_start);
-		memcpy_s(_queue_pos(new_qu, _qu_end), dest_size_end, _queue_pos(qu, 0), dest_size_end);
-	}
-	else {
-		// Queue is contained in circular buffer, one copy will get everything
-		size_t dest_size = qu->_length * qu->_element_size;
-		memcpy_s(new_qu->_buffer, dest_size, _queue_pos(qu, qu->_head), dest_size);
-	}
+	memcpy(_queue_pos(new_qu, 0), _queue_pos(qu, qu->_head), front * qu->_element_size);
+	memcpy(_queue_pos(new_qu, front), _queue_pos(qu, 0), (qu->_length - front) * qu->_element_size);
 	new_qu->_head = 0;
-	new_qu->_tail = qu->_length;
+	new_qu->_tail = qu->_length % new_capacity;
 	new_qu->_length = qu->_length;
 	MARS_FREE(qu);
 	return new_qu;
 }
 
+bool _queue_reserve(queue_t** qu, size_t capacity) {
+	// Error check
+	if (!qu || !(*qu)) { return false; }
+	if (capacity <= (*qu)->_capacity) { return true; }
+
+	queue_t* temp = _queue_resize(*qu, capacity);
+	if (!temp) { return false; }
+	(*qu) = temp;
+	return true;
+}
+
+bool _queue_shrink_to_fit(queue_t** qu) {
+	// Error check
+	if (!qu || !(*qu)) { return false; }
+	size_t capacity = umax((*qu)->_length, 1);
+	if (capacity >= (*qu)->_capacity) { return true; }
+
+	queue_t* temp = _queue_resize(*qu, capacity);
+	if (!temp) { return false; }
+	(*qu) = temp;
+	return true;
+}
+
 void* _queue_insert(queue_t** qu, void* data) {
 	// Error check
 	if (!qu || !(*qu)) { return NULL; }
@@ -77,8 +110,7 @@ void _queue_remove(queue_t* qu, size_t count) {
 	// Error check
 	if (!qu || qu->_length < count) { return; }
 
-	// Increment head
-	size_t new_head = (qu->_head + count) % qu->_capacity;
-	qu->_head = (qu->_head <= qu->_tail && new_head > qu->_tail) ? qu->_tail : new_head;
+	// Increment head (count is bounded by length, so this can never pass the tail, even when the queue is full)
+	qu->_head = (qu->_head + count) % qu->_capacity;
 	qu->_length -= count;
 }
\ No newline at end of file
@@ -12,7 +12,7 @@
 #include <string.h>
 
 #ifndef QUEUE_DEFAULT_CAPACITY
-#define QUEUE_DEFAULT_CAPACITY 1ULL
+#define QUEUE_DEFAULT_CAPACITY 8ULL
 #endif
 #ifndef QUEUE_MAX_CAPACITY
 #define QUEUE_MAX_CAPACITY SIZE_MAX - 1
@@ -53,6 +53,17 @@
 /// @param q Queue pointer
 #define queue_clear(q) _queue_remove(q, (q)->_length)
 
+/// @brief Grow the queue so it holds at least the given number of elements without reallocating.
+/// @param q Queue pointer
+/// @param n Number of elements
+/// @return True if the queue has room for n elements
+#define queue_reserve(q, n) _queue_reserve(&q, n)
+
+/// @brief Shrink the queue's capacity down to its size.
+/// @param q Queue pointer
+/// @return True if the queue was shrunk (or is already as small as it can be)
+#define queue_shrink_to_fit(q) _queue_shrink_to_fit(&q)
+
 /// @brief Get the size of the queue in memory.
 /// @param q Queue pointer
 /// @return Number of bytes
@@ -74,6 +85,10 @@ queue_t* _queue_factory(size_t, size_t);
 
 queue_t* _queue_resize(queue_t*, size_t);
 
+bool _queue_reserve(queue_t**, size_t);
+
+bool _queue_shrink_to_fit(queue_t**);
+
 void* _queue_insert(queue_t**, void*);
 
 void _queue_remove(queue_t*, size_t);
@@ -27,17 +27,42 @@ stack_t* _stack_resize(stack_t* stk, size_t new_capacity) {
 		new_capacity = umin(c, STACK_MAX_CAPACITY);
 	}
 	if (new_capacity > STACK_MAX_CAPACITY || new_capacity < stk->_length) { return NULL; }
+	size_t buffer_size = _stack_size(stk->_element_size, new_capacity);
+	if (buffer_size == 0) { return NULL; }
 
-	// Create new stack & copy data to it
-	stack_t* new_stk = _stack_factory(stk->_element_size, new_capacity);
-	if (!new_stk) { return NULL; }
-	size_t dest_size = stk->_length * stk->_element_size;
-	memcpy_s(new_stk->_buffer, dest_size, stk->_buffer, dest_size);
-	new_stk->_length = stk->_length;
-	MARS_FREE(stk);
+	// Reallocate, which can extend the block in place instead of copying it
+	stack_t* new_stk = MARS_REALLOC(stk, buffer_size);
+	if (!new_stk) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to reallocate stack buffer!");
+		return NULL;
+	}
+	new_stk->_capacity = new_capacity;
 	return new_stk;
 }
 
+bool _stack_reserve(stack_t** stk, size_t capacity) {
+	// Error check
+	if (!stk || !(*stk)) { return false; }
+	if (capacity <= (*stk)->_capacity) { return true; }
+
+	stack_t* temp = _stack_resize(*stk, capacity);
+	if (!temp) { return false; }
+	(*stk) = temp;
+	return true;
+}
+
+bool _stack_shrink_to_fit(stack_t** stk) {
+	// Error check
+	if (!stk || !(*stk)) { return false; }
+	size_t capacity = umax((*stk)->_length, 1);
+	if (capacity >= (*stk)->_capacity) { return true; }
+
+	stack_t* temp = _stack_resize(*stk, capacity);
+	if (!temp) { return false; }
+	(*stk) = temp;
+	return true;
+}
+
 void* _stack_insert(stack_t** stk, void* data) {
 	// Error check
 	if (!stk || !(*stk) || !data) { return NULL; }
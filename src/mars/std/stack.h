@@ -12,7 +12,7 @@
 #include <string.h>
 
 #ifndef STACK_DEFAULT_CAPACITY
-#define STACK_DEFAULT_CAPACITY 1ULL
+#define STACK_DEFAULT_CAPACITY 8ULL
 #endif
 #ifndef STACK_MAX_CAPACITY
 #define STACK_MAX_CAPACITY SIZE_MAX - 1
@@ -53,6 +53,17 @@
 /// @param s Stack pointer
 #define stack_clear(s) _stack_remove(s, (s)->_length)
 
+/// @brief Grow the stack so it holds at least the given number of elements without reallocating.
+/// @param s Stack pointer
+/// @param n Number of elements
+/// @return True if the stack has room for n elements
+#define stack_reserve(s, n) _stack_reserve(&s, n)
+
+/// @brief Shrink the stack's capacity down to its size.
+/// @param s Stack pointer
+/// @return True if the stack was shrunk (or is already as small as it can be)
+#define stack_shrink_to_fit(s) _stack_shrink_to_fit(&s)
+
 /// @brief Get the size of the stack in memory.
 /// @param s Stack pointer
 /// @return Number of bytes
@@ -72,6 +83,10 @@ stack_t* _stack_factory(size_t, size_t);
 
 stack_t* _stack_resize(stack_t*, size_t);
 
+bool _stack_reserve(stack_t**, size_t);
+
+bool _stack_shrink_to_fit(stack_t**);
+
 void* _stack_insert(stack_t**, void*);
 
 void _stack_remove(stack_t*, size_t);
@@ -0,0 +1,65 @@
+#include "mars/std/string_table.h"
+#include "mars/std/debug.h"
+
+StringId string_id_make(const char* _str) {
+	StringId id = { 0 };
+	if (_str) {
+		id.str = (char*)_str;
+		id.hash = _umap_str_hash(id.str);
+	}
+	return id;
+}
+
+string_table_t* _string_table_factory() {
+	string_table_t* table = MARS_CALLOC(1, sizeof(*table));
+	if (!table) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate string_table buffer!");
+		return NULL;
+	}
+
+	// The map owns the key copies, which never move when the map is resized
+	table->_strings = unordered_map_str_create(char);
+	if (!table->_strings) {
+		MARS_FREE(table);
+		return NULL;
+	}
+	return table;
+}
+
+void _string_table_destroy(string_table_t* table) {
+	if (table) {
+		unordered_map_str_destroy(table->_strings);
+		MARS_FREE(table);
+	}
+}
+
+StringId _string_table_intern(string_table_t* table, const char* str) {
+	// Error check
+	StringId id = { 0 };
+	if (!table || !str) { return id; }
+
+	// Return the existing copy, or insert a new one with a single hash & probe
+	bool inserted = false;
+	id.hash = table->_strings->_hash((char*)str);
+	size_t pos = _umap_str_find_or_emplace_index(&table->_strings, (char*)str, id.hash, &inserted);
+	if (pos == SIZE_MAX) { 
+		id.hash = 0;
+		return id; 
+	}
+	id.str = *_umap_str_node_key(table->_strings, pos);
+	return id;
+}
+
+StringId _string_table_find(string_table_t* table, const char* str) {
+	// Error check
+	StringId id = { 0 };
+	if (!table || !str) { return id; }
+
+	_umap_str_hash_t h = table->_strings->_hash((char*)str);
+	size_t pos = _umap_str_find_index(table->_strings, (char*)str, h);
+	if (pos != SIZE_MAX) {
+		id.hash = h;
+		id.str = *_umap_str_node_key(table->_strings, pos);
+	}
+	return id;
+}
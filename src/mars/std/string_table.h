@@ -0,0 +1,65 @@
+#ifndef MARS_STD_STRING_TABLE_H
+#define MARS_STD_STRING_TABLE_H
+/**
+ * string_table.h
+ * Table of interned strings.
+ * Each unique string is stored once, so interned strings can be compared by address.
+*/
+#include "mars/std/utilities.h"
+#include "mars/std/unordered_map_str.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/// @brief Create a new string table.
+/// @return Table pointer
+#define string_table_create() _string_table_factory()
+
+/// @brief Deallocate a string table, invalidating every string interned in it.
+/// @param t Table pointer
+#define string_table_destroy(t) _string_table_destroy(t)
+
+/// @brief Add the string to the table if it does not already exist.
+/// @param t Table pointer
+/// @param s NULL-terminated string
+/// @return String ID pointing at the stable interned copy, or a NULL ID on failure
+#define string_table_intern(t, s) _string_table_intern(t, s)
+
+/// @brief Find the interned copy of the string if it exists in the table.
+/// @param t Table pointer
+/// @param s NULL-terminated string
+/// @return String ID pointing at the interned copy, or a NULL ID if not found
+#define string_table_find(t, s) _string_table_find(t, s)
+
+/// @brief Get the number of strings in the table.
+/// @param t Table pointer
+/// @return Table size
+#define string_table_size(t) ((t)->_strings->_length)
+
+/// @brief String paired with its precomputed hash (_umap_str_hash), valid for any map using the default hash function.
+typedef struct {
+	_umap_str_hash_t hash;
+	char* str;
+} StringId;
+
+/// @brief Table of interned strings.
+typedef struct {
+	unordered_map_str_t* _strings;
+} string_table_t;
+
+/// @brief Hash a string without interning it. The ID borrows the given pointer.
+/// @param _str NULL-terminated string
+/// @return String ID
+StringId string_id_make(const char* _str);
+
+string_table_t* _string_table_factory();
+
+void _string_table_destroy(string_table_t*);
+
+StringId _string_table_intern(string_table_t*, const char*);
+
+StringId _string_table_find(string_table_t*, const char*);
+
+#endif // MARS_STD_STRING_TABLE_H
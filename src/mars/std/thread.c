@@ -0,0 +1,307 @@
+#include "mars/std/thread.h"
+#include "mars/std/debug.h"
+#if !defined(MARS_OS_WINDOWS)
+#include <unistd.h>
+#endif
+
+typedef struct {
+	mars_thread_fn_t _fn;
+	void* _arg;
+} _mars_thread_start_t;
+
+#if defined(MARS_OS_WINDOWS)
+static DWORD WINAPI _mars_thread_entry(LPVOID arg) {
+#else
+static void* _mars_thread_entry(void* arg) {
+#endif
+	_mars_thread_start_t start = *(_mars_thread_start_t*)arg;
+	MARS_FREE(arg);
+	start._fn(start._arg);
+	return 0;
+}
+
+bool mars_thread_create(mars_thread_t* _thread, mars_thread_fn_t _fn, void* _arg) {
+	if (!_thread || !_fn) { return false; }
+	_mars_thread_start_t* start = MARS_MALLOC(sizeof(*start));
+	if (!start) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate thread start arguments!");
+		return false;
+	}
+	start->_fn = _fn;
+	start->_arg = _arg;
+#if defined(MARS_OS_WINDOWS)
+	*_thread = CreateThread(NULL, 0, _mars_thread_entry, start, 0, NULL);
+	if (*_thread == NULL) {
+#else
+	if (pthread_create(_thread, NULL, _mars_thread_entry, start) != 0) {
+#endif
+		MARS_FREE(start);
+		return false;
+	}
+	return true;
+}
+
+void mars_thread_join(mars_thread_t _thread) {
+#if defined(MARS_OS_WINDOWS)
+	WaitForSingleObject(_thread, INFINITE);
+	CloseHandle(_thread);
+#else
+	pthread_join(_thread, NULL);
+#endif
+}
+
+unsigned int mars_thread_hardware_concurrency() {
+#if defined(MARS_OS_WINDOWS)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	long count = (long)info.dwNumberOfProcessors;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return (count > 0) ? (unsigned int)count : 1;
+}
+
+void mars_mutex_init(mars_mutex_t* _mutex) {
+#if defined(MARS_OS_WINDOWS)
+	InitializeCriticalSection(_mutex);
+#else
+	pthread_mutex_init(_mutex, NULL);
+#endif
+}
+
+void mars_mutex_destroy(mars_mutex_t* _mutex) {
+#if defined(MARS_OS_WINDOWS)
+	DeleteCriticalSection(_mutex);
+#else
+	pthread_mutex_destroy(_mutex);
+#endif
+}
+
+void mars_mutex_lock(mars_mutex_t* _mutex) {
+#if defined(MARS_OS_WINDOWS)
+	EnterCriticalSection(_mutex);
+#else
+	pthread_mutex_lock(_mutex);
+#endif
+}
+
+void mars_mutex_unlock(mars_mutex_t* _mutex) {
+#if defined(MARS_OS_WINDOWS)
+	LeaveCriticalSection(_mutex);
+#else
+	pthread_mutex_unlock(_mutex);
+#endif
+}
+
+void mars_cond_init(mars_cond_t* _cond) {
+#if defined(MARS_OS_WINDOWS)
+	InitializeConditionVariable(_cond);
+#else
+	pthread_cond_init(_cond, NULL);
+#endif
+}
+
+void mars_cond_destroy(mars_cond_t* _cond) {
+#if defined(MARS_OS_WINDOWS)
+	(void)_cond;
+#else
+	pthread_cond_destroy(_cond);
+#endif
+}
+
+void mars_cond_wait(mars_cond_t* _cond, mars_mutex_t* _mutex) {
+#if defined(MARS_OS_WINDOWS)
+	SleepConditionVariableCS(_cond, _mutex, INFINITE);
+#else
+	pthread_cond_wait(_cond, _mutex);
+#endif
+}
+
+void mars_cond_signal(mars_cond_t* _cond) {
+#if defined(MARS_OS_WINDOWS)
+	WakeConditionVariable(_cond);
+#else
+	pthread_cond_signal(_cond);
+#endif
+}
+
+void mars_cond_broadcast(mars_cond_t* _cond) {
+#if defined(MARS_OS_WINDOWS)
+	WakeAllConditionVariable(_cond);
+#else
+	pthread_cond_broadcast(_cond);
+#endif
+}
+
+// Shared state for one parallel for, freed by whichever participant releases it last
+typedef struct {
+	thread_pool_for_fn_t _fn;
+	void* _arg;
+	size_t _count;
+	size_t _next;
+	size_t _done;
+	size_t _refs;
+	mars_mutex_t _lock;
+	mars_cond_t _finished;
+} _thread_pool_for_t;
+
+static void _thread_pool_worker(void* arg) {
+	thread_pool_t* pool = (thread_pool_t*)arg;
+	mars_mutex_lock(&pool->_lock);
+	while (true) {
+		// Sleep until there is work, only exiting once the queue has been drained
+		while (queue_size(pool->_jobs) == 0 && !pool->_shutdown) {
+			mars_cond_wait(&pool->_work, &pool->_lock);
+		}
+		if (queue_size(pool->_jobs) == 0) { break; }
+		_thread_pool_job_t job = *(_thread_pool_job_t*)queue_head(pool->_jobs);
+		queue_pop(pool->_jobs);
+		pool->_active++;
+
+		// Run the job unlocked
+		mars_mutex_unlock(&pool->_lock);
+		job._fn(job._arg);
+		mars_mutex_lock(&pool->_lock);
+		pool->_active--;
+		if (pool->_active == 0 && queue_size(pool->_jobs) == 0) {
+			mars_cond_broadcast(&pool->_idle);
+		}
+	}
+	mars_mutex_unlock(&pool->_lock);
+}
+
+thread_pool_t* thread_pool_create(size_t _thread_count) {
+	if (_thread_count == 0) {
+		unsigned int hw = mars_thread_hardware_concurrency();
+		_thread_count = (hw > 1) ? hw - 1 : 1;
+	}
+	thread_pool_t* pool = MARS_CALLOC(1, offsetof(thread_pool_t, _threads) + (_thread_count * sizeof(mars_thread_t)));
+	if (!pool) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate thread pool!");
+		return NULL;
+	}
+	pool->_jobs = queue_create(_thread_pool_job_t);
+	if (!pool->_jobs) {
+		MARS_FREE(pool);
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate thread pool job queue!");
+		return NULL;
+	}
+	mars_mutex_init(&pool->_lock);
+	mars_cond_init(&pool->_work);
+	mars_cond_init(&pool->_idle);
+
+	// Start workers, keeping however many started successfully
+	for (size_t i = 0; i < _thread_count; ++i) {
+		if (!mars_thread_create(&pool->_threads[i], _thread_pool_worker, pool)) { break; }
+		pool->_thread_count++;
+	}
+	if (pool->_thread_count == 0) {
+		MARS_DEBUG_WARN("Failed to start any worker threads!");
+		thread_pool_destroy(pool);
+		return NULL;
+	}
+	return pool;
+}
+
+void thread_pool_destroy(thread_pool_t* _pool) {
+	if (!_pool) { return; }
+	mars_mutex_lock(&_pool->_lock);
+	_pool->_shutdown = true;
+	mars_cond_broadcast(&_pool->_work);
+	mars_mutex_unlock(&_pool->_lock);
+	for (size_t i = 0; i < _pool->_thread_count; ++i) {
+		mars_thread_join(_pool->_threads[i]);
+	}
+	mars_cond_destroy(&_pool->_idle);
+	mars_cond_destroy(&_pool->_work);
+	mars_mutex_destroy(&_pool->_lock);
+	queue_destroy(_pool->_jobs);
+	MARS_FREE(_pool);
+}
+
+bool thread_pool_submit(thread_pool_t* _pool, thread_pool_fn_t _fn, void* _arg) {
+	if (!_pool || !_fn) { return false; }
+	_thread_pool_job_t job = { ._fn = _fn, ._arg = _arg };
+	mars_mutex_lock(&_pool->_lock);
+	bool queued = !_pool->_shutdown && queue_push(_pool->_jobs, &job) != NULL;
+	if (queued) { mars_cond_signal(&_pool->_work); }
+	mars_mutex_unlock(&_pool->_lock);
+	return queued;
+}
+
+void thread_pool_wait(thread_pool_t* _pool) {
+	if (!_pool) { return; }
+	mars_mutex_lock(&_pool->_lock);
+	while (_pool->_active > 0 || queue_size(_pool->_jobs) > 0) {
+		mars_cond_wait(&_pool->_idle, &_pool->_lock);
+	}
+	mars_mutex_unlock(&_pool->_lock);
+}
+
+static void _thread_pool_for_release(_thread_pool_for_t* _for) {
+	mars_mutex_lock(&_for->_lock);
+	bool last = (--_for->_refs == 0);
+	mars_mutex_unlock(&_for->_lock);
+	if (last) {
+		mars_cond_destroy(&_for->_finished);
+		mars_mutex_destroy(&_for->_lock);
+		MARS_FREE(_for);
+	}
+}
+
+static void _thread_pool_for_work(_thread_pool_for_t* _for) {
+	while (true) {
+		mars_mutex_lock(&_for->_lock);
+		size_t index = _for->_next;
+		if (index < _for->_count) { _for->_next++; }
+		mars_mutex_unlock(&_for->_lock);
+		if (index >= _for->_count) { return; }
+
+		_for->_fn(_for->_arg, index);
+
+		mars_mutex_lock(&_for->_lock);
+		if (++_for->_done == _for->_count) { mars_cond_broadcast(&_for->_finished); }
+		mars_mutex_unlock(&_for->_lock);
+	}
+}
+
+static void _thread_pool_for_job(void* _arg) {
+	_thread_pool_for_work((_thread_pool_for_t*)_arg);
+	_thread_pool_for_release((_thread_pool_for_t*)_arg);
+}
+
+void thread_pool_parallel_for(thread_pool_t* _pool, size_t _count, thread_pool_for_fn_t _fn, void* _arg) {
+	if (!_fn || _count == 0) { return; }
+	_thread_pool_for_t* pfor = (_pool && _count > 1) ? MARS_MALLOC(sizeof(*pfor)) : NULL;
+	if (!pfor) {
+		for (size_t i = 0; i < _count; ++i) { _fn(_arg, i); }
+		return;
+	}
+	pfor->_fn = _fn;
+	pfor->_arg = _arg;
+	pfor->_count = _count;
+	pfor->_next = 0;
+	pfor->_done = 0;
+	pfor->_refs = 1;
+	mars_mutex_init(&pfor->_lock);
+	mars_cond_init(&pfor->_finished);
+
+	// Jobs that start after every index is taken just drop their reference
+	size_t helpers = (_pool->_thread_count < _count - 1) ? _pool->_thread_count : _count - 1;
+	for (size_t i = 0; i < helpers; ++i) {
+		mars_mutex_lock(&pfor->_lock);
+		pfor->_refs++;
+		mars_mutex_unlock(&pfor->_lock);
+		if (!thread_pool_submit(_pool, _thread_pool_for_job, pfor)) {
+			_thread_pool_for_release(pfor);
+			break;
+		}
+	}
+	_thread_pool_for_work(pfor);
+	mars_mutex_lock(&pfor->_lock);
+	while (pfor->_done < pfor->_count) {
+		mars_cond_wait(&pfor->_finished, &pfor->_lock);
+	}
+	mars_mutex_unlock(&pfor->_lock);
+	_thread_pool_for_release(pfor);
+}
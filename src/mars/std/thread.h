@@ -0,0 +1,158 @@
+#ifndef MARS_STD_THREAD_H
+#define MARS_STD_THREAD_H
+/**
+ * thread.h
+ * Platform threading primitives & a fixed size worker pool.
+*/
+#include "mars/std/platform.h"
+#include "mars/std/utilities.h"
+#include "mars/std/queue.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(MARS_OS_WINDOWS)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+typedef HANDLE mars_thread_t;
+typedef CRITICAL_SECTION mars_mutex_t;
+typedef CONDITION_VARIABLE mars_cond_t;
+#else
+#include <pthread.h>
+typedef pthread_t mars_thread_t;
+typedef pthread_mutex_t mars_mutex_t;
+typedef pthread_cond_t mars_cond_t;
+#endif
+
+typedef void (*mars_thread_fn_t)(void*);
+
+
+//----------------------------------------------------------------------------------
+// Threads
+//----------------------------------------------------------------------------------
+
+/// @brief Start a new thread.
+/// @param _thread Thread handle to fill
+/// @param _fn Thread entry point
+/// @param _arg Argument passed to the entry point
+/// @return True if the thread was started
+bool mars_thread_create(mars_thread_t* _thread, mars_thread_fn_t _fn, void* _arg);
+
+/// @brief Block until the thread exits & release its handle.
+/// @param _thread Thread handle
+void mars_thread_join(mars_thread_t _thread);
+
+/// @brief Get the number of hardware threads available to the process.
+/// @return Thread count (at least 1)
+unsigned int mars_thread_hardware_concurrency();
+
+
+//----------------------------------------------------------------------------------
+// Mutexes & condition variables
+//----------------------------------------------------------------------------------
+
+/// @brief Initialize a mutex.
+/// @param _mutex Mutex pointer
+void mars_mutex_init(mars_mutex_t* _mutex);
+
+/// @brief Release a mutex.
+/// @param _mutex Mutex pointer
+void mars_mutex_destroy(mars_mutex_t* _mutex);
+
+/// @brief Acquire a mutex, blocking until it is available.
+/// @param _mutex Mutex pointer
+void mars_mutex_lock(mars_mutex_t* _mutex);
+
+/// @brief Release an acquired mutex.
+/// @param _mutex Mutex pointer
+void mars_mutex_unlock(mars_mutex_t* _mutex);
+
+/// @brief Initialize a condition variable.
+/// @param _cond Condition variable pointer
+void mars_cond_init(mars_cond_t* _cond);
+
+/// @brief Release a condition variable.
+/// @param _cond Condition variable pointer
+void mars_cond_destroy(mars_cond_t* _cond);
+
+/// @brief Atomically release the mutex & wait for the condition to be signalled, then reacquire the mutex.
+/// @param _cond Condition variable pointer
+/// @param _mutex Acquired mutex pointer
+void mars_cond_wait(mars_cond_t* _cond, mars_mutex_t* _mutex);
+
+/// @brief Wake one thread waiting on the condition.
+/// @param _cond Condition variable pointer
+void mars_cond_signal(mars_cond_t* _cond);
+
+/// @brief Wake every thread waiting on the condition.
+/// @param _cond Condition variable pointer
+void mars_cond_broadcast(mars_cond_t* _cond);
+
+
+//----------------------------------------------------------------------------------
+// Thread pool
+//----------------------------------------------------------------------------------
+
+typedef void (*thread_pool_fn_t)(void*);
+
+typedef struct {
+	thread_pool_fn_t _fn;
+	void* _arg;
+} _thread_pool_job_t;
+
+/// @brief Fixed group of worker threads executing jobs in FIFO order.
+typedef struct {
+	mars_mutex_t _lock;
+	mars_cond_t _work;
+	mars_cond_t _idle;
+	queue_t* _jobs;
+	size_t _active;
+	size_t _thread_count;
+	bool _shutdown;
+	mars_thread_t _threads[];
+} thread_pool_t;
+
+/// @brief Create a new thread pool.
+/// @param _thread_count Number of worker threads (if 0, use one less than the hardware thread count)
+/// @return Pool pointer
+thread_pool_t* thread_pool_create(size_t _thread_count);
+
+/// @brief Finish all queued jobs, then stop & deallocate the pool.
+/// @param _pool Pool pointer
+void thread_pool_destroy(thread_pool_t* _pool);
+
+/// @brief Queue a job to run on a worker thread.
+/// @param _pool Pool pointer
+/// @param _fn Job function
+/// @param _arg Argument passed to the job
+/// @return True if the job was queued
+bool thread_pool_submit(thread_pool_t* _pool, thread_pool_fn_t _fn, void* _arg);
+
+/// @brief Block until every queued job has finished.
+/// @param _pool Pool pointer
+void thread_pool_wait(thread_pool_t* _pool);
+
+typedef void (*thread_pool_for_fn_t)(void* _arg, size_t _index);
+
+/// @brief Call a function once for every index in [0, _count), shared between the calling thread & the pool's workers.
+/// Returns once every call has finished. The calling thread takes indices too, so this is safe to use from a worker
+/// & finishes even if every worker is busy. Without a pool every index runs on the calling thread.
+/// @param _pool Pool pointer (may be NULL)
+/// @param _count Number of indices
+/// @param _fn Function to call
+/// @param _arg Argument passed to every call
+void thread_pool_parallel_for(thread_pool_t* _pool, size_t _count, thread_pool_for_fn_t _fn, void* _arg);
+
+/// @brief Get the number of worker threads in the pool.
+/// @param p Pool pointer
+/// @return Thread count
+#define thread_pool_size(p) ((p)->_thread_count)
+
+#endif // MARS_STD_THREAD_H
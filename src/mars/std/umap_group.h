@@ -0,0 +1,129 @@
+#ifndef MARS_STD_UMAP_GROUP_H
+#define MARS_STD_UMAP_GROUP_H
+/**
+ * umap_group.h
+ * Control byte group scanning for the Swiss Table containers.
+ * A group is a window of 16 control bytes that is compared in one pass, producing a bitmask of matching slots.
+ * Control bytes are either full (0b0xxx xxxx, lower 7 bits of the hash), empty (0x80), deleted (0xFE) or sentinel (0xFF).
+*/
+#include "mars/std/platform.h"
+#include "mars/std/utilities.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(MARS_SIMD_SSE2)
+#include <emmintrin.h>
+#elif defined(MARS_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#define _UMAP_GROUP_WIDTH 16
+
+// Number of bits used per control byte in a group mask is (1 << _UMAP_GROUP_SHIFT)
+#if defined(MARS_SIMD_NEON)
+#define _UMAP_GROUP_SHIFT 2
+#else
+#define _UMAP_GROUP_SHIFT 0
+#endif
+
+#define _UMAP_GROUP_LSBS 0x0101010101010101ULL
+#define _UMAP_GROUP_MSBS 0x8080808080808080ULL
+
+typedef uint64_t _umap_group_mask_t;
+
+/// @brief Get the slot offset of the lowest set bit in a non-zero group mask.
+/// @param m Group mask
+#define _umap_group_mask_index(m) (ctz64(m) >> _UMAP_GROUP_SHIFT)
+
+/// @brief Get the slot offset of the highest set bit in a non-zero group mask.
+/// @param m Group mask
+#define _umap_group_mask_last(m) ((63 - clz64(m)) >> _UMAP_GROUP_SHIFT)
+
+/// @brief Clear the lowest set bit in a group mask.
+/// @param m Group mask
+#define _umap_group_mask_next(m) ((m) & ((m) - 1))
+
+#if defined(MARS_SIMD_SSE2)
+
+static inline _umap_group_mask_t _umap_group_match(const uint8_t* ctrl, uint8_t h2) {
+	__m128i g = _mm_loadu_si128((const __m128i*)ctrl);
+	return (_umap_group_mask_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)h2), g));
+}
+
+static inline _umap_group_mask_t _umap_group_match_empty(const uint8_t* ctrl) {
+	__m128i g = _mm_loadu_si128((const __m128i*)ctrl);
+	return (_umap_group_mask_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)0x80), g));
+}
+
+static inline _umap_group_mask_t _umap_group_match_empty_or_deleted(const uint8_t* ctrl) {
+	// Empty & deleted are the only signed values below the sentinel (-1)
+	__m128i g = _mm_loadu_si128((const __m128i*)ctrl);
+	return (_umap_group_mask_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8((char)0xFF), g));
+}
+
+#elif defined(MARS_SIMD_NEON)
+
+static inline _umap_group_mask_t _umap_group_movemask(uint8x16_t v) {
+	// Narrow each byte to a nibble, then keep one bit per nibble so masks can be popped bit by bit
+	uint8x8_t n = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+	return vget_lane_u64(vreinterpret_u64_u8(n), 0) & 0x8888888888888888ULL;
+}
+
+static inline _umap_group_mask_t _umap_group_match(const uint8_t* ctrl, uint8_t h2) {
+	return _umap_group_movemask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(h2)));
+}
+
+static inline _umap_group_mask_t _umap_group_match_empty(const uint8_t* ctrl) {
+	return _umap_group_movemask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(0x80)));
+}
+
+static inline _umap_group_mask_t _umap_group_match_empty_or_deleted(const uint8_t* ctrl) {
+	int8x16_t g = vreinterpretq_s8_u8(vld1q_u8(ctrl));
+	return _umap_group_movemask(vcltq_s8(g, vdupq_n_s8(-1)));
+}
+
+#else
+
+static inline uint64_t _umap_group_swar_movemask(uint64_t x) {
+	// Gather the high bit of each byte into the low 8 bits
+	return ((x >> 7) * 0x0102040810204080ULL) >> 56;
+}
+
+static inline void _umap_group_swar_load(const uint8_t* ctrl, uint64_t* lo, uint64_t* hi) {
+	memcpy(lo, ctrl, sizeof(*lo));
+	memcpy(hi, ctrl + sizeof(*lo), sizeof(*hi));
+}
+
+static inline uint64_t _umap_group_swar_match_word(uint64_t w, uint8_t h2) {
+	// May report a false positive for a full byte directly after a true match, callers always verify the key
+	uint64_t x = w ^ (_UMAP_GROUP_LSBS * h2);
+	return _umap_group_swar_movemask((x - _UMAP_GROUP_LSBS) & ~x & _UMAP_GROUP_MSBS);
+}
+
+static inline _umap_group_mask_t _umap_group_match(const uint8_t* ctrl, uint8_t h2) {
+	uint64_t lo, hi;
+	_umap_group_swar_load(ctrl, &lo, &hi);
+	return _umap_group_swar_match_word(lo, h2) | (_umap_group_swar_match_word(hi, h2) << 8);
+}
+
+static inline _umap_group_mask_t _umap_group_match_empty(const uint8_t* ctrl) {
+	// High bit set & bit 1 clear is only true for empty
+	uint64_t lo, hi;
+	_umap_group_swar_load(ctrl, &lo, &hi);
+	lo = _umap_group_swar_movemask(lo & ~(lo << 6) & _UMAP_GROUP_MSBS);
+	hi = _umap_group_swar_movemask(hi & ~(hi << 6) & _UMAP_GROUP_MSBS);
+	return lo | (hi << 8);
+}
+
+static inline _umap_group_mask_t _umap_group_match_empty_or_deleted(const uint8_t* ctrl) {
+	// High bit set & bit 0 clear is only true for empty or deleted
+	uint64_t lo, hi;
+	_umap_group_swar_load(ctrl, &lo, &hi);
+	lo = _umap_group_swar_movemask(lo & ~(lo << 7) & _UMAP_GROUP_MSBS);
+	hi = _umap_group_swar_movemask(hi & ~(hi << 7) & _UMAP_GROUP_MSBS);
+	return lo | (hi << 8);
+}
+
+#endif
+
+#endif // MARS_STD_UMAP_GROUP_H
@@ -1,21 +1,30 @@
 #include "mars/std/unordered_map.h"
 #include "mars/std/debug.h"
 
+size_t _umap_node_align(size_t element_size) {
+	// Largest power of 2 dividing the element size (at most 8), but never less than the key alignment
+	size_t align = umin(element_size & (~element_size + 1), 8);
+	return umax(align, sizeof(_umap_key_t));
+}
+
 size_t _umap_node_size(size_t element_size) {
-	size_t key_size = sizeof(_umap_key_t);
-	size_t size_max = umax(element_size, key_size);
-	return (element_size + key_size + (size_max - 1)) & ~(size_max - 1);
+	// Key first, then the data at the node alignment, padded so the next node stays aligned
+	size_t align = _umap_node_align(element_size);
+	return (align + element_size + (align - 1)) & ~(align - 1);
 }
 
 size_t _umap_size(size_t element_size, size_t capacity) {
 	size_t n = _umap_node_size(element_size);
 	size_t c = n * capacity;
 	if (c / capacity != n) { return 0; }
-	if (c > SIZE_MAX - capacity) { return 0; }
-	return umax(sizeof(unordered_map_t), offsetof(unordered_map_t, _buffer) + capacity + c);
+	size_t ctrl_size = _umap_ctrl_size(capacity);
+	if (c > SIZE_MAX - ctrl_size) { return 0; }
+	return umax(sizeof(unordered_map_t), offsetof(unordered_map_t, _buffer) + ctrl_size + c);
 }
 
 unordered_map_t* _umap_factory(size_t element_size, size_t capacity) {
+	// Groups are probed as a whole, so the table must be at least one group wide
+	capacity = umax(capacity, _UMAP_GROUP_WIDTH);
 	size_t buffer_size = _umap_size(element_size, capacity);
 	if (buffer_size == 0) { return NULL; }
 	unordered_map_t* umap = MARS_CALLOC(1, buffer_size);
@@ -25,10 +34,158 @@ unordered_map_t* _umap_factory(size_t element_size, size_t capacity) {
 	}
 	umap->_capacity = capacity;
 	umap->_element_size = element_size;
-	memset(_umap_ctrl(umap, 0), _UMAP_EMPTY, capacity);
+	memset(_umap_ctrl(umap, 0), _UMAP_EMPTY, _umap_ctrl_size(capacity));
 	return umap;
 }
 
+static void _umap_set_ctrl(unordered_map_t* umap, size_t pos, uint8_t ctrl) {
+	*_umap_ctrl(umap, pos) = ctrl;
+
+	// Mirror the first group past the end of the control block
+	if (pos < _UMAP_GROUP_WIDTH) {
+		*_umap_ctrl(umap, umap->_capacity + pos) = ctrl;
+	}
+}
+
+static size_t _umap_find_free(unordered_map_t* umap, _umap_hash_t h) {
+	// Triangular probe over groups until one has an empty or deleted slot
+	size_t mask = umap->_capacity - 1;
+	size_t pos = _umap_h1(h) & mask;
+	size_t stride = 0;
+	while (1) {
+		_umap_group_mask_t m = _umap_group_match_empty_or_deleted(_umap_ctrl(umap, pos));
+		if (m) {
+			return (pos + _umap_group_mask_index(m)) & mask;
+		}
+		stride += _UMAP_GROUP_WIDTH;
+		pos = (pos + stride) & mask;
+	}
+}
+
+static size_t _umap_find_index(unordered_map_t* umap, _umap_key_t key) {
+	// Hash key again
+	_umap_hash_t h = _umap_hash(key);
+	uint8_t h2 = (uint8_t)_umap_h2(h);
+	size_t mask = umap->_capacity - 1;
+	size_t pos = _umap_h1(h) & mask;
+	size_t stride = 0;
+
+	// Triangular probe over groups, this visits every group once before repeating
+	do {
+		uint8_t* group = _umap_ctrl(umap, pos);
+
+		// Verify keys for every control byte matching the lower byte of the hash
+		for (_umap_group_mask_t m = _umap_group_match(group, h2); m; m = _umap_group_mask_next(m)) {
+			size_t i = (pos + _umap_group_mask_index(m)) & mask;
+			if (key == *(_umap_node_key(umap, i))) {
+				return i;
+			}
+		}
+
+		// Empty slot marks the end of the bucket chain
+		if (_umap_group_match_empty(group)) {
+			break;
+		}
+		stride += _UMAP_GROUP_WIDTH;
+		pos = (pos + stride) & mask;
+	} while (stride <= umap->_capacity);
+	return SIZE_MAX;
+}
+
+static void* _umap_emplace(unordered_map_t* umap, _umap_hash_t h, _umap_key_t key, void* data) {
+	size_t pos = _umap_find_free(umap, h);
+
+	// Reusing a tombstone does not add to the load
+	if (*_umap_ctrl(umap, pos) == _UMAP_EMPTY) {
+		umap->_load_count++;
+	}
+
+	// Save lower 7 bits of hash to the control block
+	_umap_set_ctrl(umap, pos, (uint8_t)_umap_h2(h));
+
+	// Save the key to the start of the node block
+	size_t dest_size = sizeof(_umap_key_t);
+	memcpy_s(_umap_node_key(umap, pos), dest_size, &key, dest_size);
+
+	// Save the data to the end of the node block, aligned by the larger data type
+	dest_size = umap->_element_size;
+	if (data) {
+		memcpy_s(_umap_node_data(umap, pos), dest_size, data, dest_size);
+	}
+	else {
+		memset(_umap_node_data(umap, pos), 0, dest_size);
+	}
+	umap->_length++;
+	return _umap_node_data(umap, pos);
+}
+
+static size_t _umap_capacity_for(size_t count) {
+	// Smallest power of 2 that holds the given number of elements under the max load factor
+	size_t c = (size_t)((float)count / _UMAP_DEFAULT_LOAD) + 1;
+	c = umax(c, _UMAP_GROUP_WIDTH);
+	return umin(MARS_NEXT_POW2(c), UMAP_MAX_CAPACITY);
+}
+
+static bool _umap_was_never_full(unordered_map_t* umap, size_t pos) {
+	// If every group containing this slot also contains an empty slot, no probe sequence ever continued past it
+	size_t mask = umap->_capacity - 1;
+	_umap_group_mask_t empty_before = _umap_group_match_empty(_umap_ctrl(umap, (pos - _UMAP_GROUP_WIDTH) & mask));
+	_umap_group_mask_t empty_after = _umap_group_match_empty(_umap_ctrl(umap, pos));
+	if (!empty_before || !empty_after) { return false; }
+	size_t run = _umap_group_mask_index(empty_after) + (_UMAP_GROUP_WIDTH - 1 - _umap_group_mask_last(empty_before));
+	return run < _UMAP_GROUP_WIDTH;
+}
+
+static void _umap_drop_deleted(unordered_map_t* umap) {
+	size_t mask = umap->_capacity - 1;
+	size_t node_size = _umap_node_size(umap->_element_size);
+	uint8_t* tmp_node = MARS_MALLOC(node_size);
+	if (!tmp_node) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate unordered_map rehash buffer!");
+		return;
+	}
+
+	// Mark tombstones as empty & full slots as deleted, deleted now means "waiting to be rehashed"
+	for (size_t i = 0; i < umap->_capacity; ++i) {
+		uint8_t* ctrl = _umap_ctrl(umap, i);
+		*ctrl = ((*ctrl) & _UMAP_EMPTY) ? _UMAP_EMPTY : _UMAP_DELETED;
+	}
+	memcpy_s(_umap_ctrl(umap, umap->_capacity), _UMAP_GROUP_WIDTH, _umap_ctrl(umap, 0), _UMAP_GROUP_WIDTH);
+
+	// Move every element to the first free slot of its own probe sequence
+	for (size_t i = 0; i < umap->_capacity; ++i) {
+		if (*_umap_ctrl(umap, i) != _UMAP_DELETED) { continue; }
+		_umap_hash_t h = _umap_hash(*_umap_node_key(umap, i));
+		uint8_t h2 = (uint8_t)_umap_h2(h);
+		size_t start = _umap_h1(h) & mask;
+		size_t pos = _umap_find_free(umap, h);
+
+		// Element already sits in the first group it would be probed in
+		if ((((pos - start) & mask) / _UMAP_GROUP_WIDTH) == (((i - start) & mask) / _UMAP_GROUP_WIDTH)) {
+			_umap_set_ctrl(umap, i, h2);
+			continue;
+		}
+
+		if (*_umap_ctrl(umap, pos) == _UMAP_EMPTY) {
+			// Move to the free slot
+			memcpy_s(_umap_node(umap, pos), node_size, _umap_node(umap, i), node_size);
+			_umap_set_ctrl(umap, pos, h2);
+			_umap_set_ctrl(umap, i, _UMAP_EMPTY);
+		}
+		else {
+			// Swap with the element still waiting to be rehashed, then process this slot again
+			memcpy_s(tmp_node, node_size, _umap_node(umap, pos), node_size);
+			memcpy_s(_umap_node(umap, pos), node_size, _umap_node(umap, i), node_size);
+			memcpy_s(_umap_node(umap, i), node_size, tmp_node, node_size);
+			_umap_set_ctrl(umap, pos, h2);
+			--i;
+		}
+	}
+
+	umap->_load_count = umap->_length;
+	MARS_FREE(tmp_node);
+}
+
 unordered_map_t* _umap_resize(unordered_map_t* umap, size_t new_capacity) {
 	// Calculate new capacity
 	if (new_capacity == 0) {
@@ -41,13 +198,12 @@ unordered_map_t* _umap_resize(unordered_map_t* umap, size_t new_capacity) {
 	unordered_map_t* new_umap = _umap_factory(umap->_element_size, new_capacity);
 	if (!new_umap) { return NULL; }
 
-	// Rehash data
+	// Rehash data, keys are already unique so skip the lookup
 	for (size_t i = 0; i < umap->_capacity; ++i) {
 		uint8_t* ctrl = _umap_ctrl(umap, i);
 		if (!((*ctrl) & _UMAP_EMPTY)) {
-			_umap_key_t* _key = _umap_node_key(umap, i);
-			void* _data = _umap_node_data(umap, i);
-			_umap_insert(&new_umap, *_key, _data);
+			_umap_key_t key = *_umap_node_key(umap, i);
+			_umap_emplace(new_umap, _umap_hash(key), key, _umap_node_data(umap, i));
 		}
 	}
 
@@ -73,79 +229,38 @@ void* _umap_insert(unordered_map_t** umap, _umap_key_t key, void* data) {
 	void* elem = _umap_find(_umap, key);
 	if (elem) { return elem; }
 
-	// Resize if needed
+	// Reclaim tombstones in place if they make up most of the load, otherwise resize
 	if (_umap->_load_count / (float)_umap->_capacity >= _UMAP_DEFAULT_LOAD) {
-		unordered_map_t* temp = _umap_resize(_umap, 0);
-		if (!temp) { return NULL; }
-		(*umap) = temp;
-		_umap = temp;
-	}
-
-	// Hash the key
-	_umap_hash_t h = _umap_hash(key);
-	size_t pos = _umap_h1(h) & (_umap->_capacity - 1);
-
-	// Linear probe to find an empty bucket
-	while (1) {
-		uint8_t* ctrl = _umap_ctrl(_umap, pos);
-		// Space is empty if high bit is 1
-		if ((*ctrl) & _UMAP_EMPTY) {
-			// Save lower 8 bits of hash to the control block
-			_umap_hash_t h2 = _umap_h2(h);
-			memcpy_s(ctrl, 1, &h2, 1);
-
-			// Save the key to the start of the node block
-			size_t dest_size = sizeof(_umap_key_t);
-			memcpy_s(_umap_node_key(_umap, pos), dest_size, &key, dest_size);
-
-			// Save the data to the end of the node block, aligned by the larger data type
-			dest_size = _umap->_element_size;
-			if (data) {
-				memcpy_s(_umap_node_data(_umap, pos), dest_size, data, dest_size);
-			}
-			else {
-				memset(_umap_node_data(_umap, pos), 0, dest_size);
-			}
-			break;
+		if (_umap->_length * 32 <= _umap->_capacity * 25) {
+			_umap_drop_deleted(_umap);
 		}
 		else {
-			pos = (pos + 1) & (_umap->_capacity - 1);
+			unordered_map_t* temp = _umap_resize(_umap, 0);
+			if (!temp) { return NULL; }
+			(*umap) = temp;
+			_umap = temp;
 		}
 	}
-	_umap->_length++;
-	_umap->_load_count++;
-	return _umap_node_data(_umap, pos);
+
+	// Hash the key & place it in the first free slot along its probe sequence
+	return _umap_emplace(_umap, _umap_hash(key), key, data);
 }
 
 void _umap_delete(unordered_map_t* umap, _umap_key_t key) {
 	// Error check
 	if (!umap) { return; }
 
-	// Hash key again
-	_umap_hash_t h = _umap_hash(key);
-	size_t pos = _umap_h1(h) & (umap->_capacity - 1);
-
-	// Linear probe to find key
-	while (1) {
-		uint8_t* ctrl = _umap_ctrl(umap, pos);
-		// Check if this control byte matches lower byte of hash
-		_umap_hash_t h2 = _umap_h2(h);
-		if (*ctrl == h2) {
-			// Verify key at this pos matches
-			if (key == *(_umap_node_key(umap, pos))) {
-				memset(ctrl, _UMAP_DELETED, 1);
-				umap->_length--;
-				return;
-			}
-		}
-		else if (*ctrl == _UMAP_EMPTY) {
-			// Empty slot marks the end of the bucket chain
-			return;
+	// Find key & free its slot, leaving a tombstone only if a probe sequence may pass through it
+	size_t pos = _umap_find_index(umap, key);
+	if (pos != SIZE_MAX) {
+		if (_umap_was_never_full(umap, pos)) {
+			_umap_set_ctrl(umap, pos, _UMAP_EMPTY);
+			umap->_load_count--;
 		}
 		else {
-			// Look at next control byte
-			pos = (pos + 1) & (umap->_capacity - 1);
+			_umap_set_ctrl(umap, pos, _UMAP_DELETED);
 		}
+		umap->_length--;
 	}
 }
 
@@ -153,32 +268,44 @@ void* _umap_find(unordered_map_t* umap, _umap_key_t key) {
 	// Error check
 	if (!umap) { return NULL; }
 
-	// Hash key again
-	_umap_hash_t h = _umap_hash(key);
-	size_t pos = _umap_h1(h) & (umap->_capacity - 1);
-	size_t first_pos = pos;
+	size_t pos = _umap_find_index(umap, key);
+	return (pos != SIZE_MAX) ? _umap_node_data(umap, pos) : NULL;
+}
 
-	// Linear probe to find key
-	do {
-		uint8_t* ctrl = _umap_ctrl(umap, pos);
-		// Check if this control byte matches lower byte of hash
-		_umap_hash_t h2 = _umap_h2(h);
-		if (*ctrl == h2) {
-			// Verify key at this pos matches
-			if (key == *(_umap_node_key(umap, pos))) {
-				return _umap_node_data(umap, pos);
-			}
-		}
-		else if (*ctrl == _UMAP_EMPTY) {
-			// Empty slot marks the end of the bucket chain
-			return NULL;
-		}
-		else {
-			// Look at next control byte
-			pos = (pos + 1) & (umap->_capacity - 1);
-		}
-	} while(pos != first_pos);
-	return NULL;
+void _umap_reserve(unordered_map_t** umap, size_t count) {
+	// Error check
+	if (!umap || !(*umap)) { return; }
+
+	// Grow so the given number of elements fit without another resize
+	size_t new_capacity = _umap_capacity_for(count);
+	if (new_capacity > (*umap)->_capacity) {
+		unordered_map_t* temp = _umap_resize(*umap, new_capacity);
+		if (temp) { (*umap) = temp; }
+	}
+}
+
+void _umap_shrink_to_fit(unordered_map_t** umap) {
+	// Error check
+	if (!umap || !(*umap)) { return; }
+
+	// Rebuild at the smallest capacity that holds the current elements, which also drops all tombstones
+	size_t new_capacity = _umap_capacity_for((*umap)->_length);
+	if (new_capacity < (*umap)->_capacity) {
+		unordered_map_t* temp = _umap_resize(*umap, new_capacity);
+		if (temp) { (*umap) = temp; }
+	}
+	else if ((*umap)->_load_count > (*umap)->_length) {
+		_umap_drop_deleted(*umap);
+	}
+}
+
+void _umap_clear(unordered_map_t* umap) {
+	// Error check
+	if (!umap) { return; }
+
+	memset(_umap_ctrl(umap, 0), _UMAP_EMPTY, _umap_ctrl_size(umap->_capacity));
+	umap->_length = 0;
+	umap->_load_count = 0;
 }
 
 unordered_map_it_t* _umap_it(unordered_map_t* umap) {
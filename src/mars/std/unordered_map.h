@@ -6,6 +6,7 @@
  * Implemented as a simplified Swiss Table architecture.
 */
 #include "mars/std/utilities.h"
+#include "mars/std/umap_group.h"
 #include <stdlib.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -28,12 +29,13 @@ typedef uint32_t _umap_hash_t;
 #define _UMAP_DELETED 0xFE   // 0b1111 1110
 #define _UMAP_SENTINEL 0xFF  // 0b1111 1111
 
-#define _umap_h1(h) h >> 7
-#define _umap_h2(h) h & 0x7F
-#define _umap_ctrl(u, i) (uint8_t*)(&(u)->_buffer[0] + i)
-#define _umap_node(u, i) (&(u)->_buffer[0] + (u)->_capacity + (_umap_node_size((u)->_element_size) * i))
+#define _umap_h1(h) ((h) >> 7)
+#define _umap_h2(h) ((h) & 0x7F)
+#define _umap_ctrl_size(c) ((c) + _UMAP_GROUP_WIDTH)
+#define _umap_ctrl(u, i) (uint8_t*)(&(u)->_buffer[0] + (i))
+#define _umap_node(u, i) (&(u)->_buffer[0] + _umap_ctrl_size((u)->_capacity) + (_umap_node_size((u)->_element_size) * (i)))
 #define _umap_node_key(u, i) (_umap_key_t*)_umap_node(u, i)
-#define _umap_node_data(u, i) (void*)(_umap_node(u, i) + ((u)->_element_size > sizeof(_umap_key_t) ? (u)->_element_size : sizeof(_umap_key_t)))
+#define _umap_node_data(u, i) (void*)(_umap_node(u, i) + _umap_node_align((u)->_element_size))
 
 /// @brief Create a new unordered map.
 /// @param t Map type
@@ -67,9 +69,23 @@ typedef uint32_t _umap_hash_t;
 /// @return Map size
 #define unordered_map_size(u) ((u)->_length)
 
+/// @brief Grow the map so it can hold at least the given number of elements without resizing.
+/// @param u Map pointer
+/// @param n Number of elements
+#define unordered_map_reserve(u, n) _umap_reserve(&u, n)
+
+/// @brief Shrink the map to the smallest capacity that holds its elements, reclaiming deleted slots.
+/// @param u Map pointer
+#define unordered_map_shrink_to_fit(u) _umap_shrink_to_fit(&u)
+
+/// @brief Get the number of slots allocated for the map.
+/// @param u Map pointer
+/// @return Map capacity
+#define unordered_map_capacity(u) ((u)->_capacity)
+
 /// @brief Remove all elements from the map.
 /// @param u Map pointer
-#define unordered_map_clear(u) memset(_umap_ctrl(u, 0), _UMAP_EMPTY, (u)->_capacity)
+#define unordered_map_clear(u) _umap_clear(u)
 
 /// @brief Create an iterator for the map.
 /// @param u Map pointer
@@ -85,6 +101,7 @@ typedef uint32_t _umap_hash_t;
 #define unordered_map_bytes(u) ((u) ? (_umap_size((u)->_element_size, (u)->_capacity)) : 0)
 
 /// @brief Hash table of key-value pairs.
+/// @brief The control block holds one byte per slot, followed by a copy of the first group so probes never wrap mid-group.
 typedef struct {
 	size_t _length;
 	size_t _capacity;
@@ -101,6 +118,8 @@ typedef struct {
 	size_t _index;
 } unordered_map_it_t;
 
+size_t _umap_node_align(size_t);
+
 size_t _umap_node_size(size_t);
 
 size_t _umap_size(size_t, size_t);
@@ -117,6 +136,12 @@ void _umap_delete(unordered_map_t*, _umap_key_t);
 
 void* _umap_find(unordered_map_t*, _umap_key_t);
 
+void _umap_reserve(unordered_map_t**, size_t);
+
+void _umap_shrink_to_fit(unordered_map_t**);
+
+void _umap_clear(unordered_map_t*);
+
 unordered_map_it_t* _umap_it(unordered_map_t*);
 
 unordered_map_it_t* _umap_it_next(unordered_map_it_t*);
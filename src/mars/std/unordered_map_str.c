@@ -1,10 +1,16 @@
 #include "mars/std/unordered_map_str.h"
 #include "mars/std/debug.h"
 
+size_t _umap_str_node_align(size_t element_size) {
+	// Largest power of 2 dividing the element size (at most 8), but never less than the key alignment
+	size_t align = umin(element_size & (~element_size + 1), 8);
+	return umax(align, sizeof(_umap_str_key_t));
+}
+
 size_t _umap_str_node_size(size_t element_size) {
-	size_t key_size = sizeof(_umap_str_key_t);
-	size_t size_max = umax(element_size, key_size);
-	return (element_size + key_size + (size_max - 1)) & ~(size_max - 1);
+	// Key first, then the data at the node alignment, padded so the next node stays aligned
+	size_t align = _umap_str_node_align(element_size);
+	return (align + element_size + (align - 1)) & ~(align - 1);
 }
 
 size_t _umap_str_size(size_t element_size, size_t capacity) {
@@ -15,7 +21,7 @@ size_t _umap_str_size(size_t element_size, size_t capacity) {
 	return umax(sizeof(unordered_map_str_t), offsetof(unordered_map_str_t, _buffer) + capacity + c);
 }
 
-unordered_map_str_t* _umap_str_factory(size_t element_size, size_t capacity) {
+unordered_map_str_t* _umap_str_factory(size_t element_size, size_t capacity, bool interned, _umap_str_hash_fn_t hash) {
 	size_t buffer_size = _umap_str_size(element_size, capacity);
 	if (buffer_size == 0) { return NULL; }
 	unordered_map_str_t* umap_str = MARS_CALLOC(1, buffer_size);
@@ -25,10 +31,131 @@ unordered_map_str_t* _umap_str_factory(size_t element_size, size_t capacity) {
 	}
 	umap_str->_capacity = capacity;
 	umap_str->_element_size = element_size;
+	umap_str->_interned = (size_t)interned;
+	umap_str->_hash = hash ? hash : _umap_str_hash;
 	memset(_umap_str_ctrl(umap_str, 0), _UMAP_STR_EMPTY, capacity);
 	return umap_str;
 }
 
+static size_t _umap_str_find_free(unordered_map_str_t* umap_str, _umap_str_hash_t h) {
+	// Linear probe to find an empty or deleted bucket
+	size_t pos = _umap_str_h1(h) & (umap_str->_capacity - 1);
+	while (!((*_umap_str_ctrl(umap_str, pos)) & _UMAP_STR_EMPTY)) {
+		pos = (pos + 1) & (umap_str->_capacity - 1);
+	}
+	return pos;
+}
+
+static void* _umap_str_emplace_at(unordered_map_str_t* umap_str, size_t pos, _umap_str_key_t key, _umap_str_hash_t h, void* data) {
+	// Reusing a tombstone does not add to the load
+	if (*_umap_str_ctrl(umap_str, pos) == _UMAP_STR_EMPTY) {
+		umap_str->_load_count++;
+	}
+
+	// Save the key pointer to the start of the node block
+	memcpy_s(_umap_str_node_key(umap_str, pos), sizeof(_umap_str_key_t), &key, sizeof(_umap_str_key_t));
+
+	// Save lower 7 bits of hash to the control block
+	*_umap_str_ctrl(umap_str, pos) = (uint8_t)_umap_str_h2(h);
+
+	// Save the data to the end of the node block, aligned by the larger data type
+	size_t dest_size = umap_str->_element_size;
+	if (data) {
+		memcpy_s(_umap_str_node_data(umap_str, pos), dest_size, data, dest_size);
+	}
+	else {
+		memset(_umap_str_node_data(umap_str, pos), 0, dest_size);
+	}
+	umap_str->_length++;
+	return _umap_str_node_data(umap_str, pos);
+}
+
+static void* _umap_str_emplace(unordered_map_str_t* umap_str, _umap_str_key_t key, _umap_str_hash_t h, void* data) {
+	return _umap_str_emplace_at(umap_str, _umap_str_find_free(umap_str, h), key, h, data);
+}
+
+static bool _umap_str_key_equal(unordered_map_str_t* umap_str, _umap_str_key_t a, _umap_str_key_t b) {
+	// Interned keys are unique per string, so the address is the identity
+	if (a == b) { return true; }
+	return !umap_str->_interned && strcmp(a, b) == 0;
+}
+
+static size_t _umap_str_probe(unordered_map_str_t* umap_str, _umap_str_key_t key, _umap_str_hash_t h, size_t* free_pos) {
+	size_t pos = _umap_str_h1(h) & (umap_str->_capacity - 1);
+	size_t first_pos = pos;
+	uint8_t h2 = (uint8_t)_umap_str_h2(h);
+	*free_pos = SIZE_MAX;
+
+	// Linear probe to find key
+	do {
+		uint8_t ctrl = *_umap_str_ctrl(umap_str, pos);
+		// Check if this control byte matches lower byte of hash
+		if (ctrl == h2) {
+			// Verify key at this pos matches
+			if (_umap_str_key_equal(umap_str, *_umap_str_node_key(umap_str, pos), key)) {
+				return pos;
+			}
+		}
+		else if (ctrl & _UMAP_STR_EMPTY) {
+			// The first tombstone or empty slot is where the key would be inserted
+			if (*free_pos == SIZE_MAX) { *free_pos = pos; }
+
+			// Empty slot marks the end of the bucket chain
+			if (ctrl == _UMAP_STR_EMPTY) { break; }
+		}
+		// Look at next control byte
+		pos = (pos + 1) & (umap_str->_capacity - 1);
+	} while (pos != first_pos);
+	return SIZE_MAX;
+}
+
+static void _umap_str_drop_deleted(unordered_map_str_t* umap_str) {
+	size_t node_size = _umap_str_node_size(umap_str->_element_size);
+	uint8_t* tmp_node = MARS_MALLOC(node_size);
+	if (!tmp_node) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate unordered_map_str rehash buffer!");
+		return;
+	}
+
+	// Mark tombstones as empty & full slots as deleted, deleted now means "waiting to be rehashed"
+	for (size_t i = 0; i < umap_str->_capacity; ++i) {
+		uint8_t* ctrl = _umap_str_ctrl(umap_str, i);
+		*ctrl = ((*ctrl) & _UMAP_STR_EMPTY) ? _UMAP_STR_EMPTY : _UMAP_STR_DELETED;
+	}
+
+	// Move every element to the first free slot of its own probe sequence
+	for (size_t i = 0; i < umap_str->_capacity; ++i) {
+		if (*_umap_str_ctrl(umap_str, i) != _UMAP_STR_DELETED) { continue; }
+		_umap_str_hash_t h = umap_str->_hash(*_umap_str_node_key(umap_str, i));
+		uint8_t h2 = (uint8_t)_umap_str_h2(h);
+		size_t pos = _umap_str_find_free(umap_str, h);
+
+		// Nothing free comes before this slot in its probe sequence
+		if (pos == i) {
+			*_umap_str_ctrl(umap_str, i) = h2;
+			continue;
+		}
+
+		if (*_umap_str_ctrl(umap_str, pos) == _UMAP_STR_EMPTY) {
+			// Move to the free slot
+			memcpy_s(_umap_str_node(umap_str, pos), node_size, _umap_str_node(umap_str, i), node_size);
+			*_umap_str_ctrl(umap_str, pos) = h2;
+			*_umap_str_ctrl(umap_str, i) = _UMAP_STR_EMPTY;
+		}
+		else {
+			// Swap with the element still waiting to be rehashed, then process this slot again
+			memcpy_s(tmp_node, node_size, _umap_str_node(umap_str, pos), node_size);
+			memcpy_s(_umap_str_node(umap_str, pos), node_size, _umap_str_node(umap_str, i), node_size);
+			memcpy_s(_umap_str_node(umap_str, i), node_size, tmp_node, node_size);
+			*_umap_str_ctrl(umap_str, pos) = h2;
+			--i;
+		}
+	}
+
+	umap_str->_load_count = umap_str->_length;
+	MARS_FREE(tmp_node);
+}
+
 unordered_map_str_t* _umap_str_resize(unordered_map_str_t* umap_str, size_t new_capacity) {
 	// Calculate new capacity
 	if (new_capacity == 0) {
@@ -38,16 +165,16 @@ unordered_map_str_t* _umap_str_resize(unordered_map_str_t* umap_str, size_t new_
 	if (new_capacity > UMAP_STR_MAX_CAPACITY || new_capacity < umap_str->_length) { return NULL; }
 	
 	// Create new map
-	unordered_map_str_t* new_umap_str = _umap_str_factory(umap_str->_element_size, new_capacity);
+	unordered_map_str_t* new_umap_str = _umap_str_factory(umap_str->_element_size, new_capacity, umap_str->_interned, umap_str->_hash);
 	if (!new_umap_str) { return NULL; }
 
-	// Rehash data
+	// Rehash data, moving the existing key buffers over
 	for (size_t i = 0; i < umap_str->_capacity; ++i) {
 		uint8_t* ctrl = _umap_str_ctrl(umap_str, i);
 		if (!((*ctrl) & _UMAP_STR_EMPTY)) {
 			_umap_str_key_t _key = *_umap_str_node_key(umap_str, i);
 			void* _data = _umap_str_node_data(umap_str, i);
-			_umap_str_insert(&new_umap_str, _key, _data);
+			_umap_str_emplace(new_umap_str, _key, umap_str->_hash(_key), _data);
 		}
 	}
 
@@ -56,141 +183,210 @@ unordered_map_str_t* _umap_str_resize(unordered_map_str_t* umap_str, size_t new_
 	return new_umap_str;
 }
 
+// wyhash secret & primitives (public domain, github.com/wangyi-fudan/wyhash)
+static const uint64_t _umap_str_wyp[4] = { 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL };
+
+static inline void _umap_str_wymum(uint64_t* a, uint64_t* b) {
+	// Full 64x64 -> 128 bit multiply, low half in a & high half in b
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = (__uint128_t)(*a) * (*b);
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#elif defined(MARS_CMP_MSVC) && defined(MARS_ARCH_X64)
+	*a = _umul128(*a, *b, b);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t _umap_str_wymix(uint64_t a, uint64_t b) {
+	_umap_str_wymum(&a, &b);
+	return a ^ b;
+}
+
+static inline uint64_t _umap_str_wyr8(const uint8_t* p) {
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t _umap_str_wyr4(const uint8_t* p) {
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
 _umap_str_hash_t _umap_str_hash(_umap_str_key_t key) {
-	uint8_t mask_size = sizeof(_umap_str_hash_t) - 4;
-	_umap_str_hash_t hash = _umap_str_fnv_prime;
-	_umap_str_hash_t mask = 0xF << mask_size;
+	// Hash is written to resource files, so it must not change between platforms (all supported targets are little endian)
+	const uint8_t* p = (const uint8_t*)key;
+	size_t len = strlen(key);
+	uint64_t seed = _umap_str_wymix(_umap_str_wyp[0], _umap_str_wyp[1]);
+	uint64_t a = 0, b = 0;
+	if (len <= 16) {
+		if (len >= 4) {
+			a = (_umap_str_wyr4(p) << 32) | _umap_str_wyr4(p + ((len >> 3) << 2));
+			b = (_umap_str_wyr4(p + len - 4) << 32) | _umap_str_wyr4(p + len - 4 - ((len >> 3) << 2));
+		}
+		else if (len > 0) {
+			a = (((uint64_t)p[0]) << 16) | (((uint64_t)p[len >> 1]) << 8) | p[len - 1];
+		}
+	}
+	else {
+		size_t i = len;
+		if (i > 48) {
+			uint64_t see1 = seed, see2 = seed;
+			do {
+				seed = _umap_str_wymix(_umap_str_wyr8(p) ^ _umap_str_wyp[1], _umap_str_wyr8(p + 8) ^ seed);
+				see1 = _umap_str_wymix(_umap_str_wyr8(p + 16) ^ _umap_str_wyp[2], _umap_str_wyr8(p + 24) ^ see1);
+				see2 = _umap_str_wymix(_umap_str_wyr8(p + 32) ^ _umap_str_wyp[3], _umap_str_wyr8(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16) {
+			seed = _umap_str_wymix(_umap_str_wyr8(p) ^ _umap_str_wyp[1], _umap_str_wyr8(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = _umap_str_wyr8(p + i - 16);
+		b = _umap_str_wyr8(p + i - 8);
+	}
+	a ^= _umap_str_wyp[1];
+	b ^= seed;
+	_umap_str_wymum(&a, &b);
+	return _umap_str_wymix(a ^ _umap_str_wyp[0] ^ len, b ^ _umap_str_wyp[1]);
+}
+
+_umap_str_hash_t _umap_str_hash_elf(_umap_str_key_t key) {
+	// Kept bit-for-bit identical to the original 32 bit implementation
+	uint8_t mask_size = sizeof(uint32_t) - 4;
+	uint32_t hash = _umap_str_fnv_prime;
+	uint32_t mask = 0xF << mask_size;
 	while (*key != '\0') {
 		hash = (hash << 4) + *(key++);
-		_umap_str_hash_t g = hash & mask;
+		uint32_t g = hash & mask;
 		if (g != 0) hash ^= g >> mask_size;
 		hash &= ~g;
 	}
-	return hash;
+	return (_umap_str_hash_t)hash;
 }
 
 void* _umap_str_insert(unordered_map_str_t** umap_str, _umap_str_key_t key, void* data) {
 	// Error check
-	if (!umap_str || !(*umap_str)) { return NULL; }
-	unordered_map_str_t* _umap_str = *umap_str;
-	void* elem = _umap_str_find(_umap_str, key);
-	if (elem) { return elem; }
+	if (!umap_str || !(*umap_str) || !key) { return NULL; }
+	return _umap_str_insert_hashed(umap_str, key, (*umap_str)->_hash(key), data);
+}
 
-	// Resize if needed
-	if (_umap_str->_load_count / (float)_umap_str->_capacity >= _UMAP_STR_DEFAULT_LOAD) {
-		unordered_map_str_t* temp = _umap_str_resize(_umap_str, 0);
-		if (!temp) { return NULL; }
-		(*umap_str) = temp;
-		_umap_str = temp;
-	}
+void* _umap_str_insert_hashed(unordered_map_str_t** umap_str, _umap_str_key_t key, _umap_str_hash_t h, void* data) {
+	// Error check
+	if (!umap_str || !(*umap_str) || !key) { return NULL; }
+	bool inserted = false;
+	size_t pos = _umap_str_find_or_emplace_index(umap_str, key, h, &inserted);
+	if (pos == SIZE_MAX) { return NULL; }
 
-	// Hash the key	
-	_umap_str_hash_t h = _umap_str_hash(key);
-	size_t pos = _umap_str_h1(h) & (_umap_str->_capacity - 1);
-
-	// Linear probe to find an empty bucket
-	while (1) {
-		uint8_t* ctrl = _umap_str_ctrl(_umap_str, pos);
-		// Space is empty if high bit is 1
-		if ((*ctrl) & _UMAP_STR_EMPTY) {
-			// Copy the key to a new buffer
-			size_t dest_size = strlen(key) + 1;
-			_umap_str_key_t dest = MARS_MALLOC(dest_size);
-			if (!dest) { 
-				MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate unordered_map_str key buffer!");
-				return NULL; 
-			}
-			strcpy_s(dest, dest_size, key);
+	// Existing elements keep their data
+	void* elem = _umap_str_node_data(*umap_str, pos);
+	if (inserted && data) {
+		memcpy_s(elem, (*umap_str)->_element_size, data, (*umap_str)->_element_size);
+	}
+	return elem;
+}
 
-			// Save the key to the start of the node block
-			memcpy_s(_umap_str_node_key(_umap_str, pos), sizeof(_umap_str_key_t), &dest, sizeof(_umap_str_key_t));
+size_t _umap_str_find_or_emplace_index(unordered_map_str_t** umap_str, _umap_str_key_t key, _umap_str_hash_t h, bool* inserted) {
+	// Error check
+	*inserted = false;
+	if (!umap_str || !(*umap_str) || !key) { return SIZE_MAX; }
+	unordered_map_str_t* _umap_str = *umap_str;
 
-			// Save lower 8 bits of hash to the control block
-			_umap_str_hash_t h2 = _umap_str_h2(h);
-			memcpy_s(ctrl, 1, &h2, 1);
+	// A single probe finds either the key or the slot it belongs in
+	size_t free_pos = SIZE_MAX;
+	size_t pos = _umap_str_probe(_umap_str, key, h, &free_pos);
+	if (pos != SIZE_MAX) { return pos; }
 
-			// Save the data to the end of the node block, aligned by the larger data type
-			dest_size = _umap_str->_element_size;
-			if (data) {
-				memcpy_s(_umap_str_node_data(_umap_str, pos), dest_size, data, dest_size);
-			}
-			else {
-				memset(_umap_str_node_data(_umap_str, pos), 0, dest_size);
-			}
-			break;
+	// Reclaim tombstones in place if they make up most of the load, otherwise resize, either one moves every slot
+	if (_umap_str->_load_count / (float)_umap_str->_capacity >= _UMAP_STR_DEFAULT_LOAD) {
+		if (_umap_str->_length * 32 <= _umap_str->_capacity * 25) {
+			_umap_str_drop_deleted(_umap_str);
 		}
 		else {
-			pos = (pos + 1) & (_umap_str->_capacity - 1);
+			unordered_map_str_t* temp = _umap_str_resize(_umap_str, 0);
+			if (!temp) { return SIZE_MAX; }
+			(*umap_str) = temp;
+			_umap_str = temp;
+		}
+		free_pos = SIZE_MAX;
+	}
+	if (free_pos == SIZE_MAX) {
+		free_pos = _umap_str_find_free(_umap_str, h);
+	}
+
+	// Copy the key to a new buffer, unless it is interned
+	_umap_str_key_t dest = key;
+	if (!_umap_str->_interned) {
+		size_t dest_size = strlen(key) + 1;
+		dest = MARS_MALLOC(dest_size);
+		if (!dest) { 
+			MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to allocate unordered_map_str key buffer!");
+			return SIZE_MAX; 
 		}
+		strcpy_s(dest, dest_size, key);
 	}
-	_umap_str->_length++;
-	_umap_str->_load_count++;
-	return _umap_str_node_data(_umap_str, pos);
+
+	_umap_str_emplace_at(_umap_str, free_pos, dest, h, NULL);
+	*inserted = true;
+	return free_pos;
 }
 
 void _umap_str_delete(unordered_map_str_t* umap_str, _umap_str_key_t key) {
 	// Error check
-	if (!umap_str) { return; }
+	if (!umap_str || !key) { return; }
+	_umap_str_delete_hashed(umap_str, key, umap_str->_hash(key));
+}
 
-	// Hash key again
-	_umap_str_hash_t h = _umap_str_hash(key);
-	size_t pos = _umap_str_h1(h) & (umap_str->_capacity - 1);
+void _umap_str_delete_hashed(unordered_map_str_t* umap_str, _umap_str_key_t key, _umap_str_hash_t h) {
+	// Error check
+	if (!umap_str || !key) { return; }
 
-	// Linear probe to find key
-	while (1) {
-		uint8_t* ctrl = _umap_str_ctrl(umap_str, pos);
-		// Check if this control byte matches lower byte of hash
-		_umap_str_hash_t h2 = _umap_str_h2(h);
-		if (*ctrl == h2) {
-			// Verify key at this pos matches
-			if (strcmp(*_umap_str_node_key(umap_str, pos), key) == 0) {
-				memset(ctrl, _UMAP_STR_DELETED, 1);
-				MARS_FREE(*_umap_str_node_key(umap_str, pos));
-				umap_str->_length--;
-				return;
-			}
-		}
-		else if (*ctrl == _UMAP_STR_EMPTY) {
-			// Empty slot marks the end of the bucket chain
-			return;
+	// Find key & free its slot, leaving a tombstone only if the bucket chain continues past it
+	size_t pos = _umap_str_find_index(umap_str, key, h);
+	if (pos != SIZE_MAX) {
+		if (*_umap_str_ctrl(umap_str, (pos + 1) & (umap_str->_capacity - 1)) == _UMAP_STR_EMPTY) {
+			*_umap_str_ctrl(umap_str, pos) = _UMAP_STR_EMPTY;
+			umap_str->_load_count--;
 		}
 		else {
-			// Look at next control byte
-			pos = (pos + 1) & (umap_str->_capacity - 1);
+			*_umap_str_ctrl(umap_str, pos) = _UMAP_STR_DELETED;
+		}
+		if (!umap_str->_interned) {
+			MARS_FREE(*_umap_str_node_key(umap_str, pos));
 		}
+		umap_str->_length--;
 	}
 }
 
+size_t _umap_str_find_index(unordered_map_str_t* umap_str, _umap_str_key_t key, _umap_str_hash_t h) {
+	size_t free_pos = SIZE_MAX;
+	return _umap_str_probe(umap_str, key, h, &free_pos);
+}
+
 void* _umap_str_find(unordered_map_str_t* umap_str, _umap_str_key_t key) {
 	// Error check
-	if (!umap_str) { return NULL; }
+	if (!umap_str || !key) { return NULL; }
+	return _umap_str_find_hashed(umap_str, key, umap_str->_hash(key));
+}
 
-	// Hash key again
-	_umap_str_hash_t h = _umap_str_hash(key);
-	size_t pos = _umap_str_h1(h) & (umap_str->_capacity - 1);
-	size_t first_pos = pos;
+void* _umap_str_find_hashed(unordered_map_str_t* umap_str, _umap_str_key_t key, _umap_str_hash_t h) {
+	// Error check
+	if (!umap_str || !key) { return NULL; }
 
-	// Linear probe to find key
-	do {
-		uint8_t* ctrl = _umap_str_ctrl(umap_str, pos);
-		// Check if this control byte matches lower byte of hash
-		_umap_str_hash_t h2 = _umap_str_h2(h);
-		if (*ctrl == h2) {
-			// Verify key at this pos matches
-			if (strcmp(*_umap_str_node_key(umap_str, pos), key) == 0) {
-				return _umap_str_node_data(umap_str, pos);
-			}
-		}
-		else if (*ctrl == _UMAP_STR_EMPTY) {
-			// Empty slot marks the end of the bucket chain
-			return NULL;
-		}
-		else {
-			// Look at next control byte
-			pos = (pos + 1) & (umap_str->_capacity - 1);
-		}
-	} while (pos != first_pos);
-	return NULL;
+	size_t pos = _umap_str_find_index(umap_str, key, h);
+	return (pos != SIZE_MAX) ? _umap_str_node_data(umap_str, pos) : NULL;
 }
 
 unordered_map_str_it_t* _umap_str_it(unordered_map_str_t* umap_str) {
@@ -242,12 +438,28 @@ unordered_map_str_it_t* _umap_str_it_next(unordered_map_str_it_t* it) {
 	return NULL;
 }
 
+void _umap_str_clear(unordered_map_str_t* umap_str) {
+	// Error check
+	if (!umap_str) { return; }
+
+	// Deallocate all strings owned by the map
+	for (size_t i = 0; i < umap_str->_capacity && !umap_str->_interned; ++i) {
+		if (!(*_umap_str_ctrl(umap_str, i) & _UMAP_STR_EMPTY)) {
+			MARS_FREE(*_umap_str_node_key(umap_str, i));
+		}
+	}
+
+	memset(_umap_str_ctrl(umap_str, 0), _UMAP_STR_EMPTY, umap_str->_capacity);
+	umap_str->_length = 0;
+	umap_str->_load_count = 0;
+}
+
 void _umap_str_destroy(unordered_map_str_t* umap_str) {
 	// Error check
 	if (!umap_str) { return; }
 
-	// Deallocate all strings
-	for(size_t i = 0; i<umap_str->_capacity; ++i) {
+	// Deallocate all strings owned by the map
+	for(size_t i = 0; i<umap_str->_capacity && !umap_str->_interned; ++i) {
 		uint8_t* ctrl = _umap_str_ctrl(umap_str, i);
 		if (!(*ctrl & _UMAP_STR_EMPTY)) {
 			MARS_FREE(*_umap_str_node_key(umap_str, i));
@@ -13,7 +13,8 @@
 #include <string.h>
 
 typedef char* _umap_str_key_t;
-typedef uint32_t _umap_str_hash_t;
+typedef uint64_t _umap_str_hash_t;
+typedef _umap_str_hash_t (*_umap_str_hash_fn_t)(_umap_str_key_t);
 #define _umap_str_fnv_prime 16777619U;
 
 #ifndef UMAP_STR_DEFAULT_CAPACITY
@@ -27,17 +28,29 @@ typedef uint32_t _umap_str_hash_t;
 #define _UMAP_STR_DELETED 0xFE   // 0b1111 1110
 #define _UMAP_STR_SENTINEL 0xFF  // 0b1111 1111
 
-#define _umap_str_h1(h) h >> 7
-#define _umap_str_h2(h) h & 0x7F
-#define _umap_str_ctrl(u, i) (uint8_t*)(&(u)->_buffer[0] + i)
-#define _umap_str_node(u, i) (&(u)->_buffer[0] + (u)->_capacity + (_umap_str_node_size((u)->_element_size) * i))
+#define _umap_str_h1(h) ((h) >> 7)
+#define _umap_str_h2(h) ((h) & 0x7F)
+#define _umap_str_ctrl(u, i) (uint8_t*)(&(u)->_buffer[0] + (i))
+#define _umap_str_node(u, i) (&(u)->_buffer[0] + (u)->_capacity + (_umap_str_node_size((u)->_element_size) * (i)))
 #define _umap_str_node_key(u, i) (_umap_str_key_t*)(_umap_str_node(u, i))
-#define _umap_str_node_data(u, i) (_umap_str_node(u, i) + ((u)->_element_size > sizeof(_umap_str_key_t) ? (u)->_element_size : sizeof(_umap_str_key_t)))
+#define _umap_str_node_data(u, i) (_umap_str_node(u, i) + _umap_str_node_align((u)->_element_size))
 
 /// @brief Create a new unordered map.
 /// @param t Map type
 /// @return Map pointer
-#define unordered_map_str_create(t) _umap_str_factory(sizeof(t), UMAP_STR_DEFAULT_CAPACITY)
+#define unordered_map_str_create(t) _umap_str_factory(sizeof(t), UMAP_STR_DEFAULT_CAPACITY, false, _umap_str_hash)
+
+/// @brief Create a new unordered map that hashes keys with the given function.
+/// @param t Map type
+/// @param f Hash function (_umap_str_hash, _umap_str_hash_elf, or a custom _umap_str_hash_fn_t)
+/// @return Map pointer
+#define unordered_map_str_create_hash(t, f) _umap_str_factory(sizeof(t), UMAP_STR_DEFAULT_CAPACITY, false, f)
+
+/// @brief Create a new unordered map that stores interned keys by pointer. Keys are neither copied nor freed, and are
+/// @brief compared by address only, so every key must come from the same string table and outlive the map.
+/// @param t Map type
+/// @return Map pointer
+#define unordered_map_str_create_interned(t) _umap_str_factory(sizeof(t), UMAP_STR_DEFAULT_CAPACITY, true, _umap_str_hash)
 
 /// @brief Deallocate an unordered map.
 /// @param u Map pointer
@@ -50,17 +63,38 @@ typedef uint32_t _umap_str_hash_t;
 /// @return Void data pointer to inserted element, or NULL on failure
 #define unordered_map_str_insert(u, k, d) _umap_str_insert(&u, k, (void*)d)
 
+/// @brief Add a new element to the map using a precomputed key hash.
+/// @param u Map pointer
+/// @param k Key
+/// @param h Key hash (from the map's hash function or a StringId)
+/// @param d Data pointer
+/// @return Void data pointer to inserted element, or NULL on failure
+#define unordered_map_str_insert_hashed(u, k, h, d) _umap_str_insert_hashed(&u, k, h, (void*)d)
+
 /// @brief Find the element if it exists in the map.
 /// @param u Map pointer
 /// @param k Key
 /// @return Void data pointer, or NULL if not found
 #define unordered_map_str_find(u, k) _umap_str_find(u, k)
 
+/// @brief Find the element using a precomputed key hash.
+/// @param u Map pointer
+/// @param k Key
+/// @param h Key hash (from the map's hash function or a StringId)
+/// @return Void data pointer, or NULL if not found
+#define unordered_map_str_find_hashed(u, k, h) _umap_str_find_hashed(u, k, h)
+
 /// @brief Remove the element from the map.
 /// @param u Map pointer
 /// @param k Key
 #define unordered_map_str_delete(u, k) _umap_str_delete(u, k)
 
+/// @brief Remove the element from the map using a precomputed key hash.
+/// @param u Map pointer
+/// @param k Key
+/// @param h Key hash (from the map's hash function or a StringId)
+#define unordered_map_str_delete_hashed(u, k, h) _umap_str_delete_hashed(u, k, h)
+
 /// @brief Get the number of elements in the map.
 /// @param u Map pointer
 /// @return Map size
@@ -68,7 +102,7 @@ typedef uint32_t _umap_str_hash_t;
 
 /// @brief Remove all elements from the map.
 /// @param u Map pointer
-#define unordered_map_str_clear(u) memset(_umap_str_ctrl(u, 0), _UMAP_STR_EMPTY, (u)->_capacity)
+#define unordered_map_str_clear(u) _umap_str_clear(u)
 
 /// @brief Create an iterator for the map.
 /// @param u Map pointer
@@ -89,6 +123,8 @@ typedef struct {
 	size_t _capacity;
 	size_t _element_size;
 	size_t _load_count;
+	size_t _interned;
+	_umap_str_hash_fn_t _hash;
 	uint8_t _buffer[];
 } unordered_map_str_t;
 
@@ -100,26 +136,46 @@ typedef struct {
 	size_t _index;
 } unordered_map_str_it_t;
 
+size_t _umap_str_node_align(size_t);
+
 size_t _umap_str_node_size(size_t);
 
 size_t _umap_str_size(size_t, size_t);
 
-unordered_map_str_t* _umap_str_factory(size_t, size_t);
+unordered_map_str_t* _umap_str_factory(size_t, size_t, bool, _umap_str_hash_fn_t);
 
 unordered_map_str_t* _umap_str_resize(unordered_map_str_t*, size_t);
 
+/// @brief Default string hash. Reads the key a word at a time & mixes it into 64 bits (wyhash).
 _umap_str_hash_t _umap_str_hash(_umap_str_key_t);
 
+/// @brief Legacy PJW/ELF string hash, kept for resource files packed before the 64-bit hash.
+_umap_str_hash_t _umap_str_hash_elf(_umap_str_key_t);
+
 void* _umap_str_insert(unordered_map_str_t**, _umap_str_key_t, void*);
 
+void* _umap_str_insert_hashed(unordered_map_str_t**, _umap_str_key_t, _umap_str_hash_t, void*);
+
+/// @brief Find the key's slot, or insert the key into the empty slot found by the same probe. Inserted data is zeroed.
+/// @return Slot index, or SIZE_MAX on failure
+size_t _umap_str_find_or_emplace_index(unordered_map_str_t**, _umap_str_key_t, _umap_str_hash_t, bool*);
+
 void _umap_str_delete(unordered_map_str_t*, _umap_str_key_t);
 
+void _umap_str_delete_hashed(unordered_map_str_t*, _umap_str_key_t, _umap_str_hash_t);
+
+size_t _umap_str_find_index(unordered_map_str_t*, _umap_str_key_t, _umap_str_hash_t);
+
 void* _umap_str_find(unordered_map_str_t*, _umap_str_key_t);
 
+void* _umap_str_find_hashed(unordered_map_str_t*, _umap_str_key_t, _umap_str_hash_t);
+
 unordered_map_str_it_t* _umap_str_it(unordered_map_str_t*);
 
 unordered_map_str_it_t* _umap_str_it_next(unordered_map_str_it_t*);
 
+void _umap_str_clear(unordered_map_str_t*);
+
 void _umap_str_destroy(unordered_map_str_t*);
 
 #endif  // MARS_STD_UMAP_STR_H
\ No newline at end of file
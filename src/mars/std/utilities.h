@@ -10,6 +10,9 @@
 #include <stdbool.h>
 #include <math.h>
 #include <float.h>
+#if defined(MARS_CMP_MSVC)
+#include <intrin.h>
+#endif
 
 //----------------------------------------------------------------------------------
 // Memory allocations
@@ -56,7 +59,7 @@
 #define MARS_BUFF_LEN(x) (sizeof(x)/sizeof(x[0]))
 
 /// @brief Get the next power of 2 >= x.
-#define MARS_NEXT_POW2(x) (1ULL << (unsigned long long)(log2((double)x-1.)+1.))
+#define MARS_NEXT_POW2(x) next_pow2((uint64_t)(x))
 
 
 //----------------------------------------------------------------------------------
@@ -72,6 +75,15 @@
 _MARS_ID_TYPE _mars_id_generate();
 
 
+//----------------------------------------------------------------------------------
+// Timing
+//----------------------------------------------------------------------------------
+
+/// @brief Get the time from a monotonic clock, for measuring intervals.
+/// @return Seconds since an unspecified starting point
+double _mars_time_seconds();
+
+
 //----------------------------------------------------------------------------------
 // CRC32 validation
 //----------------------------------------------------------------------------------
@@ -128,6 +140,58 @@ MARS_API inline size_t umin(size_t x, size_t y) { return (x < y) ? x : y; }
 MARS_API inline size_t umax(size_t x, size_t y) { return (x > y) ? x : y; }
 
 
+//----------------------------------------------------------------------------------
+// Bit manipulation
+//----------------------------------------------------------------------------------
+
+/// @brief Count the trailing zero bits of a non-zero integer.
+MARS_API inline unsigned int ctz64(uint64_t x) {
+#if defined(MARS_CMP_GCC) || defined(MARS_CMP_CLANG)
+	return (unsigned int)__builtin_ctzll(x);
+#elif defined(MARS_CMP_MSVC) && (defined(MARS_ARCH_X64) || defined(MARS_ARCH_ARM64))
+	unsigned long idx = 0;
+	_BitScanForward64(&idx, x);
+	return (unsigned int)idx;
+#else
+	unsigned int n = 0;
+	while (!(x & 1)) { x >>= 1; n++; }
+	return n;
+#endif
+}
+
+/// @brief Count the leading zero bits of a non-zero integer.
+MARS_API inline unsigned int clz64(uint64_t x) {
+#if defined(MARS_CMP_GCC) || defined(MARS_CMP_CLANG)
+	return (unsigned int)__builtin_clzll(x);
+#elif defined(MARS_CMP_MSVC) && (defined(MARS_ARCH_X64) || defined(MARS_ARCH_ARM64))
+	unsigned long idx = 0;
+	_BitScanReverse64(&idx, x);
+	return 63u - (unsigned int)idx;
+#else
+	unsigned int n = 0;
+	while (!(x & (1ULL << 63))) { x <<= 1; n++; }
+	return n;
+#endif
+}
+
+/// @brief Count the set bits of an integer.
+MARS_API inline unsigned int popcount64(uint64_t x) {
+#if defined(MARS_CMP_GCC) || defined(MARS_CMP_CLANG)
+	return (unsigned int)__builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (unsigned int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/// @brief Get the smallest power of 2 >= x, or 1 for 0. x must not exceed 2^63.
+MARS_API inline uint64_t next_pow2(uint64_t x) {
+	return (x <= 1) ? 1 : (1ULL << (64 - clz64(x - 1)));
+}
+
+
 //----------------------------------------------------------------------------------
 // Floating point comparison
 //----------------------------------------------------------------------------------
@@ -27,22 +27,47 @@ vector_t* _vec_resize(vector_t* vec, size_t new_capacity) {
 		new_capacity = umin(c, VECTOR_MAX_CAPACITY);
 	}
 	if (new_capacity > VECTOR_MAX_CAPACITY || new_capacity < vec->_length) { return NULL; }
+	size_t buffer_size = _vec_size(vec->_element_size, new_capacity);
+	if (buffer_size == 0) { return NULL; }
 
-	// Create new vector & copy data to it
-	vector_t* new_vec = _vec_factory(vec->_element_size, new_capacity);
-	if (!new_vec) { return NULL; }
-	size_t dest_size = vec->_length * vec->_element_size;
-	memcpy_s(new_vec->_buffer, dest_size, vec->_buffer, dest_size);
-	new_vec->_length = vec->_length;
-	MARS_FREE(vec);
+	// Reallocate, which can extend the block in place instead of copying it
+	vector_t* new_vec = MARS_REALLOC(vec, buffer_size);
+	if (!new_vec) {
+		MARS_ABORT(MARS_ERROR_CODE_BAD_ALLOC, "Failed to reallocate vector buffer!");
+		return NULL;
+	}
+	new_vec->_capacity = new_capacity;
 	return new_vec;
 }
 
+bool _vec_reserve(vector_t** vec, size_t capacity) {
+	// Error check
+	if (!vec || !(*vec)) { return false; }
+	if (capacity <= (*vec)->_capacity) { return true; }
+
+	vector_t* temp = _vec_resize(*vec, capacity);
+	if (!temp) { return false; }
+	(*vec) = temp;
+	return true;
+}
+
+bool _vec_shrink_to_fit(vector_t** vec) {
+	// Error check
+	if (!vec || !(*vec)) { return false; }
+	size_t capacity = umax((*vec)->_length, 1);
+	if (capacity >= (*vec)->_capacity) { return true; }
+
+	vector_t* temp = _vec_resize(*vec, capacity);
+	if (!temp) { return false; }
+	(*vec) = temp;
+	return true;
+}
+
 void* _vec_insert(vector_t** vec, size_t index, void* data) {
 	// Error check
 	if (!vec || !(*vec)) { return NULL; }
 	vector_t* _vec = *vec;
-	if (index < 0 || index > (_vec->_length + 1)) { return NULL; }
+	if (index > _vec->_length) { return NULL; }
 
 	// Resize container
 	if (_vec->_length >= _vec->_capacity) {
@@ -72,7 +97,7 @@ void* _vec_insert(vector_t** vec, size_t index, void* data) {
 void _vec_remove(vector_t* vec, size_t index, size_t count) {
 	// Error check
 	if (!vec) { return; }
-	if ((index + count) >= vec->_length) { return; }
+	if ((index + count) > vec->_length) { return; }
 	
 	// Shift over elements
 	if (index < vec->_length) {
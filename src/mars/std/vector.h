@@ -12,7 +12,7 @@
 #include <string.h>
 
 #ifndef VECTOR_DEFAULT_CAPACITY
-#define VECTOR_DEFAULT_CAPACITY 1ULL
+#define VECTOR_DEFAULT_CAPACITY 8ULL
 #endif
 #ifndef VECTOR_MAX_CAPACITY
 #define VECTOR_MAX_CAPACITY SIZE_MAX - 1
@@ -100,6 +100,17 @@
 /// @param v Vector pointer
 #define vector_clear(v) _vec_remove(v, 0, (v)->_length)
 
+/// @brief Grow the vector so it holds at least the given number of elements without reallocating.
+/// @param v Vector pointer
+/// @param n Number of elements
+/// @return True if the vector has room for n elements
+#define vector_reserve(v, n) _vec_reserve(&v, n)
+
+/// @brief Shrink the vector's capacity down to its size.
+/// @param v Vector pointer
+/// @return True if the vector was shrunk (or is already as small as it can be)
+#define vector_shrink_to_fit(v) _vec_shrink_to_fit(&v)
+
 /// @brief Get the size of the vector in memory.
 /// @param v Vector pointer
 /// @return Number of bytes
@@ -125,6 +136,10 @@ vector_t* _vec_factory(size_t, size_t);
 
 vector_t* _vec_resize(vector_t*, size_t);
 
+bool _vec_reserve(vector_t**, size_t);
+
+bool _vec_shrink_to_fit(vector_t**);
+
 void* _vec_insert(vector_t**, size_t, void*);
 
 void _vec_remove(vector_t*, size_t, size_t);
@@ -0,0 +1,73 @@
+#ifndef MARS_BENCH_H
+#define MARS_BENCH_H
+/**
+ * bench.h
+ * Benchmark suites run by mars_bench. Each suite prints its own table & returns false if it could not run.
+*/
+#include "mars/common.h"
+#include "mars/resource.h"
+#include <stdio.h>
+
+#ifndef MARS_BENCH_REPEATS
+#define MARS_BENCH_REPEATS 5				// Runs per measurement, the fastest is reported
+#endif
+
+typedef struct {
+	const char* dataDir;				// Directory for generated files
+	size_t repeats;						// Runs per measurement
+} BenchDesc;
+
+typedef bool (*BenchFn)(const BenchDesc* _desc);
+
+/// @brief Hit & miss lookup latency of unordered_map by load factor.
+bool BenchUnorderedMap(const BenchDesc* _desc);
+
+/// @brief Collisions & ns/key of _umap_str_hash against the legacy ELF hash, by asset path length.
+bool BenchHash(const BenchDesc* _desc);
+
+/// @brief Load time & cold (file table) vs warm (index) lookups over a generated 100k entry archive.
+bool BenchLookup(const BenchDesc* _desc);
+
+/// @brief Open time of a generated encrypted archive with decryptOnLoad, by worker count, with hardware & software AES.
+bool BenchDecrypt(const BenchDesc* _desc);
+
+/// @brief Push & pop times of the sorted priority_queue against priority_heap with 2 & 4 children per node.
+bool BenchPriorityQueue(const BenchDesc* _desc);
+
+/// @brief Capacity & step time of unordered_map_str under insert/delete churn at a fixed number of live keys, fails if the map grows.
+bool BenchChurn(const BenchDesc* _desc);
+
+/// @brief Push-heavy vector & queue workloads with copy growth, realloc growth & reserved capacity.
+bool BenchGrow(const BenchDesc* _desc);
+
+/// @brief Join a file name onto the data directory.
+/// @return Path to free with MARS_FREE, or NULL on failure
+char* _BenchPath(const BenchDesc* _desc, const char* _name);
+
+bool _BenchMakeDir(const char* _path);
+
+bool _BenchFileExists(const char* _path);
+
+bool _BenchWriteFile(const char* _path, const void* _data, size_t _len);
+
+uint64_t _BenchRandom(uint64_t* _state);
+
+/// @brief Create a resource manager for the game, so resource files can be loaded without a window.
+/// @return True if the manager was created
+bool _BenchStartResources();
+
+void _BenchStopResources();
+
+ResourceList* _BenchGetResourceList(resourceList_id _id);
+
+/// @brief Generate a tree of random data files in the data directory & pack it, unless the archive already exists.
+/// @param _desc Benchmark description
+/// @param _name Archive file name
+/// @param _password Encryption password (NULL for none)
+/// @param _groups Number of directories
+/// @param _files Files per directory
+/// @param _fileSize Size of each file in bytes
+/// @return True if the archive exists
+bool _BenchPackArchive(const BenchDesc* _desc, const char* _name, const char* _password, size_t _groups, size_t _files, size_t _fileSize);
+
+#endif // MARS_BENCH_H
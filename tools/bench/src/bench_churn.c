@@ -0,0 +1,69 @@
+#include "bench.h"
+
+#define _CHURN_OPS 1000000
+#define _CHURN_NAME_SIZE 32
+
+// Live entries kept while cycling keys through the map, 0 deletes every key right after inserting it
+static const size_t _churnWindows[] = { 0, 1, 100, 10000 };
+
+static bool _MeasureChurn(size_t _window, size_t* _capacity, size_t* _peak, double* _ns) {
+	unordered_map_str_t* map = unordered_map_str_create(uint64_t);
+	if (!map) { return false; }
+	char name[_CHURN_NAME_SIZE] = { '\0' };
+	bool ret = false;
+
+	// Fill the window first, the map must not grow past the capacity that holds it
+	for (size_t i = 0; i < _window; ++i) {
+		snprintf(name, sizeof(name), "churn/key_%08zu", i);
+		uint64_t value = i;
+		if (!unordered_map_str_insert(map, name, &value)) { goto measure_churn_exit; }
+	}
+	*_capacity = map->_capacity;
+	*_peak = map->_capacity;
+
+	// Each step inserts a new key & deletes the oldest live one, like a cache evicting under a fixed budget
+	double start = _mars_time_seconds();
+	for (size_t i = _window; i < _window + _CHURN_OPS; ++i) {
+		snprintf(name, sizeof(name), "churn/key_%08zu", i);
+		uint64_t value = i;
+		if (!unordered_map_str_insert(map, name, &value)) { goto measure_churn_exit; }
+		snprintf(name, sizeof(name), "churn/key_%08zu", i - _window);
+		unordered_map_str_delete(map, name);
+		*_peak = umax(*_peak, map->_capacity);
+	}
+	*_ns = (_mars_time_seconds() - start) * 1e9 / _CHURN_OPS;
+
+	// Every key in the window must still be found, & nothing else
+	if (unordered_map_str_size(map) != _window) { goto measure_churn_exit; }
+	for (size_t i = _CHURN_OPS; i < _window + _CHURN_OPS; ++i) {
+		snprintf(name, sizeof(name), "churn/key_%08zu", i);
+		uint64_t* value = unordered_map_str_find(map, name);
+		if (!value || *value != i) { goto measure_churn_exit; }
+	}
+	ret = true;
+measure_churn_exit:
+	unordered_map_str_destroy(map);
+	return ret;
+}
+
+bool BenchChurn(const BenchDesc* _desc) {
+	(void)_desc;
+	printf("%d insert & delete steps on unordered_map_str at a fixed number of live keys\n", _CHURN_OPS);
+	printf("live keys | capacity | peak capacity | ns/step\n");
+	for (size_t w = 0; w < sizeof(_churnWindows) / sizeof(_churnWindows[0]); ++w) {
+		size_t capacity = 0, peak = 0;
+		double ns = 0.0;
+		if (!_MeasureChurn(_churnWindows[w], &capacity, &peak, &ns)) {
+			fprintf(stderr, "Map lost keys with %zu live keys\n", _churnWindows[w]);
+			return false;
+		}
+		printf("%9zu | %8zu | %13zu | %7.1f\n", _churnWindows[w], capacity, peak, ns);
+
+		// Tombstones have to be reclaimed in place, growing would mean they are counted as live load
+		if (peak != capacity) {
+			fprintf(stderr, "Map grew from %zu to %zu slots with %zu live keys\n", capacity, peak, _churnWindows[w]);
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,72 @@
+#include "bench.h"
+#include "mars/game.h"
+
+#define _DECRYPT_GROUPS 4
+#define _DECRYPT_FILES 16
+#define _DECRYPT_FILE_SIZE (1 << 20)
+#define _DECRYPT_PASSWORD "mars_bench"
+
+static bool _MeasureOpen(const char* _archive, size_t _workers, size_t _runs, double* _seconds, uint32_t* _crc) {
+	// Lists take the manager's pool when they are loaded, no pool means the calling thread decrypts everything
+	thread_pool_destroy(MARS_RESOURCES->_resourceWorkers);
+	MARS_RESOURCES->_resourceWorkers = (_workers > 0) ? thread_pool_create(_workers) : NULL;
+	if (_workers > 0 && !MARS_RESOURCES->_resourceWorkers) { return false; }
+
+	ResourceListDesc desc = { .resourceFile = _archive, .resourcePassword = _DECRYPT_PASSWORD, .decryptOnLoad = true };
+	for (size_t r = 0; r < _runs; ++r) {
+		double start = _mars_time_seconds();
+		resourceList_id id = LoadResourceFile(desc);
+		double t = _mars_time_seconds() - start;
+		if (id == ID_NULL) { return false; }
+		if (r == 0 || t < *_seconds) { *_seconds = t; }
+		if (r == 0) {
+			buffer_t* buffer = _BenchGetResourceList(id)->_resourceFileBuffer;
+			*_crc = CRC32Calculate(buffer->_buffer, buffer->_length, 0);
+		}
+		UnloadResourceFile(id);
+	}
+	return true;
+}
+
+bool BenchDecrypt(const BenchDesc* _desc) {
+	if (!_BenchPackArchive(_desc, "decrypt.mrc", _DECRYPT_PASSWORD, _DECRYPT_GROUPS, _DECRYPT_FILES, _DECRYPT_FILE_SIZE)) { return false; }
+	char* archive = _BenchPath(_desc, "decrypt.mrc");
+	bool ret = false;
+	if (!archive || !_BenchStartResources()) { goto bench_decrypt_exit; }
+
+	unsigned int hw = mars_thread_hardware_concurrency();
+	printf("Opening a %d MiB archive with decryptOnLoad, %u hardware threads\n",
+		(_DECRYPT_GROUPS * _DECRYPT_FILES * _DECRYPT_FILE_SIZE) >> 20, hw);
+	printf("workers (+caller) | impl     | open ms  | speedup\n");
+	for (int hardware = 1; hardware >= 0; --hardware) {
+		// The software path is slow enough that one run per row is plenty
+		cipher_use_hardware(hardware != 0);
+		size_t runs = hardware ? _desc->repeats : 1;
+		cipher_t cipher;
+		uint8_t key[CIPHER_KEY_SIZE] = { 0 };
+		cipher_init(&cipher, key);
+
+		double base = 0.0;
+		uint32_t base_crc = 0;
+		for (size_t workers = 0; workers <= hw; ++workers) {
+			double t = 0.0;
+			uint32_t crc = 0;
+			if (!_MeasureOpen(archive, workers, runs, &t, &crc)) { goto bench_decrypt_exit; }
+			if (workers == 0) {
+				base = t;
+				base_crc = crc;
+			}
+			else if (crc != base_crc) {
+				fprintf(stderr, "Decrypted archive differs with %zu workers\n", workers);
+				goto bench_decrypt_exit;
+			}
+			printf("%17zu | %-8s | %8.1f | %6.2fx\n", workers, cipher_impl_name(&cipher), t * 1e3, base / t);
+		}
+	}
+	ret = true;
+bench_decrypt_exit:
+	cipher_use_hardware(true);
+	_BenchStopResources();
+	MARS_FREE(archive);
+	return ret;
+}
@@ -0,0 +1,113 @@
+#include "bench.h"
+#include "mars/game.h"
+#include "mars/resource_pack.h"
+#include <errno.h>
+#if defined(MARS_OS_WINDOWS)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+static Game _benchGame;
+
+char* _BenchPath(const BenchDesc* _desc, const char* _name) {
+	size_t len = strlen(_desc->dataDir) + strlen(_name) + 2;
+	char* path = MARS_MALLOC(len);
+	if (!path) { return NULL; }
+	snprintf(path, len, "%s/%s", _desc->dataDir, _name);
+	return path;
+}
+
+bool _BenchMakeDir(const char* _path) {
+#if defined(MARS_OS_WINDOWS)
+	return _mkdir(_path) == 0 || errno == EEXIST;
+#else
+	return mkdir(_path, 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+bool _BenchFileExists(const char* _path) {
+	FILE* fp = fopen(_path, "rb");
+	if (!fp) { return false; }
+	fclose(fp);
+	return true;
+}
+
+bool _BenchWriteFile(const char* _path, const void* _data, size_t _len) {
+	FILE* fp = fopen(_path, "wb");
+	if (!fp) { return false; }
+	bool ret = fwrite(_data, 1, _len, fp) == _len;
+	fclose(fp);
+	return ret;
+}
+
+uint64_t _BenchRandom(uint64_t* _state) {
+	// xorshift64*, fixed seeds keep generated files identical between runs
+	uint64_t x = *_state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*_state = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+bool _BenchStartResources() {
+	// Resource files are loaded through the public API, which only needs the game's resource manager
+	_mars_g_game = &_benchGame;
+	MARS_RESOURCES = _CreateResourceManager();
+	if (!MARS_RESOURCES) {
+		_mars_g_game = NULL;
+		return false;
+	}
+	return true;
+}
+
+void _BenchStopResources() {
+	if (!_mars_g_game) { return; }
+	_DestroyResourceManager(MARS_RESOURCES);
+	MARS_RESOURCES = NULL;
+	_mars_g_game = NULL;
+}
+
+ResourceList* _BenchGetResourceList(resourceList_id _id) {
+	ResourceList** list = (ResourceList**)unordered_map_find(MARS_RESOURCES->_resourceLists, _id);
+	return list ? *list : NULL;
+}
+
+bool _BenchPackArchive(const BenchDesc* _desc, const char* _name, const char* _password, size_t _groups, size_t _files, size_t _fileSize) {
+	// Generated archives are kept, delete the data directory to rebuild them
+	char* archive = _BenchPath(_desc, _name);
+	uint8_t* data = MARS_MALLOC(umax(_fileSize, 1));
+	char path[256] = { '\0' };
+	bool ret = false;
+	if (!archive || !data || !_BenchMakeDir(_desc->dataDir)) { goto pack_archive_exit; }
+	if (_BenchFileExists(archive)) {
+		ret = true;
+		goto pack_archive_exit;
+	}
+
+	// Write _groups directories of _files random files each
+	snprintf(path, sizeof(path), "%s/%s.in", _desc->dataDir, _name);
+	if (!_BenchMakeDir(path)) { goto pack_archive_exit; }
+	uint64_t seed = 0x9E3779B97F4A7C15ULL;
+	for (size_t g = 0; g < _groups; ++g) {
+		snprintf(path, sizeof(path), "%s/%s.in/g%03zu", _desc->dataDir, _name, g);
+		if (!_BenchMakeDir(path)) { goto pack_archive_exit; }
+		for (size_t f = 0; f < _files; ++f) {
+			for (size_t i = 0; i < _fileSize; i += 8) {
+				uint64_t r = _BenchRandom(&seed);
+				memcpy(&data[i], &r, umin(8, _fileSize - i));
+			}
+			snprintf(path, sizeof(path), "%s/%s.in/g%03zu/r%04zu.dat", _desc->dataDir, _name, g, f);
+			if (!_BenchWriteFile(path, data, _fileSize)) { goto pack_archive_exit; }
+		}
+	}
+
+	snprintf(path, sizeof(path), "%s/%s.in", _desc->dataDir, _name);
+	printf("Packing (%s) into (%s)\n", path, archive);
+	ret = PackResourceDirectory((ResourcePackDesc){ .inputDir = path, .outputFile = archive, .password = _password });
+pack_archive_exit:
+	MARS_FREE(archive);
+	MARS_FREE(data);
+	return ret;
+}
@@ -0,0 +1,104 @@
+#include "bench.h"
+
+typedef struct {
+	size_t count;						// Elements pushed per container
+	size_t containers;					// Containers filled per run
+} _GrowWorkload;
+
+// Growth as it was before realloc: a new buffer of the next power of two, a copy & a free, starting from one element
+static vector_t* _CopyGrowVector(vector_t* _vec) {
+	vector_t* vec = _vec_factory(_vec->_element_size, MARS_NEXT_POW2(_vec->_capacity + 1));
+	if (!vec) { return NULL; }
+	memcpy(vec->_buffer, _vec->_buffer, _vec->_length * _vec->_element_size);
+	vec->_length = _vec->_length;
+	vector_destroy(_vec);
+	return vec;
+}
+
+static queue_t* _CopyGrowQueue(queue_t* _qu) {
+	queue_t* qu = _queue_factory(_qu->_element_size, MARS_NEXT_POW2(_qu->_capacity + 1));
+	if (!qu) { return NULL; }
+	size_t front = umin(_qu->_length, _qu->_capacity - _qu->_head);
+	memcpy(_queue_pos(qu, 0), _queue_pos(_qu, _qu->_head), front * _qu->_element_size);
+	memcpy(_queue_pos(qu, front), _queue_pos(_qu, 0), (_qu->_length - front) * _qu->_element_size);
+	qu->_tail = _qu->_length;
+	qu->_length = _qu->_length;
+	queue_destroy(_qu);
+	return qu;
+}
+
+// Mode 0 grows by copying, 1 grows with realloc & 2 reserves the final size up front
+static bool _PushVector(_GrowWorkload _load, int _mode) {
+	for (size_t c = 0; c < _load.containers; ++c) {
+		vector_t* vec = (_mode == 0) ? vector_create_size(int, 1) : vector_create(int);
+		if (!vec || (_mode == 2 && !vector_reserve(vec, _load.count))) { goto push_vector_fail; }
+		for (size_t i = 0; i < _load.count; ++i) {
+			if (_mode == 0 && vec->_length >= vec->_capacity) {
+				vector_t* temp = _CopyGrowVector(vec);
+				if (!temp) { goto push_vector_fail; }
+				vec = temp;
+			}
+			int v = (int)i;
+			if (!vector_push_back(vec, &v)) { goto push_vector_fail; }
+		}
+		vector_destroy(vec);
+		continue;
+push_vector_fail:
+		vector_destroy(vec);
+		return false;
+	}
+	return true;
+}
+
+// Pops every other push, so the queue wraps around while it grows
+static bool _PushPopQueue(_GrowWorkload _load, int _mode) {
+	for (size_t c = 0; c < _load.containers; ++c) {
+		queue_t* qu = (_mode == 0) ? _queue_factory(sizeof(int), 1) : queue_create(int);
+		if (!qu || (_mode == 2 && !queue_reserve(qu, (_load.count + 1) / 2))) { goto push_pop_queue_fail; }
+		for (size_t i = 0; i < _load.count; ++i) {
+			if (_mode == 0 && qu->_length >= qu->_capacity) {
+				queue_t* temp = _CopyGrowQueue(qu);
+				if (!temp) { goto push_pop_queue_fail; }
+				qu = temp;
+			}
+			int v = (int)i;
+			if (!queue_push(qu, &v)) { goto push_pop_queue_fail; }
+			if (i & 1) { queue_pop(qu); }
+		}
+		queue_destroy(qu);
+		continue;
+push_pop_queue_fail:
+		queue_destroy(qu);
+		return false;
+	}
+	return true;
+}
+
+static bool _MeasureGrow(bool (*_fn)(_GrowWorkload, int), _GrowWorkload _load, int _mode, size_t _repeats, double* _ms) {
+	for (size_t r = 0; r < _repeats; ++r) {
+		double start = _mars_time_seconds();
+		if (!_fn(_load, _mode)) { return false; }
+		double t = (_mars_time_seconds() - start) * 1e3;
+		if (r == 0 || t < *_ms) { *_ms = t; }
+	}
+	return true;
+}
+
+bool BenchGrow(const BenchDesc* _desc) {
+	static const _GrowWorkload loads[] = { { 16, 250000 }, { 4000, 1000 }, { 1000000, 4 } };
+
+	printf("Fill many containers with int pushes, copy growth (from capacity 1) / realloc growth / reserved, ms\n");
+	printf("  count x containers | vector push              | queue push+pop\n");
+	for (size_t l = 0; l < sizeof(loads) / sizeof(loads[0]); ++l) {
+		double vec[3] = { 0.0 }, qu[3] = { 0.0 };
+		for (int mode = 0; mode < 3; ++mode) {
+			if (!_MeasureGrow(_PushVector, loads[l], mode, _desc->repeats, &vec[mode]) ||
+				!_MeasureGrow(_PushPopQueue, loads[l], mode, _desc->repeats, &qu[mode])) {
+				return false;
+			}
+		}
+		printf("%8zu x %-9zu | %6.1f / %6.1f / %6.1f   | %6.1f / %6.1f / %6.1f\n", loads[l].count, loads[l].containers,
+			vec[0], vec[1], vec[2], qu[0], qu[1], qu[2]);
+	}
+	return true;
+}
@@ -0,0 +1,101 @@
+#include "bench.h"
+
+#define _HASH_KEY_COUNT 100000
+#define _HASH_KEY_SIZE 160
+#define _HASH_PASSES 20
+
+// Asset paths of increasing length, each numbered so every key is unique
+static const char* _hashFormats[] = {
+	"tex%d.png",
+	"textures/env/rock_%05d.png",
+	"assets/characters/hero/animations/run_cycle_%06d.anim",
+	"assets/levels/world_03/sector_b/props/industrial/pipes/pipe_segment_long_variant_%07d_lod2.mesh",
+};
+
+typedef struct {
+	size_t full;						// Keys whose 64-bit hash equals another key's
+	size_t bucket;						// Keys whose home slot is already taken at the default load factor
+	size_t h2;							// Distinct 7-bit control byte values
+	double ns;							// Nanoseconds per key
+} _HashResult;
+
+static int _CompareHash(const void* _a, const void* _b) {
+	_umap_str_hash_t a = *(const _umap_str_hash_t*)_a;
+	_umap_str_hash_t b = *(const _umap_str_hash_t*)_b;
+	return (a < b) ? -1 : (a > b);
+}
+
+static bool _MeasureHash(_umap_str_hash_fn_t _fn, char* _keys, size_t _repeats, _HashResult* _result) {
+	// Smallest table the keys fit in, as unordered_map_str would size it
+	size_t capacity = 1;
+	while ((double)capacity * _UMAP_STR_DEFAULT_LOAD < (double)_HASH_KEY_COUNT) { capacity <<= 1; }
+	_umap_str_hash_t* hashes = MARS_MALLOC(_HASH_KEY_COUNT * sizeof(*hashes));
+	uint8_t* slots = MARS_CALLOC(capacity, 1);
+	if (!hashes || !slots) {
+		MARS_FREE(hashes);
+		MARS_FREE(slots);
+		return false;
+	}
+
+	// Count collisions in the home slot & the control byte, then over the full hash
+	bool h2_seen[128] = { false };
+	memset(_result, 0, sizeof(*_result));
+	for (size_t i = 0; i < _HASH_KEY_COUNT; ++i) {
+		hashes[i] = _fn(&_keys[i * _HASH_KEY_SIZE]);
+		size_t slot = (size_t)_umap_str_h1(hashes[i]) & (capacity - 1);
+		if (slots[slot]) { _result->bucket++; }
+		slots[slot] = 1;
+		if (!h2_seen[_umap_str_h2(hashes[i])]) {
+			h2_seen[_umap_str_h2(hashes[i])] = true;
+			_result->h2++;
+		}
+	}
+	qsort(hashes, _HASH_KEY_COUNT, sizeof(*hashes), _CompareHash);
+	for (size_t i = 1; i < _HASH_KEY_COUNT; ++i) {
+		if (hashes[i] == hashes[i - 1]) { _result->full++; }
+	}
+
+	// Time hashing every key
+	volatile _umap_str_hash_t sink = 0;
+	double best = 0.0;
+	for (size_t r = 0; r < _repeats; ++r) {
+		double start = _mars_time_seconds();
+		for (size_t p = 0; p < _HASH_PASSES; ++p) {
+			for (size_t i = 0; i < _HASH_KEY_COUNT; ++i) { sink += _fn(&_keys[i * _HASH_KEY_SIZE]); }
+		}
+		double t = _mars_time_seconds() - start;
+		if (r == 0 || t < best) { best = t; }
+	}
+	_result->ns = best * 1e9 / (double)(_HASH_PASSES * _HASH_KEY_COUNT);
+	(void)sink;
+
+	MARS_FREE(hashes);
+	MARS_FREE(slots);
+	return true;
+}
+
+bool BenchHash(const BenchDesc* _desc) {
+	char* keys = MARS_MALLOC((size_t)_HASH_KEY_COUNT * _HASH_KEY_SIZE);
+	if (!keys) { return false; }
+
+	printf("%d generated asset paths per row, %zu-slot table for bucket collisions\n", _HASH_KEY_COUNT,
+		(size_t)MARS_NEXT_POW2((size_t)((double)_HASH_KEY_COUNT / _UMAP_STR_DEFAULT_LOAD) + 1));
+	printf("avg len | elf full / bucket / h2 used | elf ns/key | wy full / bucket / h2 used | wy ns/key\n");
+	for (size_t f = 0; f < sizeof(_hashFormats) / sizeof(_hashFormats[0]); ++f) {
+		size_t total = 0;
+		for (size_t i = 0; i < _HASH_KEY_COUNT; ++i) {
+			total += (size_t)snprintf(&keys[i * _HASH_KEY_SIZE], _HASH_KEY_SIZE, _hashFormats[f], (int)i);
+		}
+
+		_HashResult elf, wy;
+		if (!_MeasureHash(_umap_str_hash_elf, keys, _desc->repeats, &elf) || !_MeasureHash(_umap_str_hash, keys, _desc->repeats, &wy)) {
+			MARS_FREE(keys);
+			return false;
+		}
+		printf("%7zu | %6zu / %6zu / %3zu       | %10.1f | %5zu / %6zu / %3zu        | %9.1f\n", total / _HASH_KEY_COUNT,
+			elf.full, elf.bucket, elf.h2, elf.ns, wy.full, wy.bucket, wy.h2, wy.ns);
+	}
+
+	MARS_FREE(keys);
+	return true;
+}
@@ -0,0 +1,76 @@
+#include "bench.h"
+
+#define _LOOKUP_GROUPS 100
+#define _LOOKUP_FILES 1000
+#define _LOOKUP_FILE_SIZE 64
+#define _LOOKUP_NAME_SIZE 16
+#define _LOOKUP_COUNT (_LOOKUP_GROUPS * _LOOKUP_FILES)
+
+bool BenchLookup(const BenchDesc* _desc) {
+	if (!_BenchPackArchive(_desc, "lookup.mrc", NULL, _LOOKUP_GROUPS, _LOOKUP_FILES, _LOOKUP_FILE_SIZE)) { return false; }
+	char* archive = _BenchPath(_desc, "lookup.mrc");
+	char* names = MARS_MALLOC((size_t)_LOOKUP_COUNT * _LOOKUP_NAME_SIZE);
+	resourceList_id id = ID_NULL;
+	bool ret = false;
+	if (!archive || !names || !_BenchStartResources()) { goto bench_lookup_exit; }
+	for (size_t i = 0; i < _LOOKUP_COUNT; ++i) {
+		snprintf(&names[i * _LOOKUP_NAME_SIZE], _LOOKUP_NAME_SIZE, "g%03zu/r%04zu", i / _LOOKUP_FILES, i % _LOOKUP_FILES);
+	}
+
+	// Loading maps the archive & builds the path index
+	ResourceListDesc desc = { .resourceFile = archive };
+	double load = 0.0;
+	for (size_t r = 0; r < _desc->repeats; ++r) {
+		if (id != ID_NULL) { UnloadResourceFile(id); }
+		double start = _mars_time_seconds();
+		id = LoadResourceFile(desc);
+		double t = _mars_time_seconds() - start;
+		if (id == ID_NULL) { goto bench_lookup_exit; }
+		if (r == 0 || t < load) { load = t; }
+	}
+	ResourceList* list = _BenchGetResourceList(id);
+
+	// Cold lookups probe the file tables in the mapping, warm ones hash the path & probe the index
+	volatile uint64_t sink = 0;
+	double cold = 0.0, warm = 0.0;
+	for (size_t r = 0; r < _desc->repeats; ++r) {
+		double start = _mars_time_seconds();
+		for (size_t i = 0; i < _LOOKUP_COUNT; ++i) {
+			sink += _SeekResourceInBuffer(list->_resourceFileBuffer, list->_resourceHash, &names[i * _LOOKUP_NAME_SIZE]);
+		}
+		double t = _mars_time_seconds() - start;
+		if (r == 0 || t < cold) { cold = t; }
+
+		start = _mars_time_seconds();
+		for (size_t i = 0; i < _LOOKUP_COUNT; ++i) {
+			char* name = &names[i * _LOOKUP_NAME_SIZE];
+			sink += _FindResourceOffset(list, name, _umap_str_hash(name));
+		}
+		t = _mars_time_seconds() - start;
+		if (r == 0 || t < warm) { warm = t; }
+	}
+	(void)sink;
+
+	// Both paths must agree on every resource
+	for (size_t i = 0; i < _LOOKUP_COUNT; ++i) {
+		char* name = &names[i * _LOOKUP_NAME_SIZE];
+		uint64_t offset = _FindResourceOffset(list, name, _umap_str_hash(name));
+		if (offset == 0 || offset != _SeekResourceInBuffer(list->_resourceFileBuffer, list->_resourceHash, name)) {
+			fprintf(stderr, "Lookups disagree on (%s)\n", name);
+			goto bench_lookup_exit;
+		}
+	}
+
+	printf("%d paths (%d groups x %d files), %.1f MB archive\n", _LOOKUP_COUNT, _LOOKUP_GROUPS, _LOOKUP_FILES,
+		(double)list->_resourceFileBuffer->_length / 1e6);
+	printf("load + index build                 %8.1f ms\n", load * 1e3);
+	printf("cold: in-place file table probe    %8.1f ns/lookup\n", cold * 1e9 / _LOOKUP_COUNT);
+	printf("warm: index lookup (hash + probe)  %8.1f ns/lookup\n", warm * 1e9 / _LOOKUP_COUNT);
+	ret = true;
+bench_lookup_exit:
+	if (id != ID_NULL) { UnloadResourceFile(id); }
+	_BenchStopResources();
+	MARS_FREE(archive);
+	MARS_FREE(names);
+	return ret;
+}
@@ -0,0 +1,90 @@
+#include "bench.h"
+
+typedef struct {
+	uint64_t _a;
+	uint64_t _b;
+} _PqueueElement;
+
+typedef struct {
+	double push;
+	double pop;
+} _PqueueResult;
+
+static bool _MeasureQueue(const priority_queue_value_t* _values, size_t _count, size_t _repeats, _PqueueResult* _result) {
+	for (size_t r = 0; r < _repeats; ++r) {
+		priority_queue_t* queue = priority_queue_create(_PqueueElement);
+		if (!queue) { return false; }
+		double start = _mars_time_seconds();
+		for (size_t i = 0; i < _count; ++i) {
+			_PqueueElement e = { i, i };
+			if (!priority_queue_push(queue, _values[i], &e)) {
+				priority_queue_destroy(queue);
+				return false;
+			}
+		}
+		double push = _mars_time_seconds() - start;
+		start = _mars_time_seconds();
+		while (priority_queue_size(queue) > 0) { priority_queue_pop(queue); }
+		double pop = _mars_time_seconds() - start;
+		priority_queue_destroy(queue);
+		if (r == 0 || push < _result->push) { _result->push = push; }
+		if (r == 0 || pop < _result->pop) { _result->pop = pop; }
+	}
+	return true;
+}
+
+static bool _MeasureHeap(const priority_queue_value_t* _values, size_t _count, size_t _arity, size_t _repeats, _PqueueResult* _result) {
+	for (size_t r = 0; r < _repeats; ++r) {
+		priority_heap_t* heap = priority_heap_create_dary(_PqueueElement, _arity);
+		if (!heap) { return false; }
+		double start = _mars_time_seconds();
+		for (size_t i = 0; i < _count; ++i) {
+			_PqueueElement e = { i, i };
+			if (!priority_heap_push(heap, _values[i], &e, NULL)) {
+				priority_heap_destroy(heap);
+				return false;
+			}
+		}
+		double push = _mars_time_seconds() - start;
+
+		// Popping must give the values in descending order
+		start = _mars_time_seconds();
+		priority_heap_value_t last = INT32_MAX;
+		bool ordered = true;
+		while (priority_heap_size(heap) > 0) {
+			priority_heap_value_t top = *priority_heap_top_value(heap);
+			ordered &= (top <= last);
+			last = top;
+			priority_heap_pop(heap);
+		}
+		double pop = _mars_time_seconds() - start;
+		priority_heap_destroy(heap);
+		if (!ordered) { return false; }
+		if (r == 0 || push < _result->push) { _result->push = push; }
+		if (r == 0 || pop < _result->pop) { _result->pop = pop; }
+	}
+	return true;
+}
+
+bool BenchPriorityQueue(const BenchDesc* _desc) {
+	static const size_t counts[] = { 1000, 10000, 50000 };
+
+	printf("Push N random int32 values with %zu-byte elements, then pop them all, push / pop ms\n", sizeof(_PqueueElement));
+	printf("      N | priority_queue      | priority_heap d=2  | priority_heap d=4\n");
+	for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+		priority_queue_value_t* values = MARS_MALLOC(counts[c] * sizeof(*values));
+		if (!values) { return false; }
+		uint64_t seed = 0x2545F4914F6CDD1DULL;
+		for (size_t i = 0; i < counts[c]; ++i) { values[i] = (priority_queue_value_t)(uint32_t)_BenchRandom(&seed); }
+
+		_PqueueResult queue = { 0 }, heap2 = { 0 }, heap4 = { 0 };
+		bool ok = _MeasureQueue(values, counts[c], _desc->repeats, &queue) &&
+			_MeasureHeap(values, counts[c], 2, _desc->repeats, &heap2) &&
+			_MeasureHeap(values, counts[c], 4, _desc->repeats, &heap4);
+		MARS_FREE(values);
+		if (!ok) { return false; }
+		printf("%7zu | %8.2f / %8.2f | %7.2f / %7.2f  | %7.2f / %7.2f\n", counts[c], queue.push * 1e3, queue.pop * 1e3,
+			heap2.push * 1e3, heap2.pop * 1e3, heap4.push * 1e3, heap4.pop * 1e3);
+	}
+	return true;
+}
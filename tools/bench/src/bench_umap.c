@@ -0,0 +1,62 @@
+#include "bench.h"
+
+#define _UMAP_BENCH_CAPACITY (1ULL << 16)
+#define _UMAP_BENCH_LOOKUPS 4000000
+
+#if defined(MARS_SIMD_SSE2)
+#define _UMAP_BENCH_GROUP "SSE2"
+#elif defined(MARS_SIMD_NEON)
+#define _UMAP_BENCH_GROUP "NEON"
+#else
+#define _UMAP_BENCH_GROUP "SWAR"
+#endif
+
+// Multiplying by an odd constant is a bijection, so even indices give the stored keys & odd ones keys that are never stored
+#define _UmapBenchKey(i) ((_umap_key_t)((i) * 2654435761U))
+
+static double _MeasureLookups(unordered_map_t* _map, size_t _count, size_t _first, size_t _repeats) {
+	size_t passes = umax(_UMAP_BENCH_LOOKUPS / _count, 1);
+	volatile uintptr_t sink = 0;
+	double best = 0.0;
+	for (size_t r = 0; r < _repeats; ++r) {
+		double start = _mars_time_seconds();
+		for (size_t p = 0; p < passes; ++p) {
+			for (size_t i = 0; i < _count; ++i) { sink += (uintptr_t)unordered_map_find(_map, _UmapBenchKey(2 * i + _first)); }
+		}
+		double t = _mars_time_seconds() - start;
+		if (r == 0 || t < best) { best = t; }
+	}
+	(void)sink;
+	return best * 1e9 / (double)(passes * _count);
+}
+
+bool BenchUnorderedMap(const BenchDesc* _desc) {
+	static const double loads[] = { 0.25, 0.50, 0.75, 0.87 };
+
+	printf("%llu-slot unordered_map of uint64_t, %s group probing\n", _UMAP_BENCH_CAPACITY, _UMAP_BENCH_GROUP);
+	printf("load | hit ns | miss ns\n");
+	for (size_t l = 0; l < sizeof(loads) / sizeof(loads[0]); ++l) {
+		// Size the table up front so every row probes the same capacity
+		unordered_map_t* map = unordered_map_create(uint64_t);
+		unordered_map_t* temp = map ? _umap_resize(map, _UMAP_BENCH_CAPACITY) : NULL;
+		if (!temp) {
+			unordered_map_destroy(map);
+			return false;
+		}
+		map = temp;
+		size_t count = (size_t)((double)_UMAP_BENCH_CAPACITY * loads[l]);
+		for (size_t i = 0; i < count; ++i) {
+			uint64_t value = i;
+			if (!unordered_map_insert(map, _UmapBenchKey(2 * i), &value)) {
+				unordered_map_destroy(map);
+				return false;
+			}
+		}
+
+		double hit = _MeasureLookups(map, count, 0, _desc->repeats);
+		double miss = _MeasureLookups(map, count, 1, _desc->repeats);
+		printf("%4.2f | %6.1f | %7.1f\n", (double)count / (double)map->_capacity, hit, miss);
+		unordered_map_destroy(map);
+	}
+	return true;
+}
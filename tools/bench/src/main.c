@@ -0,0 +1,65 @@
+#include "bench.h"
+
+typedef struct {
+	const char* name;
+	BenchFn fn;
+} BenchSuite;
+
+static const BenchSuite _suites[] = {
+	{ "umap", BenchUnorderedMap },
+	{ "hash", BenchHash },
+	{ "lookup", BenchLookup },
+	{ "decrypt", BenchDecrypt },
+	{ "pqueue", BenchPriorityQueue },
+	{ "grow", BenchGrow },
+	{ "churn", BenchChurn },
+};
+#define _SUITE_COUNT (sizeof(_suites) / sizeof(_suites[0]))
+
+static void PrintUsage() {
+	printf("Usage: mars_bench [options] [suite ...]\n");
+	printf("  -d <dir>       Directory for generated files (default: mars_bench_data)\n");
+	printf("  -r <repeats>   Runs per measurement, the fastest is reported (default: %d)\n", MARS_BENCH_REPEATS);
+	printf("Suites (default: all):");
+	for (size_t i = 0; i < _SUITE_COUNT; ++i) { printf(" %s", _suites[i].name); }
+	printf("\n");
+}
+
+int main(int argc, char** argv) {
+	BenchDesc desc = { "mars_bench_data", MARS_BENCH_REPEATS };
+	bool selected[_SUITE_COUNT] = { false };
+	bool any = false;
+	for (int i = 1; i < argc; ++i) {
+		if (argv[i][0] == '-' && argv[i][1] != '\0' && argv[i][2] == '\0') {
+			bool has_value = (i + 1 < argc);
+			switch (argv[i][1]) {
+				case 'd': if (!has_value) { goto main_usage; } desc.dataDir = argv[++i]; break;
+				case 'r': if (!has_value) { goto main_usage; } desc.repeats = umax((size_t)strtoul(argv[++i], NULL, 10), 1); break;
+				default: goto main_usage;
+			}
+			continue;
+		}
+		size_t s = 0;
+		while (s < _SUITE_COUNT && strcmp(argv[i], _suites[s].name) != 0) { s++; }
+		if (s == _SUITE_COUNT) { goto main_usage; }
+		selected[s] = true;
+		any = true;
+	}
+
+	// Status messages would interleave with the tables
+	MARS_DEBUG_SET_SEVERITY(MARS_DEBUG_LEVEL_WARNING | MARS_DEBUG_LEVEL_ERROR);
+	int ret = 0;
+	for (size_t i = 0; i < _SUITE_COUNT; ++i) {
+		if (any && !selected[i]) { continue; }
+		printf("== %s\n", _suites[i].name);
+		if (!_suites[i].fn(&desc)) {
+			fprintf(stderr, "Suite (%s) failed (return code %u)\n", _suites[i].name, MARS_RETURN_CODE);
+			ret = 1;
+		}
+		printf("\n");
+	}
+	return ret;
+main_usage:
+	PrintUsage();
+	return 1;
+}
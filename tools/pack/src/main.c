@@ -0,0 +1,44 @@
+#include "mars/common.h"
+#include "mars/resource_pack.h"
+#include <stdio.h>
+
+static void PrintUsage() {
+	printf("Usage: mars_pack [options] <input directory> <output file>\n");
+	printf("  -p <password>  Encrypt the resource file\n");
+	printf("  -j <threads>   Worker threads (default: one less than the hardware thread count)\n");
+	printf("  -c <KiB>       Chunk size for large files (default: %d)\n", MARS_PACK_CHUNK_SIZE >> 10);
+	printf("  -r             Store images as image files instead of converting them to textures\n");
+	printf("  -m             Generate mip levels for converted images\n");
+}
+
+int main(int argc, char** argv) {
+	ResourcePackDesc desc = { 0 };
+	for (int i = 1; i < argc; ++i) {
+		if (argv[i][0] == '-' && argv[i][1] != '\0' && argv[i][2] == '\0') {
+			bool has_value = (i + 1 < argc);
+			switch (argv[i][1]) {
+				case 'p': if (!has_value) { goto main_usage; } desc.password = argv[++i]; break;
+				case 'j': if (!has_value) { goto main_usage; } desc.threadCount = (size_t)strtoul(argv[++i], NULL, 10); break;
+				case 'c': if (!has_value) { goto main_usage; } desc.chunkSize = (size_t)strtoul(argv[++i], NULL, 10) << 10; break;
+				case 'r': desc.rawImages = true; break;
+				case 'm': desc.mipmaps = true; break;
+				default: goto main_usage;
+			}
+		}
+		else if (!desc.inputDir) { desc.inputDir = argv[i]; }
+		else if (!desc.outputFile) { desc.outputFile = argv[i]; }
+		else { goto main_usage; }
+	}
+	if (!desc.inputDir || !desc.outputFile) { goto main_usage; }
+
+	double start = _mars_time_seconds();
+	if (!PackResourceDirectory(desc)) {
+		fprintf(stderr, "Failed to pack (%s) into (%s) (return code %u)\n", desc.inputDir, desc.outputFile, MARS_RETURN_CODE);
+		return 1;
+	}
+	printf("Packed (%s) into (%s) in %.2f s\n", desc.inputDir, desc.outputFile, _mars_time_seconds() - start);
+	return 0;
+main_usage:
+	PrintUsage();
+	return 1;
+}